@@ -301,6 +301,19 @@ extern void bfd_hash_table_free
 extern struct bfd_hash_entry *bfd_hash_lookup
   (struct bfd_hash_table *, const char *, bool create, bool copy);
 
+/* Return the hash code of a string.  */
+extern unsigned long bfd_hash_value (const char *);
+
+/* Look up a string in a hash table, like bfd_hash_lookup, given its
+   hash code as returned by bfd_hash_value.  */
+extern struct bfd_hash_entry *bfd_hash_lookup_hashed
+  (struct bfd_hash_table *, const char *, unsigned long,
+   bool create, bool copy);
+
+/* Start fetching the part of a hash table that a lookup of a string
+   with the given hash code will read first.  */
+extern void bfd_hash_prefetch (struct bfd_hash_table *, unsigned long);
+
 /* Insert an entry in a hash table.  */
 extern struct bfd_hash_entry *bfd_hash_insert
   (struct bfd_hash_table *, const char *, unsigned long);
@@ -386,6 +399,32 @@ extern bool bfd_cache_close
 
 extern bool bfd_cache_close_all (void);
 
+/* Counts kept by the file cache, filled in by bfd_cache_get_stats.  */
+
+struct bfd_cache_stats
+{
+  /* Accesses that found the file open or mapped.  */
+  bfd_size_type hits;
+  /* Accesses that found the file closed by the cache.  */
+  bfd_size_type misses;
+  /* Misses that opened the file again.  */
+  bfd_size_type reopens;
+  /* Files closed or mapped to make room for another.  */
+  bfd_size_type evictions;
+  /* Files now mapped rather than open, and their total size.  */
+  bfd_size_type mapped;
+  bfd_size_type mapped_size;
+  /* Files now open, and the most that may be.  */
+  int open;
+  int max_open;
+};
+
+extern int bfd_cache_set_max_open (int);
+
+extern bool bfd_cache_set_mmap (bool);
+
+extern void bfd_cache_get_stats (struct bfd_cache_stats *);
+
 extern bool bfd_record_phdr
   (bfd *, unsigned long, bool, flagword, bool, bfd_vma,
    bool, bool, unsigned int, struct bfd_section **);
@@ -616,6 +616,9 @@ CODE_FRAGMENT
 
 #include "sysdep.h"
 #include <stdarg.h>
+#ifdef HAVE_PTHREAD
+#include <pthread.h>
+#endif
 #include "bfd.h"
 #include "bfdver.h"
 #include "libiberty.h"
@@ -2620,6 +2623,208 @@ bfd_demangle (bfd *abfd, const char *name, int options)
   return res;
 }
 
+/*
+FUNCTION
+	bfd_set_thread_count
+
+SYNOPSIS
+	void bfd_set_thread_count (unsigned int count);
+
+DESCRIPTION
+	Allow BFD to use up to @var{count} threads, including the
+	calling thread, for work that can safely be done in parallel,
+	such as compressing output sections.  A @var{count} of zero
+	means use one thread per online processor.  The default is one,
+	which disables threading.  The results do not depend on the
+	number of threads used.
+*/
+
+static unsigned int bfd_thread_count = 1;
+
+void
+bfd_set_thread_count (unsigned int count)
+{
+  if (count == 0)
+    {
+#if defined (HAVE_SYSCONF) && defined (_SC_NPROCESSORS_ONLN)
+      long ncpus = sysconf (_SC_NPROCESSORS_ONLN);
+
+      count = ncpus > 0 ? ncpus : 1;
+#else
+      count = 1;
+#endif
+    }
+  bfd_thread_count = count;
+}
+
+/*
+FUNCTION
+	bfd_get_thread_count
+
+SYNOPSIS
+	unsigned int bfd_get_thread_count (void);
+
+DESCRIPTION
+	Return the number of threads that BFD may use, as set by
+	@code{bfd_set_thread_count}.  This is always one if BFD was
+	built without thread support.
+*/
+
+unsigned int
+bfd_get_thread_count (void)
+{
+#ifdef HAVE_PTHREAD
+  return bfd_thread_count;
+#else
+  return 1;
+#endif
+}
+
+#ifdef HAVE_PTHREAD
+/* Shared state for the threads started by bfd_run_parallel.  */
+
+struct parallel_jobs
+{
+  void (*fn) (void *, unsigned int);
+  void *data;
+  unsigned int njobs;
+  unsigned int next;
+  pthread_mutex_t lock;
+};
+
+/* Claim and run jobs from ARG until there are none left.  */
+
+static void *
+run_parallel_jobs (void *arg)
+{
+  struct parallel_jobs *jobs = (struct parallel_jobs *) arg;
+
+  for (;;)
+    {
+      unsigned int i;
+
+      pthread_mutex_lock (&jobs->lock);
+      i = jobs->next;
+      if (i < jobs->njobs)
+	jobs->next++;
+      pthread_mutex_unlock (&jobs->lock);
+      if (i >= jobs->njobs)
+	break;
+      jobs->fn (jobs->data, i);
+    }
+  return NULL;
+}
+#endif
+
+/*
+FUNCTION
+	bfd_run_parallel
+
+SYNOPSIS
+	void bfd_run_parallel
+	  (unsigned int njobs, void (*fn) (void *, unsigned int),
+	   void *data);
+
+DESCRIPTION
+	Call @var{fn} (@var{data}, @var{i}) for each @var{i} from zero
+	to @var{njobs} - 1, spreading the calls over as many as
+	@code{bfd_get_thread_count} threads, and return once they have
+	all finished.  The calls can happen in any order and at the
+	same time, so @var{fn} must not use anything in BFD that is not
+	thread-safe: it must not allocate on a bfd's objalloc, set
+	bfd_error, or read or write a file through BFD.
+*/
+
+void
+bfd_run_parallel (unsigned int njobs,
+		  void (*fn) (void *, unsigned int), void *data)
+{
+  unsigned int i;
+#ifdef HAVE_PTHREAD
+  unsigned int nthreads = bfd_get_thread_count ();
+
+  if (nthreads > njobs)
+    nthreads = njobs;
+  if (nthreads > 1)
+    {
+      pthread_t *threads = bfd_malloc ((nthreads - 1) * sizeof (*threads));
+
+      if (threads != NULL)
+	{
+	  struct parallel_jobs jobs;
+	  unsigned int started;
+
+	  jobs.fn = fn;
+	  jobs.data = data;
+	  jobs.njobs = njobs;
+	  jobs.next = 0;
+	  pthread_mutex_init (&jobs.lock, NULL);
+
+	  /* The calling thread works too, so if some threads cannot be
+	     started the jobs are still all run.  */
+	  for (started = 0; started < nthreads - 1; started++)
+	    if (pthread_create (&threads[started], NULL,
+				run_parallel_jobs, &jobs) != 0)
+	      break;
+	  run_parallel_jobs (&jobs);
+	  for (i = 0; i < started; i++)
+	    pthread_join (threads[i], NULL);
+
+	  pthread_mutex_destroy (&jobs.lock);
+	  free (threads);
+	  return;
+	}
+    }
+#endif
+
+  for (i = 0; i < njobs; i++)
+    fn (data, i);
+}
+
+/*
+FUNCTION
+	bfd_set_line_cache_dir
+
+SYNOPSIS
+	void bfd_set_line_cache_dir (const char *dir);
+
+DESCRIPTION
+	Keep the line number and function tables that BFD builds from
+	the DWARF debug info of an executable or shared library in a
+	file in the directory @var{dir}, named after the build-id of
+	the executable, and use that file instead of the debug info
+	when addresses in the same executable are looked up again.
+	@var{dir} is copied.  A NULL @var{dir}, the default, disables
+	the cache.
+*/
+
+static char *bfd_line_cache_dir;
+
+void
+bfd_set_line_cache_dir (const char *dir)
+{
+  free (bfd_line_cache_dir);
+  bfd_line_cache_dir = dir != NULL ? strdup (dir) : NULL;
+}
+
+/*
+FUNCTION
+	bfd_get_line_cache_dir
+
+SYNOPSIS
+	const char *bfd_get_line_cache_dir (void);
+
+DESCRIPTION
+	Return the directory used for the line number cache, as set by
+	@code{bfd_set_line_cache_dir}, or NULL if there is none.
+*/
+
+const char *
+bfd_get_line_cache_dir (void)
+{
+  return bfd_line_cache_dir;
+}
+
 /* Get the linker information.  */
 
 struct bfd_link_info *
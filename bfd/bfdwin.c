@@ -152,7 +152,11 @@ bfd_get_file_window (bfd *abfd,
 	}
       offset += abfd->origin;
 
-      /* Seek into the file, to ensure it is open if cacheable.  */
+      /* Seek into the file, to ensure it is open if cacheable.  A
+	 file the cache has mapped is first put back in the cache, as
+	 the window needs a descriptor to map from.  */
+      if (!bfd_cache_unmap (abfd))
+	goto free_and_fail;
       if (abfd->iostream == NULL
 	  && (abfd->iovec == NULL
 	      || abfd->iovec->bseek (abfd, offset, SEEK_SET) != 0))
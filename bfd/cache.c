@@ -36,6 +36,14 @@ SECTION
 	close, closes it and opens the one wanted, returning its file
 	handle.
 
+	The limit may be changed with <<bfd_cache_set_max_open>>.  When
+	<<bfd_cache_set_mmap>> has been called, a file opened only for
+	reading is not closed when it is chosen; instead the whole file
+	is mapped into memory, its descriptor closed, and later reads
+	are served from the mapping without reopening it.
+	<<bfd_cache_get_stats>> reports how often the cache found a file
+	open, had to reopen it, or had to close or map another.
+
 SUBSECTION
 	Caching functions
 */
@@ -117,47 +125,78 @@ bfd_cache_max_open (void)
 
 static int open_files;
 
+/* Whether to map read-only files chosen for closing, rather than
+   close them.  */
+
+static bool cache_mmap;
+
+/* The counts reported by bfd_cache_get_stats.  */
+
+static struct bfd_cache_stats cache_stats;
+
 /* Zero, or a pointer to the topmost BFD on the chain.  This is
    used by the <<bfd_cache_lookup>> macro in @file{libbfd.h} to
    determine when it can avoid a function call.  */
 
 static bfd *bfd_last_cache = NULL;
 
-/* Insert a BFD into the cache.  */
+/* Zero, or a pointer to the most recently mapped BFD.  Mapped BFDs
+   are kept on a chain of their own, linked through the same fields,
+   so that bfd_cache_close_all can find them.  */
+
+static bfd *bfd_last_mapped = NULL;
+
+/* Insert a BFD at the head of the chain *HEAD.  */
 
 static void
-insert (bfd *abfd)
+insert_1 (bfd **head, bfd *abfd)
 {
-  if (bfd_last_cache == NULL)
+  if (*head == NULL)
     {
       abfd->lru_next = abfd;
       abfd->lru_prev = abfd;
     }
   else
     {
-      abfd->lru_next = bfd_last_cache;
-      abfd->lru_prev = bfd_last_cache->lru_prev;
+      abfd->lru_next = *head;
+      abfd->lru_prev = (*head)->lru_prev;
       abfd->lru_prev->lru_next = abfd;
       abfd->lru_next->lru_prev = abfd;
     }
-  bfd_last_cache = abfd;
+  *head = abfd;
 }
 
-/* Remove a BFD from the cache.  */
+/* Remove a BFD from the chain *HEAD.  */
 
 static void
-snip (bfd *abfd)
+snip_1 (bfd **head, bfd *abfd)
 {
   abfd->lru_prev->lru_next = abfd->lru_next;
   abfd->lru_next->lru_prev = abfd->lru_prev;
-  if (abfd == bfd_last_cache)
+  if (abfd == *head)
     {
-      bfd_last_cache = abfd->lru_next;
-      if (abfd == bfd_last_cache)
-	bfd_last_cache = NULL;
+      *head = abfd->lru_next;
+      if (abfd == *head)
+	*head = NULL;
     }
 }
 
+/* Insert a BFD into the cache.  */
+
+static void
+insert (bfd *abfd)
+{
+  insert_1 (&bfd_last_cache, abfd);
+}
+
+/* Remove a BFD from the cache.  */
+
+static void
+snip (bfd *abfd)
+{
+  snip_1 (&bfd_last_cache, abfd);
+}
+
 /* Close a BFD and remove it from the cache.  */
 
 static bool
@@ -182,8 +221,95 @@ bfd_cache_delete (bfd *abfd)
   return ret;
 }
 
+#ifdef HAVE_MMAP
+/* A file that the cache has mapped rather than closed.  While ABFD
+   is mapped, ABFD->iostream points to one of these and ABFD->iovec
+   is cache_map_iovec.  */
+
+struct cache_map
+{
+  bfd_byte *base;
+  bfd_size_type size;
+  struct stat st;
+};
+
+static const struct bfd_iovec cache_iovec;
+static const struct bfd_iovec cache_map_iovec;
+
+/* Map the whole of the open file ABFD, close its descriptor, and
+   move it from the cache to the chain of mapped BFDs.  Return false,
+   leaving ABFD untouched, if the file cannot be mapped.  */
+
+static bool
+cache_map (bfd *abfd)
+{
+  FILE *f = (FILE *) abfd->iostream;
+  struct cache_map *map;
+  struct stat st;
+  void *base;
+
+  if (fstat (fileno (f), &st) != 0
+      || !S_ISREG (st.st_mode)
+      || st.st_size <= 0
+      || (uint64_t) st.st_size != (size_t) st.st_size)
+    return false;
+
+  map = (struct cache_map *) bfd_malloc (sizeof (*map));
+  if (map == NULL)
+    return false;
+  base = mmap (NULL, st.st_size, PROT_READ, MAP_PRIVATE, fileno (f), 0);
+  if (base == MAP_FAILED)
+    {
+      free (map);
+      return false;
+    }
+  map->base = (bfd_byte *) base;
+  map->size = st.st_size;
+  map->st = st;
+
+  /* The mapping is all we need, so an error closing a file that was
+     only read is of no consequence.  */
+  fclose (f);
+  snip (abfd);
+  --open_files;
+
+  abfd->iostream = map;
+  abfd->iovec = &cache_map_iovec;
+  insert_1 (&bfd_last_mapped, abfd);
+  cache_stats.mapped++;
+  cache_stats.mapped_size += map->size;
+  return true;
+}
+
+/* Release the mapping of ABFD.  The file is then treated as closed
+   by the cache, to be reopened when next needed.  */
+
+static bool
+cache_unmap (bfd *abfd)
+{
+  struct cache_map *map = (struct cache_map *) abfd->iostream;
+  bool ret = true;
+
+  if (munmap (map->base, map->size) != 0)
+    {
+      ret = false;
+      bfd_set_error (bfd_error_system_call);
+    }
+  snip_1 (&bfd_last_mapped, abfd);
+  cache_stats.mapped--;
+  cache_stats.mapped_size -= map->size;
+  free (map);
+
+  abfd->iostream = NULL;
+  abfd->iovec = &cache_iovec;
+  abfd->flags |= BFD_CLOSED_BY_CACHE;
+  return ret;
+}
+#endif /* HAVE_MMAP */
+
 /* We need to open a new file, and the cache is full.  Find the least
-   recently used cacheable BFD and close it.  */
+   recently used cacheable BFD and close it, or map it if it is only
+   being read and bfd_cache_set_mmap asked for that.  */
 
 static bool
 close_one (void)
@@ -213,6 +339,14 @@ close_one (void)
     }
 
   to_kill->where = _bfd_real_ftell ((FILE *) to_kill->iostream);
+  cache_stats.evictions++;
+
+#ifdef HAVE_MMAP
+  if (cache_mmap
+      && to_kill->direction == read_direction
+      && cache_map (to_kill))
+    return true;
+#endif
 
   return bfd_cache_delete (to_kill);
 }
@@ -223,8 +357,8 @@ close_one (void)
    otherwise, it has to perform the complicated lookup function.  */
 
 #define bfd_cache_lookup(x, flag) \
-  ((x) == bfd_last_cache			\
-   ? (FILE *) (bfd_last_cache->iostream)	\
+  ((x) == bfd_last_cache					\
+   ? (cache_stats.hits++, (FILE *) (bfd_last_cache->iostream))	\
    : bfd_cache_lookup_worker (x, flag))
 
 /* Called when the macro <<bfd_cache_lookup>> fails to find a
@@ -246,6 +380,7 @@ bfd_cache_lookup_worker (bfd *abfd, enum cache_flag flag)
 
   if (abfd->iostream != NULL)
     {
+      cache_stats.hits++;
       /* Move the file to the start of the cache.  */
       if (abfd != bfd_last_cache)
 	{
@@ -255,9 +390,11 @@ bfd_cache_lookup_worker (bfd *abfd, enum cache_flag flag)
       return (FILE *) abfd->iostream;
     }
 
+  cache_stats.misses++;
   if (flag & CACHE_NO_OPEN)
     return NULL;
 
+  cache_stats.reopens++;
   if (bfd_open_file (abfd) == NULL)
     ;
   else if (!(flag & CACHE_NO_SEEK)
@@ -484,6 +621,109 @@ static const struct bfd_iovec cache_iovec =
   &cache_bclose, &cache_bflush, &cache_bstat, &cache_bmmap
 };
 
+#ifdef HAVE_MMAP
+/* File operations on a BFD that the cache has mapped.  ABFD->where,
+   kept up to date by bfd_bread and bfd_seek, is the file position.  */
+
+static file_ptr
+cache_map_btell (struct bfd *abfd)
+{
+  return abfd->where;
+}
+
+static int
+cache_map_bseek (struct bfd *abfd, file_ptr offset, int whence)
+{
+  struct cache_map *map = (struct cache_map *) abfd->iostream;
+  file_ptr nwhere;
+
+  /* As with fseek, a position past the end of the file is allowed;
+     a read from there returns nothing.  */
+  if (whence == SEEK_SET)
+    nwhere = offset;
+  else if (whence == SEEK_CUR)
+    nwhere = abfd->where + offset;
+  else
+    nwhere = map->size + offset;
+  if (nwhere < 0)
+    {
+      errno = EINVAL;
+      return -1;
+    }
+  return 0;
+}
+
+static file_ptr
+cache_map_bread (struct bfd *abfd, void *buf, file_ptr nbytes)
+{
+  struct cache_map *map = (struct cache_map *) abfd->iostream;
+  bfd_size_type where = abfd->where;
+  bfd_size_type avail;
+
+  cache_stats.hits++;
+  avail = where < map->size ? map->size - where : 0;
+  if ((bfd_size_type) nbytes > avail)
+    {
+      nbytes = avail;
+      bfd_set_error (bfd_error_file_truncated);
+    }
+  memcpy (buf, map->base + where, nbytes);
+  return nbytes;
+}
+
+static file_ptr
+cache_map_bwrite (struct bfd *abfd ATTRIBUTE_UNUSED,
+		  const void *from ATTRIBUTE_UNUSED,
+		  file_ptr nbytes ATTRIBUTE_UNUSED)
+{
+  /* Only files opened for reading are mapped.  */
+  bfd_set_error (bfd_error_invalid_operation);
+  return -1;
+}
+
+static int
+cache_map_bclose (struct bfd *abfd)
+{
+  return bfd_cache_close (abfd) - 1;
+}
+
+static int
+cache_map_bflush (struct bfd *abfd ATTRIBUTE_UNUSED)
+{
+  return 0;
+}
+
+static int
+cache_map_bstat (struct bfd *abfd, struct stat *sb)
+{
+  struct cache_map *map = (struct cache_map *) abfd->iostream;
+
+  cache_stats.hits++;
+  *sb = map->st;
+  return 0;
+}
+
+static void *
+cache_map_bmmap (struct bfd *abfd, void *addr, bfd_size_type len,
+		 int prot, int flags, file_ptr offset,
+		 void **map_addr, bfd_size_type *map_len)
+{
+  /* The caller will unmap what it is given, so it cannot share the
+     cache's mapping.  Put the file back in the cache, which reopens
+     it, and map from its descriptor.  */
+  if (!cache_unmap (abfd))
+    return (void *) -1;
+  return cache_bmmap (abfd, addr, len, prot, flags, offset,
+		      map_addr, map_len);
+}
+
+static const struct bfd_iovec cache_map_iovec =
+{
+  &cache_map_bread, &cache_map_bwrite, &cache_map_btell, &cache_map_bseek,
+  &cache_map_bclose, &cache_map_bflush, &cache_map_bstat, &cache_map_bmmap
+};
+#endif /* HAVE_MMAP */
+
 /*
 INTERNAL_FUNCTION
 	bfd_cache_init
@@ -528,6 +768,13 @@ DESCRIPTION
 bool
 bfd_cache_close (bfd *abfd)
 {
+#ifdef HAVE_MMAP
+  /* Archive elements copy their archive's iovec but have no stream
+     of their own.  */
+  if (abfd->iovec == &cache_map_iovec)
+    return abfd->iostream == NULL || cache_unmap (abfd);
+#endif
+
   if (abfd->iovec != &cache_iovec)
     return true;
 
@@ -538,6 +785,32 @@ bfd_cache_close (bfd *abfd)
   return bfd_cache_delete (abfd);
 }
 
+/*
+INTERNAL_FUNCTION
+	bfd_cache_unmap
+
+SYNOPSIS
+	bool bfd_cache_unmap (bfd *abfd);
+
+DESCRIPTION
+	If the cache has mapped @var{abfd} in place of keeping it open,
+	release the mapping, so that the file is reopened when next
+	used and @var{abfd}->iostream is again a <<FILE>>.
+
+	<<FALSE>> is returned if releasing the mapping fails, <<TRUE>>
+	is returned if all is well.
+*/
+
+bool
+bfd_cache_unmap (bfd *abfd)
+{
+#ifdef HAVE_MMAP
+  if (abfd->iovec == &cache_map_iovec && abfd->iostream != NULL)
+    return cache_unmap (abfd);
+#endif
+  return true;
+}
+
 /*
 FUNCTION
 	bfd_cache_close_all
@@ -547,7 +820,8 @@ SYNOPSIS
 
 DESCRIPTION
 	Remove all BFDs from the cache. If the attached file is open,
-	then close it too.
+	then close it too.  Files that the cache has mapped are
+	unmapped.
 
 	<<FALSE>> is returned if closing one of the file fails, <<TRUE>> is
 	returned if all is well.
@@ -561,9 +835,96 @@ bfd_cache_close_all (void)
   while (bfd_last_cache != NULL)
     ret &= bfd_cache_close (bfd_last_cache);
 
+#ifdef HAVE_MMAP
+  while (bfd_last_mapped != NULL)
+    ret &= bfd_cache_close (bfd_last_mapped);
+#endif
+
   return ret;
 }
 
+/*
+FUNCTION
+	bfd_cache_set_max_open
+
+SYNOPSIS
+	int bfd_cache_set_max_open (int max);
+
+DESCRIPTION
+	Set to @var{max} the number of files that the cache keeps open
+	at once, or if @var{max} is zero or negative restore the
+	default, which is an eighth of the process's limit on open
+	files but at least 10.  If more files than that are open, the
+	least recently used are closed now.  Return the previous limit.
+*/
+
+int
+bfd_cache_set_max_open (int max)
+{
+  int old = bfd_cache_max_open ();
+
+  max_open_files = max > 0 ? max : 0;
+  while (open_files > bfd_cache_max_open ())
+    {
+      int before = open_files;
+
+      if (!close_one () || open_files == before)
+	break;
+    }
+
+  return old;
+}
+
+/*
+FUNCTION
+	bfd_cache_set_mmap
+
+SYNOPSIS
+	bool bfd_cache_set_mmap (bool map);
+
+DESCRIPTION
+	If @var{map} is true, then when the cache is full and the file
+	it chooses to close was opened only for reading, map the whole
+	file into memory and close just its descriptor.  Later reads
+	of that BFD copy from the mapping, so the file is not reopened
+	and no seek is needed.  Files already mapped stay mapped if
+	@var{map} is false.  This has no effect on hosts without
+	<<mmap>>.  Return the previous setting.
+*/
+
+bool
+bfd_cache_set_mmap (bool map)
+{
+  bool old = cache_mmap;
+
+  cache_mmap = map;
+  return old;
+}
+
+/*
+FUNCTION
+	bfd_cache_get_stats
+
+SYNOPSIS
+	void bfd_cache_get_stats (struct bfd_cache_stats *stats);
+
+DESCRIPTION
+	Fill in @var{stats} with the counts kept by the cache since the
+	program started, and the number of files now open or mapped.
+	A hit is an access that found the file open or mapped, a miss
+	one that found it closed by the cache, and a reopen a miss that
+	needed the file and so opened it again.  An eviction is a file
+	closed or mapped to make room for another.
+*/
+
+void
+bfd_cache_get_stats (struct bfd_cache_stats *stats)
+{
+  *stats = cache_stats;
+  stats->open = open_files;
+  stats->max_open = bfd_cache_max_open ();
+}
+
 /*
 INTERNAL_FUNCTION
 	bfd_open_file
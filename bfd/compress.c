@@ -553,6 +553,75 @@ decompress_contents (bool is_zstd, bfd_byte *compressed_buffer,
   return inflateEnd (&strm) == Z_OK && rc == Z_OK && strm.avail_out == 0;
 }
 
+/* Compress UNCOMPRESSED_SIZE bytes at UNCOMPRESSED_BUFFER with zstd
+   if IS_ZSTD, otherwise with zlib, into COMPRESSED_BUFFER which is
+   *COMPRESSED_SIZE bytes long.  Set *COMPRESSED_SIZE to the size of the
+   compressed data.  This touches no BFD state, so may be called from
+   several threads at once.  */
+
+static bool
+compress_contents (bool is_zstd, bfd_byte *uncompressed_buffer,
+		   bfd_size_type uncompressed_size,
+		   bfd_byte *compressed_buffer,
+		   bfd_size_type *compressed_size)
+{
+  if (is_zstd)
+    {
+#if HAVE_ZSTD
+      size_t ret = ZSTD_compress (compressed_buffer, *compressed_size,
+				  uncompressed_buffer, uncompressed_size,
+				  ZSTD_CLEVEL_DEFAULT);
+      if (ZSTD_isError (ret))
+	return false;
+      *compressed_size = ret;
+#endif
+      /* Without zstd support *COMPRESSED_SIZE is left as the buffer
+	 size, which is never smaller than UNCOMPRESSED_SIZE, so the
+	 caller will keep the contents uncompressed.  */
+      return true;
+    }
+
+  uLong size = *compressed_size;
+  if (compress ((Bytef *) compressed_buffer, &size,
+		(const Bytef *) uncompressed_buffer, uncompressed_size)
+      != Z_OK)
+    return false;
+  *compressed_size = size;
+  return true;
+}
+
+/* Install BUFFER, of COMPRESSED_SIZE bytes including the compression
+   header, as the contents of SEC, whose UNCOMPRESSED_SIZE bytes of
+   uncompressed contents are in INPUT_BUFFER.  If compression didn't
+   make the section smaller then the uncompressed contents are copied
+   to BUFFER instead.  INPUT_BUFFER is freed.  */
+
+static void
+compress_section_finish (bfd *abfd, sec_ptr sec, bfd_byte *buffer,
+			 bfd_size_type compressed_size,
+			 bfd_byte *input_buffer,
+			 bfd_size_type uncompressed_size)
+{
+  /* If compression didn't make the section smaller, keep it uncompressed.  */
+  if (compressed_size >= uncompressed_size)
+    {
+      memcpy (buffer, input_buffer, uncompressed_size);
+      if (bfd_get_flavour (abfd) == bfd_target_elf_flavour)
+	elf_section_flags (sec) &= ~SHF_COMPRESSED;
+      sec->compress_status = COMPRESS_SECTION_NONE;
+    }
+  else
+    {
+      sec->size = uncompressed_size;
+      bfd_update_compression_header (abfd, buffer, sec);
+      sec->size = compressed_size;
+      sec->compress_status = COMPRESS_SECTION_DONE;
+    }
+  sec->contents = buffer;
+  sec->flags |= SEC_IN_MEMORY;
+  free (input_buffer);
+}
+
 /* Compress section contents using zlib/zstd and store
    as the contents field.  This function assumes the contents
    field was allocated using bfd_malloc() or equivalent.
@@ -564,7 +633,7 @@ static bfd_size_type
 bfd_compress_section_contents (bfd *abfd, sec_ptr sec)
 {
   bfd_byte *input_buffer;
-  uLong compressed_size;
+  bfd_size_type compressed_size;
   bfd_byte *buffer;
   bfd_size_type buffer_size;
   int zlib_size = 0;
@@ -647,25 +716,10 @@ bfd_compress_section_contents (bfd *abfd, sec_ptr sec)
     }
   else
     {
-      if (abfd->flags & BFD_COMPRESS_ZSTD)
-	{
-#if HAVE_ZSTD
-	  compressed_size = ZSTD_compress (buffer + new_header_size,
-					   compressed_size,
-					   input_buffer,
-					   uncompressed_size,
-					   ZSTD_CLEVEL_DEFAULT);
-	  if (ZSTD_isError (compressed_size))
-	    {
-	      bfd_release (abfd, buffer);
-	      bfd_set_error (bfd_error_bad_value);
-	      return 0;
-	    }
-#endif
-	}
-      else if (compress ((Bytef *) buffer + new_header_size, &compressed_size,
-			 (const Bytef *) input_buffer, uncompressed_size)
-	       != Z_OK)
+      compressed_size -= new_header_size;
+      if (!compress_contents ((abfd->flags & BFD_COMPRESS_ZSTD) != 0,
+			      input_buffer, uncompressed_size,
+			      buffer + new_header_size, &compressed_size))
 	{
 	  bfd_release (abfd, buffer);
 	  bfd_set_error (bfd_error_bad_value);
@@ -675,25 +729,62 @@ bfd_compress_section_contents (bfd *abfd, sec_ptr sec)
       compressed_size += new_header_size;
     }
 
-  /* If compression didn't make the section smaller, keep it uncompressed.  */
-  if (compressed_size >= uncompressed_size)
-    {
-      memcpy (buffer, input_buffer, uncompressed_size);
-      if (bfd_get_flavour (abfd) == bfd_target_elf_flavour)
-	elf_section_flags (sec) &= ~SHF_COMPRESSED;
-      sec->compress_status = COMPRESS_SECTION_NONE;
-    }
-  else
+  compress_section_finish (abfd, sec, buffer, compressed_size,
+			   input_buffer, uncompressed_size);
+  return uncompressed_size;
+}
+
+/* Read the compressed contents of SEC, which is being decompressed,
+   into a buffer malloc'd by this function.  Return NULL on error.  */
+
+static bfd_byte *
+read_compressed_contents (bfd *abfd, sec_ptr sec)
+{
+  const unsigned int compress_status = sec->compress_status;
+  bfd_size_type save_size;
+  bfd_size_type save_rawsize;
+  bfd_byte *compressed_buffer;
+  bool ret;
+
+  compressed_buffer = (bfd_byte *) bfd_malloc (sec->compressed_size);
+  if (compressed_buffer == NULL)
+    return NULL;
+  save_rawsize = sec->rawsize;
+  save_size = sec->size;
+  /* Clear rawsize, set size to compressed size and set compress_status
+     to COMPRESS_SECTION_NONE.  If the compressed size is bigger than
+     the uncompressed size, bfd_get_section_contents will fail.  */
+  sec->rawsize = 0;
+  sec->size = sec->compressed_size;
+  sec->compress_status = COMPRESS_SECTION_NONE;
+  ret = bfd_get_section_contents (abfd, sec, compressed_buffer,
+				  0, sec->compressed_size);
+  /* Restore rawsize and size.  */
+  sec->rawsize = save_rawsize;
+  sec->size = save_size;
+  sec->compress_status = compress_status;
+  if (!ret)
     {
-      sec->size = uncompressed_size;
-      bfd_update_compression_header (abfd, buffer, sec);
-      sec->size = compressed_size;
-      sec->compress_status = COMPRESS_SECTION_DONE;
+      free (compressed_buffer);
+      return NULL;
     }
-  sec->contents = buffer;
-  sec->flags |= SEC_IN_MEMORY;
-  free (input_buffer);
-  return uncompressed_size;
+  return compressed_buffer;
+}
+
+/* Return the offset of the compressed data in the contents of SEC,
+   as read by read_compressed_contents.  */
+
+static unsigned int
+compressed_contents_offset (bfd *abfd, sec_ptr sec)
+{
+  unsigned int compression_header_size;
+
+  compression_header_size = bfd_get_compression_header_size (abfd, sec);
+  if (compression_header_size == 0)
+    /* Set header size to the zlib header size if it is a
+       SHF_COMPRESSED section.  */
+    compression_header_size = 12;
+  return compression_header_size;
 }
 
 /*
@@ -720,9 +811,6 @@ bfd_get_full_section_contents (bfd *abfd, sec_ptr sec, bfd_byte **ptr)
   bfd_size_type readsz = bfd_get_section_limit_octets (abfd, sec);
   bfd_size_type allocsz = bfd_get_section_alloc_size (abfd, sec);
   bfd_byte *p = *ptr;
-  bool ret;
-  bfd_size_type save_size;
-  bfd_size_type save_rawsize;
   bfd_byte *compressed_buffer;
   unsigned int compression_header_size;
   const unsigned int compress_status = sec->compress_status;
@@ -776,36 +864,16 @@ bfd_get_full_section_contents (bfd *abfd, sec_ptr sec, bfd_byte **ptr)
     case DECOMPRESS_SECTION_ZLIB:
     case DECOMPRESS_SECTION_ZSTD:
       /* Read in the full compressed section contents.  */
-      compressed_buffer = (bfd_byte *) bfd_malloc (sec->compressed_size);
+      compressed_buffer = read_compressed_contents (abfd, sec);
       if (compressed_buffer == NULL)
 	return false;
-      save_rawsize = sec->rawsize;
-      save_size = sec->size;
-      /* Clear rawsize, set size to compressed size and set compress_status
-	 to COMPRESS_SECTION_NONE.  If the compressed size is bigger than
-	 the uncompressed size, bfd_get_section_contents will fail.  */
-      sec->rawsize = 0;
-      sec->size = sec->compressed_size;
-      sec->compress_status = COMPRESS_SECTION_NONE;
-      ret = bfd_get_section_contents (abfd, sec, compressed_buffer,
-				      0, sec->compressed_size);
-      /* Restore rawsize and size.  */
-      sec->rawsize = save_rawsize;
-      sec->size = save_size;
-      sec->compress_status = compress_status;
-      if (!ret)
-	goto fail_compressed;
 
       if (p == NULL)
 	p = (bfd_byte *) bfd_malloc (allocsz);
       if (p == NULL)
 	goto fail_compressed;
 
-      compression_header_size = bfd_get_compression_header_size (abfd, sec);
-      if (compression_header_size == 0)
-	/* Set header size to the zlib header size if it is a
-	   SHF_COMPRESSED section.  */
-	compression_header_size = 12;
+      compression_header_size = compressed_contents_offset (abfd, sec);
       bool is_zstd = compress_status == DECOMPRESS_SECTION_ZSTD;
       if (!decompress_contents (
 	      is_zstd, compressed_buffer + compression_header_size,
@@ -843,6 +911,143 @@ bfd_get_full_section_contents (bfd *abfd, sec_ptr sec, bfd_byte **ptr)
     }
 }
 
+/* One section's worth of work for bfd_get_full_sections_contents.  */
+
+struct decompress_job
+{
+  bfd_byte *input;
+  bfd_size_type input_size;
+  unsigned int header_size;
+  bfd_byte *output;
+  bfd_size_type output_size;
+  bool is_zstd;
+  bool ok;
+};
+
+static void
+run_decompress_job (void *data, unsigned int i)
+{
+  struct decompress_job *job = (struct decompress_job *) data + i;
+
+  job->ok = decompress_contents (job->is_zstd,
+				 job->input + job->header_size,
+				 job->input_size - job->header_size,
+				 job->output, job->output_size);
+}
+
+/*
+FUNCTION
+	bfd_get_full_sections_contents
+
+SYNOPSIS
+	bool bfd_get_full_sections_contents
+	  (bfd *abfd, asection **sections, bfd_byte **ptrs,
+	   unsigned int count);
+
+DESCRIPTION
+	Read the full contents of each of the @var{count} @var{sections}
+	of BFD @var{abfd}, as @code{bfd_get_full_section_contents} does,
+	into memory malloc'd by this function, and store them in the
+	matching element of @var{ptrs}.  Sections that need
+	decompressing are decompressed on as many as
+	@code{bfd_get_thread_count} threads.
+
+	Return @code{TRUE} if the contents of every section were
+	retrieved.  Otherwise the elements of @var{ptrs} for the
+	sections whose contents could not be retrieved are set to NULL,
+	as are those for sections with no contents.
+*/
+
+bool
+bfd_get_full_sections_contents (bfd *abfd, sec_ptr *secs, bfd_byte **ptrs,
+				unsigned int count)
+{
+  struct decompress_job *jobs;
+  struct decompress_job **sec_jobs;
+  unsigned int i, njobs = 0;
+  bool ret = true;
+
+  if (count == 0)
+    return true;
+
+  jobs = bfd_malloc (count * sizeof (*jobs));
+  sec_jobs = bfd_zmalloc (count * sizeof (*sec_jobs));
+  if (jobs == NULL || sec_jobs == NULL)
+    {
+      free (jobs);
+      free (sec_jobs);
+      jobs = NULL;
+      sec_jobs = NULL;
+    }
+
+  /* Do all the reading on this thread, setting aside the sections that
+     need decompressing.  */
+  for (i = 0; i < count; i++)
+    {
+      sec_ptr sec = secs[i];
+      struct decompress_job *job;
+
+      ptrs[i] = NULL;
+      if (jobs == NULL
+	  || (sec->compress_status != DECOMPRESS_SECTION_ZLIB
+	      && sec->compress_status != DECOMPRESS_SECTION_ZSTD)
+	  || bfd_get_section_alloc_size (abfd, sec) == 0
+	  || _bfd_section_size_insane (abfd, sec))
+	{
+	  if (!bfd_get_full_section_contents (abfd, sec, &ptrs[i]))
+	    {
+	      ptrs[i] = NULL;
+	      ret = false;
+	    }
+	  continue;
+	}
+
+      job = &jobs[njobs];
+      job->input = read_compressed_contents (abfd, sec);
+      if (job->input == NULL)
+	{
+	  ret = false;
+	  continue;
+	}
+      job->output = bfd_malloc (bfd_get_section_alloc_size (abfd, sec));
+      if (job->output == NULL)
+	{
+	  free (job->input);
+	  ret = false;
+	  continue;
+	}
+      job->input_size = sec->compressed_size;
+      job->header_size = compressed_contents_offset (abfd, sec);
+      job->output_size = bfd_get_section_limit_octets (abfd, sec);
+      job->is_zstd = sec->compress_status == DECOMPRESS_SECTION_ZSTD;
+      sec_jobs[i] = job;
+      njobs++;
+    }
+
+  bfd_run_parallel (njobs, run_decompress_job, jobs);
+
+  for (i = 0; sec_jobs != NULL && i < count; i++)
+    {
+      struct decompress_job *job = sec_jobs[i];
+
+      if (job == NULL)
+	continue;
+      free (job->input);
+      if (job->ok)
+	ptrs[i] = job->output;
+      else
+	{
+	  free (job->output);
+	  bfd_set_error (bfd_error_bad_value);
+	  ret = false;
+	}
+    }
+
+  free (jobs);
+  free (sec_jobs);
+  return ret;
+}
+
 /*
 FUNCTION
 	bfd_is_section_compressed_info
@@ -1137,3 +1342,134 @@ bfd_compress_section (bfd *abfd, sec_ptr sec, bfd_byte *uncompressed_buffer)
     }
   return true;
 }
+
+/* One section's worth of work for _bfd_compress_sections.  */
+
+struct compress_job
+{
+  sec_ptr sec;
+  bfd_byte *input;
+  bfd_size_type input_size;
+  bfd_byte *buffer;
+  bfd_size_type buffer_size;
+  int header_size;
+  bool is_zstd;
+  bool ok;
+};
+
+static void
+run_compress_job (void *data, unsigned int i)
+{
+  struct compress_job *job = (struct compress_job *) data + i;
+
+  job->ok = compress_contents (job->is_zstd, job->input, job->input_size,
+			       job->buffer + job->header_size,
+			       &job->buffer_size);
+}
+
+/* Compress the COUNT sections SECS of ABFD, whose uncompressed
+   contents are in BUFFERS, with the same result as calling
+   bfd_compress_section on each in turn.  When bfd_get_thread_count
+   allows, the compression itself is done on several threads; all the
+   setup and bookkeeping, which is not thread-safe, stays on the
+   calling thread.  BUFFERS are freed.  */
+
+bool
+_bfd_compress_sections (bfd *abfd, sec_ptr *secs, bfd_byte **buffers,
+			unsigned int count)
+{
+  struct compress_job *jobs = NULL;
+  unsigned int i, njobs = 0;
+  int header_size;
+  bool ret = true;
+
+  if (count > 1 && bfd_get_thread_count () > 1)
+    jobs = bfd_malloc (count * sizeof (*jobs));
+
+  header_size = bfd_get_compression_header_size (abfd, NULL);
+  if (header_size == 0)
+    header_size = 12;
+
+  for (i = 0; i < count; i++)
+    {
+      sec_ptr sec = secs[i];
+      int orig_header_size;
+      bfd_size_type uncompressed_size;
+      unsigned int alignment_pow;
+      enum compression_type ch_type;
+
+      if (jobs != NULL
+	  && abfd->direction == write_direction
+	  && sec->size != 0
+	  && buffers[i] != NULL
+	  && sec->contents == NULL
+	  && sec->compressed_size == 0
+	  && sec->compress_status == COMPRESS_SECTION_NONE)
+	{
+	  /* Contents that are already compressed need converting,
+	     which is left to bfd_compress_section.  */
+	  sec->contents = buffers[i];
+	  if (!bfd_is_section_compressed_info (abfd, sec, &orig_header_size,
+					      &uncompressed_size,
+					      &alignment_pow, &ch_type))
+	    {
+	      struct compress_job *job = &jobs[njobs];
+
+	      job->buffer = bfd_alloc (abfd, compressBound (sec->size)
+					     + header_size);
+	      if (job->buffer == NULL)
+		{
+		  free (buffers[i]);
+		  sec->contents = NULL;
+		  ret = false;
+		  break;
+		}
+	      job->sec = sec;
+	      job->input = buffers[i];
+	      job->input_size = sec->size;
+	      job->buffer_size = compressBound (sec->size);
+	      job->header_size = header_size;
+	      job->is_zstd = (abfd->flags & BFD_COMPRESS_ZSTD) != 0;
+	      njobs++;
+	      continue;
+	    }
+	  sec->contents = NULL;
+	}
+
+      if (!bfd_compress_section (abfd, sec, buffers[i]))
+	{
+	  ret = false;
+	  break;
+	}
+    }
+
+  if (ret)
+    bfd_run_parallel (njobs, run_compress_job, jobs);
+  else
+    {
+      /* Free the buffers of the sections after the one that failed.  */
+      for (i++; i < count; i++)
+	free (buffers[i]);
+    }
+
+  for (i = 0; i < njobs; i++)
+    {
+      struct compress_job *job = &jobs[i];
+
+      if (!ret || !job->ok)
+	{
+	  if (ret)
+	    bfd_set_error (bfd_error_bad_value);
+	  free (job->input);
+	  job->sec->contents = NULL;
+	  ret = false;
+	  continue;
+	}
+      compress_section_finish (abfd, job->sec, job->buffer,
+			       job->buffer_size + job->header_size,
+			       job->input, job->input_size);
+    }
+
+  free (jobs);
+  return ret;
+}
@@ -38,6 +38,9 @@
 #include "dwarf2.h"
 #include "hashtab.h"
 #include "splay-tree.h"
+#ifdef HAVE_MMAP
+#include <sys/mman.h>
+#endif
 
 /* The data in the .debug_line statement prologue looks like this.  */
 
@@ -85,75 +88,76 @@ struct adjusted_section
   bfd_vma orig_vma;
 };
 
-/* A trie to map quickly from address range to compilation unit.
-
-   This is a fairly standard radix-256 trie, used to quickly locate which
-   compilation unit any given address belongs to.  Given that each compilation
-   unit may register hundreds of very small and unaligned ranges (which may
-   potentially overlap, due to inlining and other concerns), and a large
-   program may end up containing hundreds of thousands of such ranges, we cannot
-   scan through them linearly without undue slowdown.
-
-   We use a hybrid trie to avoid memory explosion: There are two types of trie
-   nodes, leaves and interior nodes.  (Almost all nodes are leaves, so they
-   take up the bulk of the memory usage.) Leaves contain a simple array of
-   ranges (high/low address) and which compilation unit contains those ranges,
-   and when we get to a leaf, we scan through it linearly.  Interior nodes
-   contain pointers to 256 other nodes, keyed by the next byte of the address.
-   So for a 64-bit address like 0x1234567abcd, we would start at the root and go
-   down child[0x00]->child[0x00]->child[0x01]->child[0x23]->child[0x45] etc.,
-   until we hit a leaf.  (Nodes are, in general, leaves until they exceed the
-   default allocation of 16 elements, at which point they are converted to
-   interior node if possible.) This gives us near-constant lookup times;
-   the only thing that can be costly is if there are lots of overlapping ranges
-   within a single 256-byte segment of the binary, in which case we have to
-   scan through them all to find the best match.
-
-   For a binary with few ranges, we will in practice only have a single leaf
-   node at the root, containing a simple array.  Thus, the scheme is efficient
-   for both small and large binaries.
- */
-
-/* Experiments have shown 16 to be a memory-efficient default leaf size.
-   The only case where a leaf will hold more memory than this, is at the
-   bottomost level (covering 256 bytes in the binary), where we'll expand
-   the leaf to be able to hold more ranges if needed.
- */
-#define TRIE_LEAF_SIZE 16
-
-/* All trie_node pointers will really be trie_leaf or trie_interior,
-   but they have this common head.  */
-struct trie_node
-{
-  /* If zero, we are an interior node.
-     Otherwise, how many ranges we have room for in this leaf.  */
-  unsigned int num_room_in_leaf;
-};
-
-struct trie_leaf
+/* An index to map quickly from address range to compilation unit.
+
+   Each compilation unit may register hundreds of very small and
+   unaligned ranges (which may potentially overlap, due to inlining and
+   other concerns), and a large program may end up containing hundreds of
+   thousands of such ranges, so we cannot scan through them linearly
+   without undue slowdown.
+
+   The ranges are kept in one flat array, made up of runs that are each
+   sorted by low address.  Every entry also records the highest high
+   address of itself and the entries before it in its run, so a lookup in
+   a run is a binary search for the last range starting at or below the
+   address, followed by a walk back that stops as soon as no earlier
+   range can reach the address.  Ranges of the same unit that touch or
+   overlap are combined when runs are merged, so the walk back is
+   normally a step or two even though a unit's ranges nest inside one
+   another.
+
+   Ranges are added a few at a time, in between lookups, as units are
+   read and their line and function tables decoded.  To keep that cheap
+   the runs are merged like the digits of a binary counter: a new range
+   starts a run of its own, and while the last two runs were built from
+   the same number of ranges they are merged into one.  That keeps the
+   number of runs, and so the number of binary searches per lookup,
+   logarithmic in the number of ranges.  Once lookups stop adding
+   ranges, which happens when all the units they need have been decoded,
+   the runs are merged into one.  */
+
+struct arange_index_entry
 {
-  struct trie_node head;
-  unsigned int num_stored_in_leaf;
-  struct {
-    struct comp_unit *unit;
-    bfd_vma low_pc, high_pc;
-  } ranges[TRIE_LEAF_SIZE];
+  bfd_vma low_pc, high_pc;
+
+  /* The highest HIGH_PC of this entry and those before it in its run.  */
+  bfd_vma max_high_pc;
+
+  /* The offset in .debug_info of the unit containing the range.  */
+  uint64_t unit_offset;
 };
 
-struct trie_interior
+struct arange_index_run
 {
-  struct trie_node head;
-  struct trie_node *children[256];
+  /* The first entry in the run, and how many entries it has.  */
+  size_t start, length;
+
+  /* How many ranges were added to make up the run, before any were
+     combined.  */
+  size_t added;
 };
 
-static struct trie_node *alloc_trie_leaf (bfd *abfd)
+struct arange_index
 {
-  struct trie_leaf *leaf = bfd_zalloc (abfd, sizeof (struct trie_leaf));
-  if (leaf == NULL)
-    return NULL;
-  leaf->head.num_room_in_leaf = TRIE_LEAF_SIZE;
-  return &leaf->head;
-}
+  /* The entries, and how many are used and allocated.  */
+  struct arange_index_entry *entries;
+  size_t count, alloc;
+
+  /* The sorted runs, in the order their entries appear.  */
+  struct arange_index_run runs[8 * sizeof (size_t)];
+  unsigned int num_runs;
+
+  /* The number of lookups since a range was last added.  */
+  size_t idle_lookups;
+
+  /* Scratch space to merge runs.  */
+  struct arange_index_entry *merge;
+  size_t merge_alloc;
+
+  /* The units found by the last lookup, sorted by offset.  */
+  uint64_t *found;
+  size_t found_alloc;
+};
 
 struct addr_range
 {
@@ -275,8 +279,18 @@ struct dwarf2_debug_file
   /* Hash table to map offsets to decoded abbrevs.  */
   htab_t abbrev_offsets;
 
-  /* Root of a trie to map addresses to compilation units.  */
-  struct trie_node *trie_root;
+  /* Index of the address ranges of the units read so far.  */
+  struct arange_index unit_index;
+
+  /* The units read so far, in the order they appear in .debug_info.  */
+  struct comp_unit **units;
+  size_t num_units, units_alloc;
+
+  /* Index of the address ranges in .debug_aranges.  */
+  struct arange_index aranges_index;
+
+  /* TRUE if .debug_aranges has been looked for.  */
+  bool aranges_read;
 
   /* Splay tree to map info_ptr address to compilation units.  */
   splay_tree comp_unit_tree;
@@ -336,6 +350,12 @@ struct dwarf2_debug
 
   /* True if we opened bfd_ptr.  */
   bool close_on_cleanup;
+
+  /* The line number cache used for looking up addresses, if any.  */
+  struct line_cache *line_cache;
+
+  /* True if LINE_CACHE has been set up, or found not to be wanted.  */
+  bool line_cache_tried;
 };
 
 struct arange
@@ -354,7 +374,7 @@ struct comp_unit
   struct comp_unit *next_unit;
 
   /* Chain the previously read compilation units that have no ranges yet.
-     We scan these separately when we have a trie over the ranges.
+     We scan these separately when we look addresses up in the index.
      Unused if arange.high != 0. */
   struct comp_unit *next_unit_without_ranges;
 
@@ -422,6 +442,9 @@ struct comp_unit
   /* DWARF format version for this unit - from unit header.  */
   int version;
 
+  /* DW_UT_* unit type for this unit - from unit header.  */
+  enum dwarf_unit_type unit_type;
+
   /* Address size for this unit - from unit header.  */
   unsigned char addr_size;
 
@@ -435,10 +458,6 @@ struct comp_unit
   /* TRUE if symbols are cached in hash table for faster lookup by name.  */
   bool cached;
 
-  /* Used when iterating over trie leaves to know which units we have
-     already seen in this iteration.  */
-  bool mark;
-
  /* Base address of debug_addr section.  */
   size_t dwarf_addr_offset;
 
@@ -1057,51 +1076,58 @@ read_alt_indirect_ref (struct comp_unit *unit, uint64_t offset)
 }
 
 static uint64_t
-read_address (struct comp_unit *unit, bfd_byte **ptr, bfd_byte *buf_end)
+read_address_1 (bfd *abfd, unsigned int addr_size,
+		bfd_byte **ptr, bfd_byte *buf_end)
 {
   bfd_byte *buf = *ptr;
   int signed_vma = 0;
 
-  if (bfd_get_flavour (unit->abfd) == bfd_target_elf_flavour)
-    signed_vma = get_elf_backend_data (unit->abfd)->sign_extend_vma;
+  if (bfd_get_flavour (abfd) == bfd_target_elf_flavour)
+    signed_vma = get_elf_backend_data (abfd)->sign_extend_vma;
 
-  if (unit->addr_size > (size_t) (buf_end - buf))
+  if (addr_size > (size_t) (buf_end - buf))
     {
       *ptr = buf_end;
       return 0;
     }
 
-  *ptr = buf + unit->addr_size;
+  *ptr = buf + addr_size;
   if (signed_vma)
     {
-      switch (unit->addr_size)
+      switch (addr_size)
 	{
 	case 8:
-	  return bfd_get_signed_64 (unit->abfd, buf);
+	  return bfd_get_signed_64 (abfd, buf);
 	case 4:
-	  return bfd_get_signed_32 (unit->abfd, buf);
+	  return bfd_get_signed_32 (abfd, buf);
 	case 2:
-	  return bfd_get_signed_16 (unit->abfd, buf);
+	  return bfd_get_signed_16 (abfd, buf);
 	default:
 	  abort ();
 	}
     }
   else
     {
-      switch (unit->addr_size)
+      switch (addr_size)
 	{
 	case 8:
-	  return bfd_get_64 (unit->abfd, buf);
+	  return bfd_get_64 (abfd, buf);
 	case 4:
-	  return bfd_get_32 (unit->abfd, buf);
+	  return bfd_get_32 (abfd, buf);
 	case 2:
-	  return bfd_get_16 (unit->abfd, buf);
+	  return bfd_get_16 (abfd, buf);
 	default:
 	  abort ();
 	}
     }
 }
 
+static uint64_t
+read_address (struct comp_unit *unit, bfd_byte **ptr, bfd_byte *buf_end)
+{
+  return read_address_1 (unit->abfd, unit->addr_size, ptr, buf_end);
+}
+
 /* Lookup an abbrev_info structure in the abbrev hash table.  */
 
 static struct abbrev_info *
@@ -2098,193 +2124,239 @@ concat_filename (struct line_info_table *table, unsigned int file)
   return strdup (filename);
 }
 
-/* Number of bits in a bfd_vma.  */
-#define VMA_BITS (8 * sizeof (bfd_vma))
+/* Combine ENTRY with the last entry before OUT in ENTRIES, which starts
+   at FIRST, if both belong to the same unit and touch or overlap.
+   Otherwise store ENTRY at OUT.  Return the new OUT.  */
+
+static struct arange_index_entry *
+arange_index_emit (struct arange_index_entry *first,
+		   struct arange_index_entry *out,
+		   const struct arange_index_entry *entry)
+{
+  if (out > first
+      && out[-1].unit_offset == entry->unit_offset
+      && entry->low_pc <= out[-1].high_pc)
+    {
+      if (entry->high_pc > out[-1].high_pc)
+	out[-1].high_pc = entry->high_pc;
+      return out;
+    }
+  *out = *entry;
+  return out + 1;
+}
 
-/* Check whether [low1, high1) can be combined with [low2, high2),
-   i.e., they touch or overlap.  */
+/* Merge the last two runs in IDX into one.  */
 
 static bool
-ranges_overlap (bfd_vma low1,
-		bfd_vma high1,
-		bfd_vma low2,
-		bfd_vma high2)
+arange_index_merge_runs (struct arange_index *idx)
 {
-  if (low1 == low2 || high1 == high2)
-    return true;
+  struct arange_index_run *left = &idx->runs[idx->num_runs - 2];
+  struct arange_index_run *right = &idx->runs[idx->num_runs - 1];
+  struct arange_index_entry *first = idx->entries + left->start;
+  struct arange_index_entry *out = first;
+  struct arange_index_entry *l, *l_end, *r, *r_end;
+  bfd_vma max_high_pc;
 
-  /* Sort so that low1 is below low2. */
-  if (low1 > low2)
+  if (left->length > idx->merge_alloc)
     {
-      bfd_vma tmp;
-
-      tmp = low1;
-      low1 = low2;
-      low2 = tmp;
-
-      tmp = high1;
-      high1 = high2;
-      high2 = tmp;
-    }
+      size_t alloc = left->length;
+      struct arange_index_entry *merge;
 
-  /* We touch iff low2 == high1.
-     We overlap iff low2 is within [low1, high1). */
-  return low2 <= high1;
+      merge = bfd_realloc (idx->merge, alloc * sizeof (*merge));
+      if (merge == NULL)
+	return false;
+      idx->merge = merge;
+      idx->merge_alloc = alloc;
+    }
+
+  /* Move the left run out of the way, then merge the two back into
+     place.  The output can never catch up with the unread part of the
+     right run.  */
+  memcpy (idx->merge, first, left->length * sizeof (*first));
+  l = idx->merge;
+  l_end = l + left->length;
+  r = idx->entries + right->start;
+  r_end = r + right->length;
+  while (l < l_end && r < r_end)
+    if (r->low_pc < l->low_pc)
+      out = arange_index_emit (first, out, r++);
+    else
+      out = arange_index_emit (first, out, l++);
+  while (l < l_end)
+    out = arange_index_emit (first, out, l++);
+  while (r < r_end)
+    out = arange_index_emit (first, out, r++);
+
+  max_high_pc = 0;
+  for (l = first; l < out; l++)
+    {
+      if (l->high_pc > max_high_pc)
+	max_high_pc = l->high_pc;
+      l->max_high_pc = max_high_pc;
+    }
+
+  left->length = out - first;
+  left->added += right->added;
+  idx->count = left->start + left->length;
+  idx->num_runs--;
+  return true;
 }
 
-/* Insert an address range in the trie mapping addresses to compilation units.
-   Will return the new trie node (usually the same as is being sent in, but
-   in case of a leaf-to-interior conversion, or expansion of a leaf, it may be
-   different), or NULL on failure.  */
+/* Record in IDX that the unit at UNIT_OFFSET in .debug_info contains
+   [LOW_PC, HIGH_PC).  */
 
-static struct trie_node *
-insert_arange_in_trie (bfd *abfd,
-		       struct trie_node *trie,
-		       bfd_vma trie_pc,
-		       unsigned int trie_pc_bits,
-		       struct comp_unit *unit,
-		       bfd_vma low_pc,
-		       bfd_vma high_pc)
+static bool
+arange_index_add (struct arange_index *idx, uint64_t unit_offset,
+		  bfd_vma low_pc, bfd_vma high_pc)
 {
-  bfd_vma clamped_low_pc, clamped_high_pc;
-  int ch, from_ch, to_ch;
-  bool is_full_leaf = false;
+  struct arange_index_entry *entry;
+  struct arange_index_run *run;
 
-  /* See if we can extend any of the existing ranges.  This merging
-     isn't perfect (if merging opens up the possibility of merging two existing
-     ranges, we won't find them), but it takes the majority of the cases.  */
-  if (trie->num_room_in_leaf > 0)
-    {
-      struct trie_leaf *leaf = (struct trie_leaf *) trie;
-      unsigned int i;
+  idx->idle_lookups = 0;
 
-      for (i = 0; i < leaf->num_stored_in_leaf; ++i)
+  /* Units often add ranges that follow on from the last one they added,
+     which can simply be extended.  */
+  if (idx->count != 0)
+    {
+      entry = &idx->entries[idx->count - 1];
+      if (entry->unit_offset == unit_offset
+	  && entry->low_pc <= low_pc
+	  && low_pc <= entry->high_pc)
 	{
-	  if (leaf->ranges[i].unit == unit
-	      && ranges_overlap (low_pc, high_pc,
-				 leaf->ranges[i].low_pc,
-				 leaf->ranges[i].high_pc))
-	    {
-	      if (low_pc < leaf->ranges[i].low_pc)
-		leaf->ranges[i].low_pc = low_pc;
-	      if (high_pc > leaf->ranges[i].high_pc)
-		leaf->ranges[i].high_pc = high_pc;
-	      return trie;
-	    }
+	  if (high_pc > entry->high_pc)
+	    entry->high_pc = high_pc;
+	  if (high_pc > entry->max_high_pc)
+	    entry->max_high_pc = high_pc;
+	  return true;
 	}
-
-      is_full_leaf = leaf->num_stored_in_leaf == trie->num_room_in_leaf;
     }
 
-  /* If we're a leaf with no more room and we're _not_ at the bottom,
-     convert to an interior node.  */
-  if (is_full_leaf && trie_pc_bits < VMA_BITS)
+  if (idx->count >= idx->alloc)
     {
-      const struct trie_leaf *leaf = (struct trie_leaf *) trie;
-      unsigned int i;
-
-      trie = bfd_zalloc (abfd, sizeof (struct trie_interior));
-      if (!trie)
-	return NULL;
-      is_full_leaf = false;
+      size_t alloc = idx->alloc * 2 + 64;
 
-      /* TODO: If we wanted to save a little more memory at the cost of
-	 complexity, we could have reused the old leaf node as one of the
-	 children of the new interior node, instead of throwing it away.  */
-      for (i = 0; i < leaf->num_stored_in_leaf; ++i)
-        {
-	  if (!insert_arange_in_trie (abfd, trie, trie_pc, trie_pc_bits,
-				      leaf->ranges[i].unit, leaf->ranges[i].low_pc,
-				      leaf->ranges[i].high_pc))
-	    return NULL;
-	}
+      entry = bfd_realloc (idx->entries, alloc * sizeof (*entry));
+      if (entry == NULL)
+	return false;
+      idx->entries = entry;
+      idx->alloc = alloc;
     }
 
-  /* If we're a leaf with no more room and we _are_ at the bottom,
-     we have no choice but to just make it larger. */
-  if (is_full_leaf)
-    {
-      const struct trie_leaf *leaf = (struct trie_leaf *) trie;
-      unsigned int new_room_in_leaf = trie->num_room_in_leaf * 2;
-      struct trie_leaf *new_leaf;
-      size_t amt = (sizeof (struct trie_leaf)
-		    + ((new_room_in_leaf - TRIE_LEAF_SIZE)
-		       * sizeof (leaf->ranges[0])));
-      new_leaf = bfd_zalloc (abfd, amt);
-      new_leaf->head.num_room_in_leaf = new_room_in_leaf;
-      new_leaf->num_stored_in_leaf = leaf->num_stored_in_leaf;
+  entry = &idx->entries[idx->count];
+  entry->low_pc = low_pc;
+  entry->high_pc = high_pc;
+  entry->max_high_pc = high_pc;
+  entry->unit_offset = unit_offset;
 
-      memcpy (new_leaf->ranges,
-	      leaf->ranges,
-	      leaf->num_stored_in_leaf * sizeof (leaf->ranges[0]));
-      trie = &new_leaf->head;
-      is_full_leaf = false;
+  run = &idx->runs[idx->num_runs++];
+  run->start = idx->count++;
+  run->length = 1;
+  run->added = 1;
 
-      /* Now the insert below will go through.  */
-    }
+  while (idx->num_runs > 1
+	 && (idx->runs[idx->num_runs - 2].added
+	     == idx->runs[idx->num_runs - 1].added))
+    if (!arange_index_merge_runs (idx))
+      return false;
+  return true;
+}
 
-  /* If we're a leaf (now with room), we can just insert at the end.  */
-  if (trie->num_room_in_leaf > 0)
-    {
-      struct trie_leaf *leaf = (struct trie_leaf *) trie;
+static int
+compare_unit_offsets (const void *a, const void *b)
+{
+  uint64_t offset1 = *(const uint64_t *) a;
+  uint64_t offset2 = *(const uint64_t *) b;
 
-      unsigned int i = leaf->num_stored_in_leaf++;
-      leaf->ranges[i].unit = unit;
-      leaf->ranges[i].low_pc = low_pc;
-      leaf->ranges[i].high_pc = high_pc;
-      return trie;
-    }
+  if (offset1 < offset2)
+    return -1;
+  if (offset1 > offset2)
+    return 1;
+  return 0;
+}
 
-  /* Now we are definitely an interior node, so recurse into all
-     the relevant buckets.  */
+/* Find the units that IDX says contain ADDR.  Store their offsets in
+   IDX->found, in the order the units appear in .debug_info, and their
+   number in *NUM_FOUND.  */
 
-  /* Clamp the range to the current trie bucket.  */
-  clamped_low_pc = low_pc;
-  clamped_high_pc = high_pc;
-  if (trie_pc_bits > 0)
-    {
-      bfd_vma bucket_high_pc =
-	trie_pc + ((bfd_vma) -1 >> trie_pc_bits);  /* Inclusive.  */
-      if (clamped_low_pc < trie_pc)
-	clamped_low_pc = trie_pc;
-      if (clamped_high_pc > bucket_high_pc)
-	clamped_high_pc = bucket_high_pc;
-    }
+static bool
+arange_index_lookup (struct arange_index *idx, bfd_vma addr,
+		     size_t *num_found)
+{
+  size_t n = 0;
+  unsigned int r;
+
+  /* When enough lookups have been made without adding ranges to pay
+     for it, merge all the runs so that later lookups search just one.
+     Failing that is not an error.  */
+  if (idx->num_runs > 1
+      && ++idx->idle_lookups > idx->count / 8)
+    while (idx->num_runs > 1)
+      if (!arange_index_merge_runs (idx))
+	break;
 
-  /* Insert the ranges in all buckets that it spans.  */
-  from_ch = (clamped_low_pc >> (VMA_BITS - trie_pc_bits - 8)) & 0xff;
-  to_ch = ((clamped_high_pc - 1) >> (VMA_BITS - trie_pc_bits - 8)) & 0xff;
-  for (ch = from_ch; ch <= to_ch; ++ch)
+  for (r = 0; r < idx->num_runs; r++)
     {
-      struct trie_interior *interior = (struct trie_interior *) trie;
-      struct trie_node *child = interior->children[ch];
+      const struct arange_index_entry *first
+	= idx->entries + idx->runs[r].start;
+      size_t lo = 0;
+      size_t hi = idx->runs[r].length;
 
-      if (child == NULL)
-        {
-	  child = alloc_trie_leaf (abfd);
-	  if (!child)
-	    return NULL;
+      /* Find the first entry starting above ADDR.  */
+      while (lo < hi)
+	{
+	  size_t mid = lo + (hi - lo) / 2;
+
+	  if (first[mid].low_pc <= addr)
+	    lo = mid + 1;
+	  else
+	    hi = mid;
 	}
-      bfd_vma bucket = (bfd_vma) ch << (VMA_BITS - trie_pc_bits - 8);
-      child = insert_arange_in_trie (abfd,
-				     child,
-				     trie_pc + bucket,
-				     trie_pc_bits + 8,
-				     unit,
-				     low_pc,
-				     high_pc);
-      if (!child)
-	return NULL;
 
-      interior->children[ch] = child;
+      while (lo-- > 0 && first[lo].max_high_pc > addr)
+	if (addr < first[lo].high_pc)
+	  {
+	    if (n >= idx->found_alloc)
+	      {
+		size_t alloc = idx->found_alloc * 2 + 16;
+		uint64_t *found;
+
+		found = bfd_realloc (idx->found, alloc * sizeof (*found));
+		if (found == NULL)
+		  return false;
+		idx->found = found;
+		idx->found_alloc = alloc;
+	      }
+	    idx->found[n++] = first[lo].unit_offset;
+	  }
+    }
+
+  if (n > 1)
+    {
+      size_t i, j;
+
+      qsort (idx->found, n, sizeof (*idx->found), compare_unit_offsets);
+      for (i = j = 1; i < n; i++)
+	if (idx->found[i] != idx->found[j - 1])
+	  idx->found[j++] = idx->found[i];
+      n = j;
     }
 
-    return trie;
+  *num_found = n;
+  return true;
+}
+
+static void
+arange_index_free (struct arange_index *idx)
+{
+  free (idx->entries);
+  free (idx->merge);
+  free (idx->found);
+  memset (idx, 0, sizeof (*idx));
 }
 
 static bool
 arange_add (struct comp_unit *unit, struct arange *first_arange,
-	    struct trie_node **trie_root, bfd_vma low_pc, bfd_vma high_pc)
+	    struct arange_index *idx, bfd_vma low_pc, bfd_vma high_pc)
 {
   struct arange *arange;
 
@@ -2292,18 +2364,11 @@ arange_add (struct comp_unit *unit, struct arange *first_arange,
   if (low_pc == high_pc)
     return true;
 
-  if (trie_root != NULL)
-    {
-      *trie_root = insert_arange_in_trie (unit->file->bfd_ptr,
-					  *trie_root,
-					  0,
-					  0,
-					  unit,
-					  low_pc,
-					  high_pc);
-      if (*trie_root == NULL)
-	return false;
-    }
+  if (idx != NULL
+      && !arange_index_add (idx,
+			    unit->info_ptr_unit - unit->file->dwarf_info_buffer,
+			    low_pc, high_pc))
+    return false;
 
   /* If the first arange is empty, use it.  */
   if (first_arange->high == 0)
@@ -2952,7 +3017,7 @@ decode_line_info (struct comp_unit *unit)
 		    low_pc = address;
 		  if (address > high_pc)
 		    high_pc = address;
-		  if (!arange_add (unit, &unit->arange, &unit->file->trie_root,
+		  if (!arange_add (unit, &unit->arange, &unit->file->unit_index,
 				   low_pc, high_pc))
 		    goto line_fail;
 		  break;
@@ -3657,7 +3722,7 @@ find_abstract_instance (struct comp_unit *unit,
 
 static bool
 read_ranges (struct comp_unit *unit, struct arange *arange,
-	     struct trie_node **trie_root, uint64_t offset)
+	     struct arange_index *idx, uint64_t offset)
 {
   bfd_byte *ranges_ptr;
   bfd_byte *ranges_end;
@@ -3692,7 +3757,7 @@ read_ranges (struct comp_unit *unit, struct arange *arange,
 	base_address = high_pc;
       else
 	{
-	  if (!arange_add (unit, arange, trie_root,
+	  if (!arange_add (unit, arange, idx,
 			   base_address + low_pc, base_address + high_pc))
 	    return false;
 	}
@@ -3702,7 +3767,7 @@ read_ranges (struct comp_unit *unit, struct arange *arange,
 
 static bool
 read_rnglists (struct comp_unit *unit, struct arange *arange,
-	       struct trie_node **trie_root, uint64_t offset)
+	       struct arange_index *idx, uint64_t offset)
 {
   bfd_byte *rngs_ptr;
   bfd_byte *rngs_end;
@@ -3776,19 +3841,19 @@ read_rnglists (struct comp_unit *unit, struct arange *arange,
 	  return false;
 	}
 
-      if (!arange_add (unit, arange, trie_root, low_pc, high_pc))
+      if (!arange_add (unit, arange, idx, low_pc, high_pc))
 	return false;
     }
 }
 
 static bool
 read_rangelist (struct comp_unit *unit, struct arange *arange,
-		struct trie_node **trie_root, uint64_t offset)
+		struct arange_index *idx, uint64_t offset)
 {
   if (unit->version <= 4)
-    return read_ranges (unit, arange, trie_root, offset);
+    return read_ranges (unit, arange, idx, offset);
   else
-    return read_rnglists (unit, arange, trie_root, offset);
+    return read_rnglists (unit, arange, idx, offset);
 }
 
 static struct funcinfo *
@@ -4141,7 +4206,7 @@ scan_unit_for_symbols (struct comp_unit *unit)
 		case DW_AT_ranges:
 		  if (is_int_form (&attr)
 		      && !read_rangelist (unit, &func->arange,
-					  &unit->file->trie_root, attr.u.val))
+					  &unit->file->unit_index, attr.u.val))
 		    goto fail;
 		  break;
 
@@ -4255,7 +4320,7 @@ scan_unit_for_symbols (struct comp_unit *unit)
 
       if (func && high_pc != 0)
 	{
-	  if (!arange_add (unit, &func->arange, &unit->file->trie_root,
+	  if (!arange_add (unit, &func->arange, &unit->file->unit_index,
 			   low_pc, high_pc))
 	    goto fail;
 	}
@@ -4312,7 +4377,7 @@ reread_attribute (struct comp_unit *unit,
 
     case DW_AT_ranges:
       if (!read_rangelist (unit, &unit->arange,
-			   &unit->file->trie_root, attr->u.val))
+			   &unit->file->unit_index, attr->u.val))
 	return;
       break;
 
@@ -4489,6 +4554,7 @@ parse_comp_unit (struct dwarf2_debug *stash,
     return NULL;
   unit->abfd = abfd;
   unit->version = version;
+  unit->unit_type = unit_type;
   unit->addr_size = addr_size;
   unit->offset_size = offset_size;
   unit->abbrevs = abbrevs;
@@ -4565,7 +4631,7 @@ parse_comp_unit (struct dwarf2_debug *stash,
 	case DW_AT_ranges:
 	  if (is_int_form (&attr)
 	      && !read_rangelist (unit, &unit->arange,
-				  &unit->file->trie_root, attr.u.val))
+				  &unit->file->unit_index, attr.u.val))
 	    goto err_exit;
 	  break;
 
@@ -4620,7 +4686,7 @@ parse_comp_unit (struct dwarf2_debug *stash,
     high_pc += low_pc;
   if (high_pc != 0)
     {
-      if (!arange_add (unit, &unit->arange, &unit->file->trie_root,
+      if (!arange_add (unit, &unit->arange, &unit->file->unit_index,
 		       low_pc, high_pc))
 	goto err_exit;
     }
@@ -5417,14 +5483,6 @@ _bfd_dwarf2_slurp_debug_info (bfd *abfd, bfd *debug_bfd,
   if (!stash->alt.abbrev_offsets)
     return false;
 
-  stash->f.trie_root = alloc_trie_leaf (abfd);
-  if (!stash->f.trie_root)
-    return false;
-
-  stash->alt.trie_root = alloc_trie_leaf (abfd);
-  if (!stash->alt.trie_root)
-    return false;
-
   if (debug_bfd == NULL)
     debug_bfd = abfd;
 
@@ -5604,6 +5662,21 @@ stash_comp_unit (struct dwarf2_debug *stash, struct dwarf2_debug_file *file)
 	  splay_tree_insert (file->comp_unit_tree, (splay_tree_key)r,
 			     (splay_tree_value)each);
 
+	  if (file->num_units >= file->units_alloc)
+	    {
+	      size_t alloc = file->units_alloc * 2 + 64;
+	      struct comp_unit **units;
+
+	      units = bfd_realloc (file->units, alloc * sizeof (*units));
+	      if (units != NULL)
+		{
+		  file->units = units;
+		  file->units_alloc = alloc;
+		}
+	    }
+	  if (file->num_units < file->units_alloc)
+	    file->units[file->num_units++] = each;
+
 	  if (file->all_comp_units)
 	    file->all_comp_units->prev_unit = each;
 	  else
@@ -5629,6 +5702,232 @@ stash_comp_unit (struct dwarf2_debug *stash, struct dwarf2_debug_file *file)
   return NULL;
 }
 
+/* Read the .debug_aranges section of FILE, if it has one, into
+   FILE->aranges_index.  .debug_aranges lets us go straight to the unit
+   that covers an address, without reading all the units before it and
+   decoding their line tables to find out that they do not.  */
+
+static void
+read_debug_aranges (struct dwarf2_debug *stash,
+		    struct dwarf2_debug_file *file)
+{
+  const struct dwarf_debug_section *sec
+    = &stash->debug_sections[debug_aranges];
+  bfd *abfd = file->bfd_ptr;
+  asection *msec;
+  bfd_byte *buffer = NULL;
+  bfd_size_type size;
+  bfd_byte *ptr, *end;
+
+  file->aranges_read = true;
+
+  /* The section gives addresses as they are in the file, and offsets
+     into a single .debug_info section.  */
+  if ((stash->orig_bfd->flags & (EXEC_P | DYNAMIC)) == 0)
+    return;
+  msec = find_debug_info (abfd, stash->debug_sections, NULL);
+  if (msec == NULL
+      || find_debug_info (abfd, stash->debug_sections, msec) != NULL)
+    return;
+  if (bfd_get_section_by_name (abfd, sec->uncompressed_name) == NULL
+      && bfd_get_section_by_name (abfd, sec->compressed_name) == NULL)
+    return;
+
+  if (!read_section (abfd, sec, file->syms, 0, &buffer, &size))
+    return;
+
+  ptr = buffer;
+  end = buffer + size;
+  while ((size_t) (end - ptr) >= 4)
+    {
+      bfd_byte *set = ptr;
+      bfd_byte *set_end;
+      uint64_t length, unit_offset;
+      unsigned int offset_size = 4;
+      unsigned int version, addr_size, seg_size, tuple_size;
+
+      length = read_4_bytes (abfd, &ptr, end);
+      if (length == 0xffffffff)
+	{
+	  offset_size = 8;
+	  length = read_8_bytes (abfd, &ptr, end);
+	}
+      if (length == 0 || length > (size_t) (end - ptr))
+	break;
+      set_end = ptr + length;
+
+      version = read_2_bytes (abfd, &ptr, set_end);
+      if (offset_size == 4)
+	unit_offset = read_4_bytes (abfd, &ptr, set_end);
+      else
+	unit_offset = read_8_bytes (abfd, &ptr, set_end);
+      addr_size = read_1_byte (abfd, &ptr, set_end);
+      seg_size = read_1_byte (abfd, &ptr, set_end);
+      if (version != 2
+	  || seg_size != 0
+	  || (addr_size != 2 && addr_size != 4 && addr_size != 8)
+	  || unit_offset >= file->dwarf_info_size)
+	{
+	  ptr = set_end;
+	  continue;
+	}
+
+      /* The address and length pairs are aligned to their size from the
+	 start of the set.  */
+      tuple_size = 2 * addr_size;
+      ptr = set + (ptr - set + tuple_size - 1) / tuple_size * tuple_size;
+      while (ptr < set_end && (size_t) (set_end - ptr) >= tuple_size)
+	{
+	  bfd_vma low_pc = read_address_1 (abfd, addr_size, &ptr, set_end);
+	  bfd_vma length_pc = read_address_1 (abfd, addr_size, &ptr, set_end);
+
+	  if (low_pc == 0 && length_pc == 0)
+	    break;
+	  if (length_pc == 0)
+	    continue;
+	  if (!arange_index_add (&file->aranges_index, unit_offset,
+				 low_pc, low_pc + length_pc))
+	    goto fail;
+	}
+      ptr = set_end;
+    }
+
+  free (buffer);
+  return;
+
+ fail:
+  /* Carry on without .debug_aranges.  */
+  arange_index_free (&file->aranges_index);
+  free (buffer);
+}
+
+/* Return the unit already read from FILE that starts at OFFSET in
+   .debug_info, or NULL.  */
+
+static struct comp_unit *
+find_comp_unit_at (struct dwarf2_debug_file *file, uint64_t offset)
+{
+  struct addr_range range;
+  splay_tree_node v;
+  struct comp_unit *unit;
+  size_t lo, hi;
+
+  if (file->comp_unit_tree == NULL || offset >= file->dwarf_info_size)
+    return NULL;
+
+  range.start = file->dwarf_info_buffer + offset;
+  range.end = range.start + 1;
+
+  lo = 0;
+  hi = file->num_units;
+  while (lo < hi)
+    {
+      size_t mid = lo + (hi - lo) / 2;
+
+      unit = file->units[mid];
+      if (unit->info_ptr_unit == range.start)
+	return unit;
+      if (unit->info_ptr_unit < range.start)
+	lo = mid + 1;
+      else
+	hi = mid;
+    }
+
+  /* FILE->units may lack a unit if memory ran out.  */
+  v = splay_tree_lookup (file->comp_unit_tree, (splay_tree_key) &range);
+  if (v == NULL)
+    return NULL;
+  unit = (struct comp_unit *) v->value;
+  return unit->info_ptr_unit == range.start ? unit : NULL;
+}
+
+/* Look for ADDR in the units of STASH that are known to cover it:
+   first those read so far whose ranges contain it, and then those
+   that .debug_aranges says contain it.  Units are read as far as
+   needed to reach the latter, and the units read on the way are
+   checked for ADDR as well, just as
+   _bfd_dwarf2_find_nearest_line_with_alt checks the units it reads.
+   Return as comp_unit_find_nearest_line does.  */
+
+static int
+find_nearest_line_in_index (struct dwarf2_debug *stash,
+			    bfd_vma addr,
+			    const char **filename_ptr,
+			    struct funcinfo **function_ptr,
+			    unsigned int *linenumber_ptr,
+			    unsigned int *discriminator_ptr)
+{
+  struct dwarf2_debug_file *file = &stash->f;
+  struct comp_unit *unit;
+  size_t num_tried, num_found, i;
+  int found;
+
+  if (!file->aranges_read)
+    read_debug_aranges (stash, file);
+
+  if (!arange_index_lookup (&file->unit_index, addr, &num_tried))
+    return false;
+  for (i = 0; i < num_tried; i++)
+    {
+      unit = find_comp_unit_at (file, file->unit_index.found[i]);
+      if (unit == NULL)
+	continue;
+      found = comp_unit_find_nearest_line (unit, addr, filename_ptr,
+					   function_ptr, linenumber_ptr,
+					   discriminator_ptr);
+      if (found)
+	return found;
+    }
+
+  if (file->aranges_index.count == 0
+      || !arange_index_lookup (&file->aranges_index, addr, &num_found))
+    return false;
+  for (i = 0; i < num_found; i++)
+    {
+      uint64_t offset = file->aranges_index.found[i];
+
+      if (bsearch (&offset, file->unit_index.found, num_tried,
+		   sizeof (offset), compare_unit_offsets) != NULL)
+	continue;
+
+      unit = NULL;
+      while (offset >= (uint64_t) (file->info_ptr - file->dwarf_info_buffer))
+	{
+	  struct comp_unit *each = stash_comp_unit (stash, file);
+
+	  if (each == NULL)
+	    break;
+	  if ((uint64_t) (each->info_ptr_unit - file->dwarf_info_buffer)
+		  == offset)
+	    {
+	      unit = each;
+	      break;
+	    }
+	  if (comp_unit_may_contain_address (each, addr))
+	    {
+	      found = comp_unit_find_nearest_line (each, addr, filename_ptr,
+						   function_ptr,
+						   linenumber_ptr,
+						   discriminator_ptr);
+	      if (found)
+		return found;
+	    }
+	}
+      if (unit == NULL)
+	unit = find_comp_unit_at (file, offset);
+      if (unit == NULL)
+	continue;
+
+      found = comp_unit_find_nearest_line (unit, addr, filename_ptr,
+					   function_ptr, linenumber_ptr,
+					   discriminator_ptr);
+      if (found)
+	return found;
+    }
+
+  return false;
+}
+
 /* Hash function for an asymbol.  */
 
 static hashval_t
@@ -5709,78 +6008,1172 @@ _bfd_dwarf2_find_symbol_bias (asymbol ** symbols, void ** pinfo)
   return result;
 }
 
-/* See _bfd_dwarf2_find_nearest_line_with_alt.  */
+/* The line number cache.  The line number and function tables that are
+   built for all the compilation units of an executable or shared library
+   with a build-id can be kept in a file (see bfd_set_line_cache_dir).
+   A later process that looks up addresses in the same executable maps
+   that file instead of reading the DWARF.  The file holds a header and
+   then the arrays below, in the byte order of the host.  */
 
-int
-_bfd_dwarf2_find_nearest_line (bfd *abfd,
-			       asymbol **symbols,
-			       asymbol *symbol,
-			       asection *section,
-			       bfd_vma offset,
-			       const char **filename_ptr,
-			       const char **functionname_ptr,
-			       unsigned int *linenumber_ptr,
-			       unsigned int *discriminator_ptr,
-			       const struct dwarf_debug_section *debug_sections,
-			       void **pinfo)
+struct line_cache_header
 {
-  return _bfd_dwarf2_find_nearest_line_with_alt
-    (abfd, NULL, symbols, symbol, section, offset, filename_ptr,
-     functionname_ptr, linenumber_ptr, discriminator_ptr, debug_sections,
-     pinfo);
-}
+  char magic[8];
+  uint32_t byte_order;
+  uint32_t version;
+  /* What the cache was built from, since the build-id does not change
+     when the executable is relocated by objcopy --change-addresses or
+     prelink: the size of .debug_info, and a hash of the names,
+     addresses and sizes of the sections of the executable.  */
+  uint64_t info_size;
+  uint64_t layout;
+  uint64_t nranges;
+  uint64_t nunits;
+  uint64_t nseqs;
+  uint64_t nrows;
+  uint64_t nfuncs;
+  uint64_t nfranges;
+  uint64_t string_size;
+};
 
-/* Find the source code location of SYMBOL.  If SYMBOL is NULL
-   then find the nearest source code location corresponding to
-   the address SECTION + OFFSET.
-   Returns 1 if the line is found without error and fills in
-   FILENAME_PTR and LINENUMBER_PTR.  In the case where SYMBOL was
-   NULL the FUNCTIONNAME_PTR is also filled in.
-   Returns 2 if partial information from _bfd_elf_find_function is
-   returned (function and maybe file) by looking at symbols.  DWARF2
-   info is present but not regarding the requested code location.
-   Returns 0 otherwise.
-   SYMBOLS contains the symbol table for ABFD.
-   DEBUG_SECTIONS contains the name of the dwarf debug sections.
-   If ALT_FILENAME is given, attempt to open the file and use it
-   as the .gnu_debugaltlink file. Otherwise this file will be
-   searched for when needed.  */
+#define LINE_CACHE_MAGIC "bfdlines"
+#define LINE_CACHE_BYTE_ORDER 0x01020304
+#define LINE_CACHE_VERSION 3
 
-int
-_bfd_dwarf2_find_nearest_line_with_alt
-  (bfd *abfd,
-   const char *alt_filename,
-   asymbol **symbols,
-   asymbol *symbol,
-   asection *section,
-   bfd_vma offset,
-   const char **filename_ptr,
-   const char **functionname_ptr,
-   unsigned int *linenumber_ptr,
-   unsigned int *discriminator_ptr,
-   const struct dwarf_debug_section *debug_sections,
-   void **pinfo)
+/* An address range of a unit, covering its own ranges and those of its
+   functions.  The ranges of one unit do not overlap, and they are all
+   sorted by LOW.  TOP is the highest HIGH of this and all earlier
+   ranges.  */
+
+struct line_cache_range
 {
-  /* Read each compilation unit from the section .debug_info, and check
-     to see if it contains the address we are searching for.  If yes,
-     lookup the address, and return the line number info.  If no, go
-     on to the next compilation unit.
+  uint64_t low;
+  uint64_t high;
+  uint64_t top;
+  uint64_t unit;
+};
 
-     We keep a list of all the previously read compilation units, and
-     a pointer to the next un-read compilation unit.  Check the
-     previously read units before reading more.  */
-  struct dwarf2_debug *stash;
-  /* What address are we looking for?  */
-  bfd_vma addr;
-  struct comp_unit* each;
-  struct funcinfo *function = NULL;
-  int found = false;
-  bool do_line;
+/* A compilation unit, as its sequences and functions.  */
 
-  *filename_ptr = NULL;
-  if (functionname_ptr != NULL)
-    *functionname_ptr = NULL;
-  *linenumber_ptr = 0;
+struct line_cache_unit
+{
+  uint64_t first_seq;
+  uint64_t nseqs;
+  uint64_t first_func;
+  uint64_t nfuncs;
+};
+
+/* A line sequence as left by sort_line_sequences, with its rows as built
+   by build_line_info_table.  HIGH is the address of the last row.  */
+
+struct line_cache_seq
+{
+  uint64_t low;
+  uint64_t high;
+  uint64_t first_row;
+  uint64_t nrows;
+};
+
+/* A row of a line sequence.  FILE is an offset into the strings, where
+   zero stands for NULL.  */
+
+struct line_cache_row
+{
+  uint64_t address;
+  uint32_t file;
+  uint32_t line;
+  uint32_t discriminator;
+  uint32_t end_sequence;
+};
+
+/* A function of a unit.  The functions of a unit are in the order of its
+   lookup_funcinfo_table, and LOW, HIGH and IDX are as there.  CALLER is
+   the index in the cache of the function's caller_func, or -1.  NAME and
+   CALLER_FILE are offsets into the strings.  */
+
+struct line_cache_func
+{
+  uint64_t low;
+  uint64_t high;
+  uint64_t first_range;
+  uint64_t nranges;
+  uint64_t caller;
+  uint64_t idx;
+  uint32_t name;
+  uint32_t caller_file;
+  int32_t caller_line;
+  int32_t tag;
+  uint32_t is_linkage;
+  uint32_t pad;
+};
+
+/* An address range of a function.  */
+
+struct line_cache_frange
+{
+  uint64_t low;
+  uint64_t high;
+};
+
+/* A line number cache in use.  */
+
+struct line_cache
+{
+  /* The contents of the cache file.  If MAP_LEN is not zero they are
+     mapped at MAP_ADDR, otherwise they are malloc'd.  */
+  void *data;
+  void *map_addr;
+  size_t map_len;
+
+  const struct line_cache_header *header;
+  const struct line_cache_range *ranges;
+  const struct line_cache_unit *units;
+  const struct line_cache_seq *seqs;
+  const struct line_cache_row *rows;
+  const struct line_cache_func *funcs;
+  const struct line_cache_frange *franges;
+  const char *strings;
+
+  /* The funcinfos made so far for the functions in FUNCS.  */
+  struct funcinfo **funcinfos;
+
+  /* The units found by line_cache_find_nearest_line, kept between
+     lookups.  */
+  uint64_t *found_units;
+  size_t found_units_alloc;
+};
+
+/* Point the arrays of CACHE into its DATA, of SIZE bytes, and check
+   them.  Return FALSE if they are not valid.  */
+
+static bool
+line_cache_init (struct line_cache *cache, size_t size)
+{
+  const struct line_cache_header *header = cache->data;
+  const char *p;
+  uint64_t i, limit;
+
+  if (size < sizeof (*header)
+      || memcmp (header->magic, LINE_CACHE_MAGIC, sizeof header->magic) != 0
+      || header->byte_order != LINE_CACHE_BYTE_ORDER
+      || header->version != LINE_CACHE_VERSION)
+    return false;
+
+  limit = size;
+  if (header->nranges > limit / sizeof (*cache->ranges)
+      || header->nunits > limit / sizeof (*cache->units)
+      || header->nseqs > limit / sizeof (*cache->seqs)
+      || header->nrows > limit / sizeof (*cache->rows)
+      || header->nfuncs > limit / sizeof (*cache->funcs)
+      || header->nfranges > limit / sizeof (*cache->franges)
+      || header->string_size == 0
+      || header->string_size > limit
+      || limit != (sizeof (*header)
+		   + header->nranges * sizeof (*cache->ranges)
+		   + header->nunits * sizeof (*cache->units)
+		   + header->nseqs * sizeof (*cache->seqs)
+		   + header->nrows * sizeof (*cache->rows)
+		   + header->nfuncs * sizeof (*cache->funcs)
+		   + header->nfranges * sizeof (*cache->franges)
+		   + header->string_size))
+    return false;
+
+  p = (const char *) (header + 1);
+  cache->header = header;
+  cache->ranges = (const struct line_cache_range *) p;
+  p += header->nranges * sizeof (*cache->ranges);
+  cache->units = (const struct line_cache_unit *) p;
+  p += header->nunits * sizeof (*cache->units);
+  cache->seqs = (const struct line_cache_seq *) p;
+  p += header->nseqs * sizeof (*cache->seqs);
+  cache->rows = (const struct line_cache_row *) p;
+  p += header->nrows * sizeof (*cache->rows);
+  cache->funcs = (const struct line_cache_func *) p;
+  p += header->nfuncs * sizeof (*cache->funcs);
+  cache->franges = (const struct line_cache_frange *) p;
+  p += header->nfranges * sizeof (*cache->franges);
+  cache->strings = p;
+  if (cache->strings[header->string_size - 1] != '\0')
+    return false;
+
+  /* The rest is checked as it is used.  */
+  for (i = 0; i < header->nunits; i++)
+    if (cache->units[i].first_seq > header->nseqs
+	|| cache->units[i].nseqs > header->nseqs - cache->units[i].first_seq
+	|| cache->units[i].first_func > header->nfuncs
+	|| (cache->units[i].nfuncs
+	    > header->nfuncs - cache->units[i].first_func))
+      return false;
+  for (i = 0; i < header->nranges; i++)
+    if (cache->ranges[i].unit >= header->nunits)
+      return false;
+
+  if (header->nfuncs != 0)
+    {
+      cache->funcinfos = bfd_zmalloc (header->nfuncs
+				      * sizeof (*cache->funcinfos));
+      if (cache->funcinfos == NULL)
+	return false;
+    }
+  return true;
+}
+
+/* Free CACHE.  */
+
+static void
+line_cache_free (struct line_cache *cache)
+{
+  if (cache == NULL)
+    return;
+#ifdef HAVE_MMAP
+  if (cache->map_len != 0)
+    munmap (cache->map_addr, cache->map_len);
+  else
+#endif
+    free (cache->data);
+  free (cache->funcinfos);
+  free (cache->found_units);
+  free (cache);
+}
+
+/* Return the name of the cache file for ABFD in DIR, or NULL.  */
+
+static char *
+line_cache_file (bfd *abfd, const char *dir)
+{
+  const struct bfd_build_id *build_id = abfd->build_id;
+  size_t dirlen = strlen (dir);
+  unsigned int i;
+  char *name, *p;
+
+  name = bfd_malloc (dirlen + 1 + build_id->size * 2 + sizeof ".lines");
+  if (name == NULL)
+    return NULL;
+  memcpy (name, dir, dirlen);
+  p = name + dirlen;
+  *p++ = '/';
+  for (i = 0; i < build_id->size; i++)
+    p += sprintf (p, "%02x", build_id->data[i]);
+  strcpy (p, ".lines");
+  return name;
+}
+
+/* Return a hash of the layout of ABFD, for the layout field of a
+   line_cache_header.  iterative_hash gives 32 bits, so the field is
+   filled from two hashes of the layout started from different seeds.  */
+
+static uint64_t
+line_cache_layout (bfd *abfd)
+{
+  hashval_t hash[2] = { 0, 0x9e3779b9 };
+  uint64_t val;
+  asection *sec;
+  int i;
+
+  for (i = 0; i < 2; i++)
+    {
+      val = bfd_get_start_address (abfd);
+      hash[i] = iterative_hash_object (val, hash[i]);
+      for (sec = abfd->sections; sec != NULL; sec = sec->next)
+	{
+	  hash[i] = iterative_hash (sec->name, strlen (sec->name), hash[i]);
+	  val = sec->vma;
+	  hash[i] = iterative_hash_object (val, hash[i]);
+	  val = sec->size;
+	  hash[i] = iterative_hash_object (val, hash[i]);
+	}
+    }
+  return ((uint64_t) hash[1] << 32) | hash[0];
+}
+
+/* Read the cache file NAME, or return NULL if it cannot be read, is
+   not valid, or was not built from debug info of INFO_SIZE bytes for
+   an executable with LAYOUT.  */
+
+static struct line_cache *
+line_cache_load (const char *name, uint64_t info_size, uint64_t layout)
+{
+  struct line_cache *cache;
+  struct stat st;
+  FILE *f;
+
+  f = _bfd_real_fopen (name, FOPEN_RB);
+  if (f == NULL)
+    return NULL;
+  cache = bfd_zmalloc (sizeof (*cache));
+  if (cache == NULL
+      || fstat (fileno (f), &st) != 0
+      || st.st_size <= 0
+      || (uint64_t) st.st_size != (size_t) st.st_size)
+    goto fail;
+
+#ifdef HAVE_MMAP
+  cache->map_addr = mmap (NULL, st.st_size, PROT_READ, MAP_PRIVATE,
+			  fileno (f), 0);
+  if (cache->map_addr != MAP_FAILED)
+    {
+      cache->map_len = st.st_size;
+      cache->data = cache->map_addr;
+    }
+  else
+#endif
+    {
+      cache->data = bfd_malloc (st.st_size);
+      if (cache->data == NULL
+	  || fread (cache->data, 1, st.st_size, f) != (size_t) st.st_size)
+	goto fail;
+    }
+
+  if (!line_cache_init (cache, st.st_size)
+      || cache->header->info_size != info_size
+      || cache->header->layout != layout)
+    goto fail;
+  fclose (f);
+  return cache;
+
+ fail:
+  fclose (f);
+  line_cache_free (cache);
+  return NULL;
+}
+
+/* The tables of a line number cache being built.  */
+
+struct line_cache_builder
+{
+  struct line_cache_range *ranges;
+  size_t nranges, ranges_alloc;
+  struct line_cache_unit *units;
+  size_t nunits, units_alloc;
+  struct line_cache_seq *seqs;
+  size_t nseqs, seqs_alloc;
+  struct line_cache_row *rows;
+  size_t nrows, rows_alloc;
+  struct line_cache_func *funcs;
+  size_t nfuncs, funcs_alloc;
+  struct line_cache_frange *franges;
+  size_t nfranges, franges_alloc;
+  char *strings;
+  size_t string_size, strings_alloc;
+
+  /* The caller_func of each function in FUNCS, until they are turned
+     into indices.  */
+  struct funcinfo **callers;
+  size_t callers_alloc;
+  /* Maps each funcinfo to its index in FUNCS.  */
+  htab_t func_htab;
+  /* Maps each string to its offset in STRINGS.  */
+  htab_t string_htab;
+  /* The string last added, and its offset.  */
+  const char *last_string;
+  uint32_t last_string_offset;
+};
+
+/* Make room for one more element of SIZE bytes in ARRAY, which has
+   *ALLOC elements of which N are used.  Return the array, or NULL if
+   it had to be grown and could not be, in which case it is freed.  */
+
+static void *
+line_cache_grow (void *array, size_t *alloc, size_t n, size_t size)
+{
+  if (n < *alloc)
+    return array;
+  *alloc = *alloc ? *alloc * 2 : 64;
+  return bfd_realloc_or_free (array, *alloc * size);
+}
+
+/* An entry of the string_htab of a line_cache_builder.  */
+
+struct line_cache_string
+{
+  const char *str;
+  uint32_t offset;
+};
+
+static hashval_t
+hash_line_cache_string (const void *p)
+{
+  return htab_hash_string (((const struct line_cache_string *) p)->str);
+}
+
+static int
+eq_line_cache_string (const void *a, const void *b)
+{
+  return strcmp (((const struct line_cache_string *) a)->str,
+		 ((const struct line_cache_string *) b)->str) == 0;
+}
+
+/* An entry of the func_htab of a line_cache_builder.  */
+
+struct line_cache_func_index
+{
+  const struct funcinfo *func;
+  uint64_t index;
+};
+
+static hashval_t
+hash_line_cache_func (const void *p)
+{
+  return htab_hash_pointer (((const struct line_cache_func_index *) p)->func);
+}
+
+static int
+eq_line_cache_func (const void *a, const void *b)
+{
+  return (((const struct line_cache_func_index *) a)->func
+	  == ((const struct line_cache_func_index *) b)->func);
+}
+
+/* Add STR to the strings of B, and store its offset in *OFFSET.  */
+
+static bool
+line_cache_add_string (struct line_cache_builder *b, const char *str,
+		       uint32_t *offset)
+{
+  struct line_cache_string search, *entry;
+  void **slot;
+  size_t len;
+
+  if (str == NULL)
+    {
+      *offset = 0;
+      return true;
+    }
+  if (str == b->last_string)
+    {
+      *offset = b->last_string_offset;
+      return true;
+    }
+
+  search.str = str;
+  slot = htab_find_slot (b->string_htab, &search, INSERT);
+  if (slot == NULL)
+    return false;
+  if (*slot == NULL)
+    {
+      len = strlen (str) + 1;
+      if (b->string_size + len > (uint32_t) -1)
+	return false;
+      while (b->string_size + len > b->strings_alloc)
+	{
+	  b->strings_alloc = b->strings_alloc ? b->strings_alloc * 2 : 4096;
+	  b->strings = bfd_realloc_or_free (b->strings, b->strings_alloc);
+	  if (b->strings == NULL)
+	    return false;
+	}
+      entry = bfd_malloc (sizeof (*entry));
+      if (entry == NULL)
+	return false;
+      entry->str = str;
+      entry->offset = b->string_size;
+      memcpy (b->strings + b->string_size, str, len);
+      b->string_size += len;
+      *slot = entry;
+    }
+  entry = (struct line_cache_string *) *slot;
+  b->last_string = str;
+  b->last_string_offset = entry->offset;
+  *offset = entry->offset;
+  return true;
+}
+
+/* Add the range LOW to HIGH of unit UNIT to B.  */
+
+static bool
+line_cache_add_range (struct line_cache_builder *b, bfd_vma low,
+		      bfd_vma high, size_t unit)
+{
+  struct line_cache_range *r;
+
+  if (low >= high)
+    return true;
+  b->ranges = line_cache_grow (b->ranges, &b->ranges_alloc, b->nranges,
+			       sizeof (*b->ranges));
+  if (b->ranges == NULL)
+    return false;
+  r = &b->ranges[b->nranges++];
+  r->low = low;
+  r->high = high;
+  r->top = high;
+  r->unit = unit;
+  return true;
+}
+
+static int
+compare_line_cache_ranges (const void *a, const void *b)
+{
+  const struct line_cache_range *r1 = a;
+  const struct line_cache_range *r2 = b;
+
+  if (r1->low != r2->low)
+    return r1->low < r2->low ? -1 : 1;
+  if (r1->unit != r2->unit)
+    return r1->unit < r2->unit ? -1 : 1;
+  if (r1->high != r2->high)
+    return r1->high < r2->high ? -1 : 1;
+  return 0;
+}
+
+/* Add the sequences and functions of UNIT to B as unit number INDEX,
+   along with its address ranges.  */
+
+static bool
+line_cache_add_unit (struct line_cache_builder *b, struct comp_unit *unit,
+		     size_t index)
+{
+  struct line_cache_unit *u;
+  size_t first_range = b->nranges;
+  size_t i, j;
+
+  b->units = line_cache_grow (b->units, &b->units_alloc, b->nunits,
+			      sizeof (*b->units));
+  if (b->units == NULL)
+    return false;
+  u = &b->units[b->nunits++];
+  u->first_seq = b->nseqs;
+  u->nseqs = 0;
+  u->first_func = b->nfuncs;
+  u->nfuncs = 0;
+
+  /* A unit that cannot be decoded is never found, as in
+     comp_unit_find_nearest_line.  */
+  if (!comp_unit_maybe_decode_line_info (unit)
+      || !build_lookup_funcinfo_table (unit))
+    return true;
+
+  for (i = 0; i < unit->line_table->num_sequences; i++)
+    {
+      struct line_sequence *seq = &unit->line_table->sequences[i];
+      struct line_cache_seq *s;
+
+      if (!build_line_info_table (unit->line_table, seq))
+	return false;
+      b->seqs = line_cache_grow (b->seqs, &b->seqs_alloc, b->nseqs,
+				 sizeof (*b->seqs));
+      if (b->seqs == NULL)
+	return false;
+      s = &b->seqs[b->nseqs++];
+      s->low = seq->low_pc;
+      s->high = seq->last_line->address;
+      s->first_row = b->nrows;
+      s->nrows = seq->num_lines;
+      for (j = 0; j < seq->num_lines; j++)
+	{
+	  struct line_info *info = seq->line_info_lookup[j];
+	  struct line_cache_row *r;
+
+	  b->rows = line_cache_grow (b->rows, &b->rows_alloc, b->nrows,
+				     sizeof (*b->rows));
+	  if (b->rows == NULL)
+	    return false;
+	  r = &b->rows[b->nrows++];
+	  r->address = info->address;
+	  if (!line_cache_add_string (b, info->filename, &r->file))
+	    return false;
+	  r->line = info->line;
+	  r->discriminator = info->discriminator;
+	  r->end_sequence = info->end_sequence;
+	}
+      u->nseqs++;
+    }
+
+  for (i = 0; i < unit->number_of_functions; i++)
+    {
+      struct lookup_funcinfo *lookup = &unit->lookup_funcinfo_table[i];
+      struct funcinfo *func = lookup->funcinfo;
+      struct line_cache_func_index *entry;
+      struct line_cache_func *f;
+      struct arange *arange;
+      void **slot;
+
+      b->funcs = line_cache_grow (b->funcs, &b->funcs_alloc, b->nfuncs,
+				  sizeof (*b->funcs));
+      if (b->funcs == NULL)
+	return false;
+      b->callers = line_cache_grow (b->callers, &b->callers_alloc, b->nfuncs,
+				    sizeof (*b->callers));
+      if (b->callers == NULL)
+	return false;
+      entry = bfd_malloc (sizeof (*entry));
+      if (entry == NULL)
+	return false;
+      entry->func = func;
+      entry->index = b->nfuncs;
+      slot = htab_find_slot (b->func_htab, entry, INSERT);
+      if (slot == NULL)
+	{
+	  free (entry);
+	  return false;
+	}
+      free (*slot);
+      *slot = entry;
+
+      b->callers[b->nfuncs] = func->caller_func;
+      f = &b->funcs[b->nfuncs++];
+      memset (f, 0, sizeof (*f));
+      f->low = lookup->low_addr;
+      f->high = lookup->high_addr;
+      f->idx = lookup->idx;
+      f->caller_line = func->caller_line;
+      f->tag = func->tag;
+      f->is_linkage = func->is_linkage;
+      if (!line_cache_add_string (b, func->name, &f->name)
+	  || !line_cache_add_string (b, func->caller_file, &f->caller_file))
+	return false;
+      f->first_range = b->nfranges;
+      for (arange = &func->arange; arange != NULL; arange = arange->next)
+	{
+	  struct line_cache_frange *r;
+
+	  b->franges = line_cache_grow (b->franges, &b->franges_alloc,
+					b->nfranges, sizeof (*b->franges));
+	  if (b->franges == NULL)
+	    return false;
+	  r = &b->franges[b->nfranges++];
+	  r->low = arange->low;
+	  r->high = arange->high;
+	  f->nranges++;
+	  if (!line_cache_add_range (b, arange->low, arange->high, index))
+	    return false;
+	}
+      u->nfuncs++;
+    }
+
+  {
+    struct arange *arange;
+
+    for (arange = &unit->arange; arange != NULL; arange = arange->next)
+      if (!line_cache_add_range (b, arange->low, arange->high, index))
+	return false;
+  }
+
+  /* Merge the ranges of this unit, so that a lookup only has to step
+     over the ranges of other units that overlap.  */
+  if (b->nranges - first_range > 1)
+    {
+      struct line_cache_range *r = b->ranges + first_range;
+      size_t n = b->nranges - first_range;
+
+      qsort (r, n, sizeof (*r), compare_line_cache_ranges);
+      for (i = 0, j = 1; j < n; j++)
+	if (r[j].low <= r[i].high)
+	  {
+	    if (r[j].high > r[i].high)
+	      r[i].high = r[i].top = r[j].high;
+	  }
+	else
+	  r[++i] = r[j];
+      b->nranges = first_range + i + 1;
+    }
+  return true;
+}
+
+/* Write the cache in DATA, of SIZE bytes, to the file NAME.  The file is
+   written under another name and renamed, so that another process never
+   sees it half written.  Failure is not an error, as the cache is only
+   an optimisation.  */
+
+static void
+line_cache_write (const char *name, const void *data, size_t size)
+{
+  char *tmpname;
+  FILE *f;
+  bool ok;
+
+  tmpname = bfd_malloc (strlen (name) + 32);
+  if (tmpname == NULL)
+    return;
+  sprintf (tmpname, "%s.%ld.tmp", name, (long) getpid ());
+  f = _bfd_real_fopen (tmpname, FOPEN_WB);
+  if (f != NULL)
+    {
+      ok = fwrite (data, 1, size, f) == size;
+      ok &= fclose (f) == 0;
+      if (!ok || rename (tmpname, name) != 0)
+	unlink (tmpname);
+    }
+  free (tmpname);
+}
+
+/* Read and decode all the compilation units of STASH, and make a line
+   number cache of them for an executable with LAYOUT.  Write the cache
+   to the file NAME.  */
+
+static struct line_cache *
+line_cache_build (struct dwarf2_debug *stash, const char *name,
+		  uint64_t layout)
+{
+  struct dwarf2_debug_file *file = &stash->f;
+  struct line_cache_builder b;
+  struct line_cache_header header;
+  struct line_cache *cache = NULL;
+  struct comp_unit *each;
+  size_t i, size, nunits;
+  char *p;
+
+  memset (&b, 0, sizeof (b));
+  b.string_htab = htab_create_alloc (1024, hash_line_cache_string,
+				     eq_line_cache_string, free,
+				     calloc, free);
+  b.func_htab = htab_create_alloc (1024, hash_line_cache_func,
+				   eq_line_cache_func, free, calloc, free);
+  if (b.string_htab == NULL || b.func_htab == NULL)
+    goto out;
+
+  /* Offset zero of the strings stands for NULL.  */
+  b.strings = bfd_malloc (4096);
+  if (b.strings == NULL)
+    goto out;
+  b.strings_alloc = 4096;
+  b.strings[0] = '\0';
+  b.string_size = 1;
+
+  while (stash_comp_unit (stash, file) != NULL)
+    ;
+
+  nunits = 0;
+  for (each = file->last_comp_unit; each != NULL; each = each->prev_unit)
+    if (!line_cache_add_unit (&b, each, nunits++))
+      goto out;
+
+  /* Turn the callers into indices.  */
+  for (i = 0; i < b.nfuncs; i++)
+    {
+      struct line_cache_func_index search, *entry;
+
+      b.funcs[i].caller = (uint64_t) -1;
+      if (b.callers[i] == NULL)
+	continue;
+      search.func = b.callers[i];
+      entry = htab_find (b.func_htab, &search);
+      if (entry != NULL)
+	b.funcs[i].caller = entry->index;
+    }
+
+  qsort (b.ranges, b.nranges, sizeof (*b.ranges), compare_line_cache_ranges);
+  for (i = 1; i < b.nranges; i++)
+    if (b.ranges[i].top < b.ranges[i - 1].top)
+      b.ranges[i].top = b.ranges[i - 1].top;
+
+  memset (&header, 0, sizeof (header));
+  memcpy (header.magic, LINE_CACHE_MAGIC, sizeof header.magic);
+  header.byte_order = LINE_CACHE_BYTE_ORDER;
+  header.version = LINE_CACHE_VERSION;
+  header.info_size = file->dwarf_info_size;
+  header.layout = layout;
+  header.nranges = b.nranges;
+  header.nunits = b.nunits;
+  header.nseqs = b.nseqs;
+  header.nrows = b.nrows;
+  header.nfuncs = b.nfuncs;
+  header.nfranges = b.nfranges;
+  header.string_size = b.string_size;
+  size = (sizeof (header)
+	  + b.nranges * sizeof (*b.ranges)
+	  + b.nunits * sizeof (*b.units)
+	  + b.nseqs * sizeof (*b.seqs)
+	  + b.nrows * sizeof (*b.rows)
+	  + b.nfuncs * sizeof (*b.funcs)
+	  + b.nfranges * sizeof (*b.franges)
+	  + b.string_size);
+
+  cache = bfd_zmalloc (sizeof (*cache));
+  if (cache == NULL)
+    goto out;
+  cache->data = bfd_malloc (size);
+  if (cache->data == NULL)
+    goto out;
+  p = cache->data;
+#define LINE_CACHE_COPY(src, len) \
+  do { if ((len) != 0) memcpy (p, src, len); p += (len); } while (0)
+  LINE_CACHE_COPY (&header, sizeof (header));
+  LINE_CACHE_COPY (b.ranges, b.nranges * sizeof (*b.ranges));
+  LINE_CACHE_COPY (b.units, b.nunits * sizeof (*b.units));
+  LINE_CACHE_COPY (b.seqs, b.nseqs * sizeof (*b.seqs));
+  LINE_CACHE_COPY (b.rows, b.nrows * sizeof (*b.rows));
+  LINE_CACHE_COPY (b.funcs, b.nfuncs * sizeof (*b.funcs));
+  LINE_CACHE_COPY (b.franges, b.nfranges * sizeof (*b.franges));
+  LINE_CACHE_COPY (b.strings, b.string_size);
+#undef LINE_CACHE_COPY
+
+  if (!line_cache_init (cache, size))
+    {
+      line_cache_free (cache);
+      cache = NULL;
+      goto out;
+    }
+  line_cache_write (name, cache->data, size);
+
+ out:
+  if (b.string_htab != NULL)
+    htab_delete (b.string_htab);
+  if (b.func_htab != NULL)
+    htab_delete (b.func_htab);
+  free (b.ranges);
+  free (b.units);
+  free (b.seqs);
+  free (b.rows);
+  free (b.funcs);
+  free (b.callers);
+  free (b.franges);
+  free (b.strings);
+  if (cache != NULL && cache->data == NULL)
+    {
+      free (cache);
+      cache = NULL;
+    }
+  return cache;
+}
+
+/* Set up the line number cache for ABFD in STASH, if one is wanted,
+   loading it from its file or building it.  */
+
+static void
+line_cache_open (bfd *abfd, struct dwarf2_debug *stash)
+{
+  const char *dir = bfd_get_line_cache_dir ();
+  uint64_t layout;
+  char *name;
+
+  stash->line_cache_tried = true;
+  if (dir == NULL
+      || (abfd->flags & (EXEC_P | DYNAMIC)) == 0
+      || abfd->build_id == NULL
+      || abfd->build_id->size == 0)
+    return;
+
+  name = line_cache_file (abfd, dir);
+  if (name == NULL)
+    return;
+  layout = line_cache_layout (abfd);
+  stash->line_cache = line_cache_load (name, stash->f.dwarf_info_size,
+				       layout);
+  if (stash->line_cache == NULL)
+    stash->line_cache = line_cache_build (stash, name, layout);
+  free (name);
+}
+
+/* Return the string at OFFSET in CACHE, or NULL.  */
+
+static const char *
+line_cache_string (const struct line_cache *cache, uint32_t offset)
+{
+  if (offset == 0 || offset >= cache->header->string_size)
+    return NULL;
+  return cache->strings + offset;
+}
+
+/* Return the funcinfo for function I of the line number cache of STASH,
+   making it if need be.  */
+
+static struct funcinfo *
+line_cache_funcinfo (struct dwarf2_debug *stash, uint64_t i)
+{
+  struct line_cache *cache = stash->line_cache;
+  const struct line_cache_func *f;
+  struct funcinfo *func;
+
+  if (i >= cache->header->nfuncs)
+    return NULL;
+  if (cache->funcinfos[i] != NULL)
+    return cache->funcinfos[i];
+
+  func = bfd_zalloc (stash->orig_bfd, sizeof (*func));
+  if (func == NULL)
+    return NULL;
+  cache->funcinfos[i] = func;
+
+  f = &cache->funcs[i];
+  func->name = line_cache_string (cache, f->name);
+  func->caller_file = (char *) line_cache_string (cache, f->caller_file);
+  func->caller_line = f->caller_line;
+  func->tag = f->tag;
+  func->is_linkage = f->is_linkage;
+  if (f->nranges != 0 && f->first_range < cache->header->nfranges)
+    {
+      func->arange.low = cache->franges[f->first_range].low;
+      func->arange.high = cache->franges[f->first_range].high;
+    }
+  if (f->caller != (uint64_t) -1)
+    func->caller_func = line_cache_funcinfo (stash, f->caller);
+  return func;
+}
+
+/* Like lookup_address_in_line_info_table, for unit U of CACHE.  */
+
+static bool
+line_cache_lookup_line (const struct line_cache *cache,
+			const struct line_cache_unit *u,
+			bfd_vma addr,
+			const char **filename_ptr,
+			unsigned int *linenumber_ptr,
+			unsigned int *discriminator_ptr)
+{
+  const struct line_cache_seq *seq = NULL;
+  const struct line_cache_row *rows, *info;
+  uint64_t low, high, mid;
+
+  low = 0;
+  high = u->nseqs;
+  while (low < high)
+    {
+      mid = (low + high) / 2;
+      seq = &cache->seqs[u->first_seq + mid];
+      if (addr < seq->low)
+	high = mid;
+      else if (addr >= seq->high)
+	low = mid + 1;
+      else
+	break;
+    }
+
+  if (!seq || addr < seq->low || addr >= seq->high
+      || seq->nrows == 0
+      || seq->first_row > cache->header->nrows
+      || seq->nrows > cache->header->nrows - seq->first_row)
+    goto fail;
+
+  rows = &cache->rows[seq->first_row];
+  low = 0;
+  high = seq->nrows;
+  info = NULL;
+  mid = 0;
+  while (low < high)
+    {
+      mid = (low + high) / 2;
+      info = &rows[mid];
+      if (addr < info->address)
+	high = mid;
+      else if (mid + 1 < seq->nrows && addr >= rows[mid + 1].address)
+	low = mid + 1;
+      else
+	break;
+    }
+
+  if (info
+      && mid + 1 < seq->nrows
+      && addr >= info->address
+      && addr < rows[mid + 1].address
+      && !info->end_sequence)
+    {
+      *filename_ptr = line_cache_string (cache, info->file);
+      *linenumber_ptr = info->line;
+      if (discriminator_ptr)
+	*discriminator_ptr = info->discriminator;
+      return true;
+    }
+
+ fail:
+  *filename_ptr = NULL;
+  return false;
+}
+
+/* Like lookup_address_in_function_table, for unit U of CACHE.  Return
+   the index of the function found, or -1.  */
+
+static uint64_t
+line_cache_lookup_function (const struct line_cache *cache,
+			    const struct line_cache_unit *u,
+			    bfd_vma addr)
+{
+  const struct line_cache_func *funcs = &cache->funcs[u->first_func];
+  uint64_t low, high, mid, first;
+  uint64_t best_fit = (uint64_t) -1;
+  bfd_vma best_fit_len = (bfd_vma) -1;
+
+  if (u->nfuncs == 0 || funcs[u->nfuncs - 1].high < addr)
+    return -1;
+
+  low = 0;
+  high = u->nfuncs;
+  first = high;
+  while (low < high)
+    {
+      mid = (low + high) / 2;
+      if (addr < funcs[mid].low)
+	high = mid;
+      else if (addr >= funcs[mid].high)
+	low = mid + 1;
+      else
+	high = first = mid;
+    }
+
+  /* The funcinfo with the highest address wins a tie in the original,
+     and funcinfos are allocated in the order of IDX.  */
+  for (; first < u->nfuncs && addr >= funcs[first].low; first++)
+    {
+      const struct line_cache_func *f = &funcs[first];
+      uint64_t i;
+
+      if (f->first_range > cache->header->nfranges
+	  || f->nranges > cache->header->nfranges - f->first_range)
+	continue;
+      for (i = f->first_range; i < f->first_range + f->nranges; i++)
+	{
+	  const struct line_cache_frange *r = &cache->franges[i];
+
+	  if (addr < r->low || addr >= r->high)
+	    continue;
+	  if (r->high - r->low < best_fit_len
+	      || (r->high - r->low == best_fit_len
+		  && f->idx > funcs[best_fit - u->first_func].idx))
+	    {
+	      best_fit = u->first_func + first;
+	      best_fit_len = r->high - r->low;
+	    }
+	}
+    }
+  return best_fit;
+}
+
+/* Look up ADDR in the line number cache of STASH, as the loops over the
+   compilation units in _bfd_dwarf2_find_nearest_line_with_alt do.  */
+
+static bool
+line_cache_find_nearest_line (struct dwarf2_debug *stash,
+			      bfd_vma addr,
+			      const char **filename_ptr,
+			      struct funcinfo **function_ptr,
+			      unsigned int *linenumber_ptr,
+			      unsigned int *discriminator_ptr)
+{
+  struct line_cache *cache = stash->line_cache;
+  const struct line_cache_range *ranges = cache->ranges;
+  uint64_t low, high, mid, *units;
+  size_t nunits = 0, i, j;
+
+  /* Find the last range starting at or before ADDR.  */
+  low = 0;
+  high = cache->header->nranges;
+  while (low < high)
+    {
+      mid = (low + high) / 2;
+      if (addr < ranges[mid].low)
+	high = mid;
+      else
+	low = mid + 1;
+    }
+
+  /* Collect the units with a range containing ADDR, in unit order.  */
+  units = cache->found_units;
+  while (low-- > 0 && ranges[low].top > addr)
+    if (ranges[low].high > addr)
+      {
+	uint64_t unit = ranges[low].unit;
+
+	for (i = 0; i < nunits; i++)
+	  if (units[i] >= unit)
+	    break;
+	if (i < nunits && units[i] == unit)
+	  continue;
+	units = line_cache_grow (units, &cache->found_units_alloc, nunits,
+				 sizeof (*units));
+	cache->found_units = units;
+	if (units == NULL)
+	  {
+	    cache->found_units_alloc = 0;
+	    return false;
+	  }
+	for (j = nunits; j > i; j--)
+	  units[j] = units[j - 1];
+	units[i] = unit;
+	nunits++;
+      }
+
+  for (i = 0; i < nunits; i++)
+    {
+      const struct line_cache_unit *u = &cache->units[units[i]];
+      uint64_t func;
+      bool line_p;
+
+      *function_ptr = NULL;
+      func = line_cache_lookup_function (cache, u, addr);
+      if (func != (uint64_t) -1)
+	{
+	  *function_ptr = line_cache_funcinfo (stash, func);
+	  if (*function_ptr != NULL
+	      && (*function_ptr)->tag == DW_TAG_inlined_subroutine)
+	    stash->inliner_chain = *function_ptr;
+	}
+      line_p = line_cache_lookup_line (cache, u, addr, filename_ptr,
+				       linenumber_ptr, discriminator_ptr);
+      if (line_p || *function_ptr != NULL)
+	return true;
+    }
+  return false;
+}
+
+/* See _bfd_dwarf2_find_nearest_line_with_alt.  */
+
+int
+_bfd_dwarf2_find_nearest_line (bfd *abfd,
+			       asymbol **symbols,
+			       asymbol *symbol,
+			       asection *section,
+			       bfd_vma offset,
+			       const char **filename_ptr,
+			       const char **functionname_ptr,
+			       unsigned int *linenumber_ptr,
+			       unsigned int *discriminator_ptr,
+			       const struct dwarf_debug_section *debug_sections,
+			       void **pinfo)
+{
+  return _bfd_dwarf2_find_nearest_line_with_alt
+    (abfd, NULL, symbols, symbol, section, offset, filename_ptr,
+     functionname_ptr, linenumber_ptr, discriminator_ptr, debug_sections,
+     pinfo);
+}
+
+/* Find the source code location of SYMBOL.  If SYMBOL is NULL
+   then find the nearest source code location corresponding to
+   the address SECTION + OFFSET.
+   Returns 1 if the line is found without error and fills in
+   FILENAME_PTR and LINENUMBER_PTR.  In the case where SYMBOL was
+   NULL the FUNCTIONNAME_PTR is also filled in.
+   Returns 2 if partial information from _bfd_elf_find_function is
+   returned (function and maybe file) by looking at symbols.  DWARF2
+   info is present but not regarding the requested code location.
+   Returns 0 otherwise.
+   SYMBOLS contains the symbol table for ABFD.
+   DEBUG_SECTIONS contains the name of the dwarf debug sections.
+   If ALT_FILENAME is given, attempt to open the file and use it
+   as the .gnu_debugaltlink file. Otherwise this file will be
+   searched for when needed.  */
+
+int
+_bfd_dwarf2_find_nearest_line_with_alt
+  (bfd *abfd,
+   const char *alt_filename,
+   asymbol **symbols,
+   asymbol *symbol,
+   asection *section,
+   bfd_vma offset,
+   const char **filename_ptr,
+   const char **functionname_ptr,
+   unsigned int *linenumber_ptr,
+   unsigned int *discriminator_ptr,
+   const struct dwarf_debug_section *debug_sections,
+   void **pinfo)
+{
+  /* Read each compilation unit from the section .debug_info, and check
+     to see if it contains the address we are searching for.  If yes,
+     lookup the address, and return the line number info.  If no, go
+     on to the next compilation unit.
+
+     We keep a list of all the previously read compilation units, and
+     a pointer to the next un-read compilation unit.  Check the
+     previously read units before reading more.  */
+  struct dwarf2_debug *stash;
+  /* What address are we looking for?  */
+  bfd_vma addr;
+  struct comp_unit* each;
+  struct funcinfo *function = NULL;
+  int found = false;
+  bool do_line;
+
+  *filename_ptr = NULL;
+  if (functionname_ptr != NULL)
+    *functionname_ptr = NULL;
+  *linenumber_ptr = 0;
   if (discriminator_ptr)
     *discriminator_ptr = 0;
 
@@ -5874,189 +7267,669 @@ _bfd_dwarf2_find_nearest_line_with_alt
       if (stash->info_hash_status == STASH_INFO_HASH_OFF)
 	stash_maybe_enable_info_hash_tables (abfd, stash);
 
-      /* Keep info hash table up to date if they are available.  Note that we
-	 may disable the hash tables if there is any error duing update.  */
-      if (stash->info_hash_status == STASH_INFO_HASH_ON)
-	stash_maybe_update_info_hash_tables (stash);
+      /* Keep info hash table up to date if they are available.  Note that we
+	 may disable the hash tables if there is any error duing update.  */
+      if (stash->info_hash_status == STASH_INFO_HASH_ON)
+	stash_maybe_update_info_hash_tables (stash);
+
+      if (stash->info_hash_status == STASH_INFO_HASH_ON)
+	{
+	  found = stash_find_line_fast (stash, symbol, addr,
+					filename_ptr, linenumber_ptr);
+	  if (found)
+	    goto done;
+	}
+
+      /* Check the previously read comp. units first.  */
+      for (each = stash->f.all_comp_units; each; each = each->next_unit)
+	if ((symbol->flags & BSF_FUNCTION) == 0
+	    || comp_unit_may_contain_address (each, addr))
+	  {
+	    found = comp_unit_find_line (each, symbol, addr, filename_ptr,
+					 linenumber_ptr);
+	    if (found)
+	      goto done;
+	  }
+    }
+  else
+    {
+      struct comp_unit **prev_each;
+
+      if (!stash->line_cache_tried)
+	line_cache_open (abfd, stash);
+      if (stash->line_cache != NULL)
+	{
+	  found = line_cache_find_nearest_line (stash, addr, filename_ptr,
+						&function, linenumber_ptr,
+						discriminator_ptr);
+	  goto done;
+	}
+
+      found = find_nearest_line_in_index (stash, addr, filename_ptr,
+					  &function, linenumber_ptr,
+					  discriminator_ptr);
+      if (found)
+	goto done;
+
+      /* Also scan through all compilation units without any ranges,
+         taking them out of the list if they have acquired any since
+	 last time.  */
+      prev_each = &stash->f.all_comp_units_without_ranges;
+      for (each = *prev_each; each; each = each->next_unit_without_ranges)
+        {
+	  if (each->arange.high != 0)
+	    {
+	      *prev_each = each->next_unit_without_ranges;
+	      continue;
+	    }
+
+	  found = comp_unit_find_nearest_line (each, addr,
+					       filename_ptr,
+					       &function,
+					       linenumber_ptr,
+					       discriminator_ptr);
+	  if (found)
+	    goto done;
+	  prev_each = &each->next_unit_without_ranges;
+	}
+    }
+
+  /* Read each remaining comp. units checking each as they are read.  */
+  while ((each = stash_comp_unit (stash, &stash->f)) != NULL)
+    {
+      /* DW_AT_low_pc and DW_AT_high_pc are optional for
+	 compilation units.  If we don't have them (i.e.,
+	 unit->high == 0), we need to consult the line info table
+	 to see if a compilation unit contains the given
+	 address.  */
+      if (do_line)
+	found = (((symbol->flags & BSF_FUNCTION) == 0
+		  || comp_unit_may_contain_address (each, addr))
+		 && comp_unit_find_line (each, symbol, addr,
+					 filename_ptr, linenumber_ptr));
+      else
+	found = (comp_unit_may_contain_address (each, addr)
+		 && comp_unit_find_nearest_line (each, addr,
+						 filename_ptr,
+						 &function,
+						 linenumber_ptr,
+						 discriminator_ptr));
+
+      if (found)
+	break;
+    }
+
+ done:
+  if (functionname_ptr && function && function->is_linkage)
+    {
+      *functionname_ptr = function->name;
+      if (!found)
+        found = 2;
+    }
+  else if (functionname_ptr
+	   && (!*functionname_ptr
+	       || (function && !function->is_linkage)))
+    {
+      asymbol *fun;
+      asymbol **syms = symbols;
+      asection *sec = section;
+
+      _bfd_dwarf2_stash_syms (stash, abfd, &sec, &syms);
+      fun = _bfd_elf_find_function (abfd, syms, sec, offset,
+				    *filename_ptr ? NULL : filename_ptr,
+				    functionname_ptr);
+
+      if (!found && fun != NULL)
+	found = 2;
+
+      if (function && !function->is_linkage)
+	{
+	  bfd_vma sec_vma;
+
+	  sec_vma = section->vma;
+	  if (section->output_section != NULL)
+	    sec_vma = section->output_section->vma + section->output_offset;
+	  if (fun == NULL)
+	    *functionname_ptr = function->name;
+	  else if (fun->value + sec_vma == function->arange.low)
+	    function->name = *functionname_ptr;
+	  /* Even if we didn't find a linkage name, say that we have
+	     to stop a repeated search of symbols.  */
+	  function->is_linkage = true;
+	}
+    }
+
+  unset_sections (stash);
+
+  return found;
+}
+
+bool
+_bfd_dwarf2_find_inliner_info (bfd *abfd ATTRIBUTE_UNUSED,
+			       const char **filename_ptr,
+			       const char **functionname_ptr,
+			       unsigned int *linenumber_ptr,
+			       void **pinfo)
+{
+  struct dwarf2_debug *stash;
+
+  stash = (struct dwarf2_debug *) *pinfo;
+  if (stash)
+    {
+      struct funcinfo *func = stash->inliner_chain;
+
+      if (func && func->caller_func)
+	{
+	  *filename_ptr = func->caller_file;
+	  *functionname_ptr = func->caller_func->name;
+	  *linenumber_ptr = func->caller_line;
+	  stash->inliner_chain = func->caller_func;
+	  return true;
+	}
+    }
+
+  return false;
+}
+
+/* A DIE seen by scan_unit_for_index_names, recorded so that a later
+   DW_AT_specification or DW_AT_abstract_origin can find its name.  */
+
+struct index_name_ref
+{
+  uint64_t unit_offset;
+  char *name;
+  bool is_external;
+};
+
+static hashval_t
+hash_index_name_ref (const void *p)
+{
+  const struct index_name_ref *ref = (const struct index_name_ref *) p;
+  return (hashval_t) (ref->unit_offset ^ (ref->unit_offset >> 32));
+}
+
+static int
+eq_index_name_ref (const void *pa, const void *pb)
+{
+  const struct index_name_ref *a = (const struct index_name_ref *) pa;
+  const struct index_name_ref *b = (const struct index_name_ref *) pb;
+  return a->unit_offset == b->unit_offset;
+}
+
+static void
+del_index_name_ref (void *p)
+{
+  struct index_name_ref *ref = (struct index_name_ref *) p;
+  free (ref->name);
+  free (ref);
+}
+
+/* Return the separator used to qualify names in language LANG by their
+   enclosing scope, or NULL if LANG has no nested scopes worth
+   indexing.  */
+
+static const char *
+index_scope_separator (int lang)
+{
+  switch (mangle_style (lang))
+    {
+    case DMGL_GNU_V3:
+    case DMGL_RUST:
+      return "::";
+    case DMGL_DLANG:
+      return ".";
+    default:
+      return NULL;
+    }
+}
+
+/* Return a malloc'd copy of NAME qualified by SCOPE.  */
+
+static char *
+index_qualified_name (const char *scope, const char *sep, const char *name)
+{
+  size_t scope_len, sep_len, name_len;
+  char *ret;
+
+  if (scope == NULL || sep == NULL)
+    return strdup (name);
+
+  scope_len = strlen (scope);
+  sep_len = strlen (sep);
+  name_len = strlen (name);
+  ret = (char *) bfd_malloc (scope_len + sep_len + name_len + 1);
+  if (ret == NULL)
+    return NULL;
+  memcpy (ret, scope, scope_len);
+  memcpy (ret + scope_len, sep, sep_len);
+  memcpy (ret + scope_len + sep_len, name, name_len + 1);
+  return ret;
+}
+
+/* Return TRUE if a named DIE with TAG belongs in a name index.  */
+
+static bool
+tag_indexed_by_name (enum dwarf_tag tag)
+{
+  switch (tag)
+    {
+    case DW_TAG_array_type:
+    case DW_TAG_base_type:
+    case DW_TAG_class_type:
+    case DW_TAG_constant:
+    case DW_TAG_enumeration_type:
+    case DW_TAG_enumerator:
+    case DW_TAG_interface_type:
+    case DW_TAG_module:
+    case DW_TAG_namespace:
+    case DW_TAG_ptr_to_member_type:
+    case DW_TAG_set_type:
+    case DW_TAG_string_type:
+    case DW_TAG_structure_type:
+    case DW_TAG_subprogram:
+    case DW_TAG_subrange_type:
+    case DW_TAG_generic_subrange:
+    case DW_TAG_subroutine_type:
+    case DW_TAG_typedef:
+    case DW_TAG_union_type:
+    case DW_TAG_unspecified_type:
+    case DW_TAG_variable:
+      return true;
+    default:
+      return false;
+    }
+}
+
+/* Call NAME_FN for each DIE of UNIT that belongs in a DWARF 5 name
+   index.  Like gdb's own index, this covers the types, functions and
+   variables visible at namespace or class scope, under their names
+   qualified by that scope, but not the entities local to a
+   function.  */
+
+static bool
+scan_unit_for_index_names (struct comp_unit *unit,
+			   dwarf2_index_name_fn name_fn, void *data)
+{
+  bfd *abfd = unit->abfd;
+  bfd_byte *info_ptr = unit->first_child_die_ptr;
+  bfd_byte *info_ptr_end = unit->end_ptr;
+  const char *sep = index_scope_separator (unit->lang);
+  struct index_scope
+  {
+    /* The qualified name of the scope, or NULL at the top level.  */
+    char *name;
+    /* Whether the children of this scope are indexed.  */
+    bool indexed;
+  } *scopes;
+  int scopes_size;
+  int nesting_level = 0;
+  htab_t refs;
+  bool ret = false;
+
+  scopes_size = 32;
+  scopes = (struct index_scope *) bfd_malloc (scopes_size * sizeof (*scopes));
+  if (scopes == NULL)
+    return false;
+  scopes[0].name = NULL;
+  scopes[0].indexed = true;
+
+  refs = htab_create_alloc (10, hash_index_name_ref, eq_index_name_ref,
+			    del_index_name_ref, calloc, free);
+  if (refs == NULL)
+    goto out;
+
+  while (nesting_level >= 0)
+    {
+      unsigned int abbrev_number, i;
+      struct abbrev_info *abbrev;
+      struct index_scope *scope;
+      const char *name = NULL;
+      const char *linkage_name = NULL;
+      char *qualified = NULL;
+      uint64_t ref = 0;
+      bool is_declaration = false;
+      bool is_external = false;
+      bool has_location = false;
+      bool is_enum_class = false;
+      uint64_t current_offset;
+
+      /* A unit without children, or a truncated one, ends here.  */
+      if (info_ptr >= info_ptr_end)
+	break;
+
+      current_offset = info_ptr - unit->info_ptr_unit;
+      abbrev_number = _bfd_safe_read_leb128 (abfd, &info_ptr,
+					     false, info_ptr_end);
+      if (abbrev_number == 0)
+	{
+	  free (scopes[nesting_level].name);
+	  scopes[nesting_level].name = NULL;
+	  nesting_level--;
+	  continue;
+	}
+
+      abbrev = lookup_abbrev (abbrev_number, unit->abbrevs);
+      if (abbrev == NULL)
+	{
+	  _bfd_error_handler
+	    (_("DWARF error: could not find abbrev number %u"),
+	     abbrev_number);
+	  bfd_set_error (bfd_error_bad_value);
+	  goto out;
+	}
+
+      for (i = 0; i < abbrev->num_attrs; ++i)
+	{
+	  struct attribute attr;
+
+	  info_ptr = read_attribute (&attr, &abbrev->attrs[i],
+				     unit, info_ptr, info_ptr_end);
+	  if (info_ptr == NULL)
+	    goto out;
+
+	  switch (attr.name)
+	    {
+	    case DW_AT_name:
+	      if (is_str_form (&attr))
+		name = attr.u.str;
+	      break;
+
+	    case DW_AT_linkage_name:
+	    case DW_AT_MIPS_linkage_name:
+	      if (is_str_form (&attr))
+		linkage_name = attr.u.str;
+	      break;
+
+	    case DW_AT_declaration:
+	      is_declaration = is_int_form (&attr) && attr.u.val != 0;
+	      break;
+
+	    case DW_AT_external:
+	      is_external = is_int_form (&attr) && attr.u.val != 0;
+	      break;
+
+	    case DW_AT_enum_class:
+	      is_enum_class = is_int_form (&attr) && attr.u.val != 0;
+	      break;
+
+	    case DW_AT_location:
+	    case DW_AT_const_value:
+	      has_location = true;
+	      break;
+
+	    case DW_AT_specification:
+	    case DW_AT_abstract_origin:
+	      /* Only references within this unit are followed.  */
+	      switch (attr.form)
+		{
+		case DW_FORM_ref1:
+		case DW_FORM_ref2:
+		case DW_FORM_ref4:
+		case DW_FORM_ref8:
+		case DW_FORM_ref_udata:
+		  ref = attr.u.val;
+		  break;
+		default:
+		  break;
+		}
+	      break;
 
-      if (stash->info_hash_status == STASH_INFO_HASH_ON)
-	{
-	  found = stash_find_line_fast (stash, symbol, addr,
-					filename_ptr, linenumber_ptr);
-	  if (found)
-	    goto done;
+	    default:
+	      break;
+	    }
 	}
 
-      /* Check the previously read comp. units first.  */
-      for (each = stash->f.all_comp_units; each; each = each->next_unit)
-	if ((symbol->flags & BSF_FUNCTION) == 0
-	    || comp_unit_may_contain_address (each, addr))
-	  {
-	    found = comp_unit_find_line (each, symbol, addr, filename_ptr,
-					 linenumber_ptr);
-	    if (found)
-	      goto done;
-	  }
-    }
-  else
-    {
-      struct trie_node *trie = stash->f.trie_root;
-      unsigned int bits = VMA_BITS - 8;
-      struct comp_unit **prev_each;
+      scope = &scopes[nesting_level];
+      if (name == NULL && abbrev->tag == DW_TAG_namespace)
+	name = "(anonymous namespace)";
 
-      /* Traverse interior nodes until we get to a leaf.  */
-      while (trie && trie->num_room_in_leaf == 0)
+      if (ref != 0 && (name == NULL || scope->name == NULL))
 	{
-	  int ch = (addr >> bits) & 0xff;
-	  trie = ((struct trie_interior *) trie)->children[ch];
-	  bits -= 8;
-	}
+	  struct index_name_ref key, *found;
 
-      if (trie)
+	  /* An out-of-line definition takes its name and scope from
+	     the declaration it completes.  */
+	  key.unit_offset = ref;
+	  found = (struct index_name_ref *) htab_find (refs, &key);
+	  if (found != NULL)
+	    {
+	      qualified = strdup (found->name);
+	      if (qualified == NULL)
+		goto out;
+	      is_external |= found->is_external;
+	    }
+	}
+      if (qualified == NULL && name != NULL)
 	{
-	  const struct trie_leaf *leaf = (struct trie_leaf *) trie;
-	  unsigned int i;
-
-	  for (i = 0; i < leaf->num_stored_in_leaf; ++i)
-	    leaf->ranges[i].unit->mark = false;
+	  qualified = index_qualified_name (scope->name, sep, name);
+	  if (qualified == NULL)
+	    goto out;
+	}
 
-	  for (i = 0; i < leaf->num_stored_in_leaf; ++i)
+      if (qualified != NULL
+	  && (abbrev->tag == DW_TAG_subprogram
+	      || abbrev->tag == DW_TAG_variable))
+	{
+	  struct index_name_ref *rec;
+	  void **slot;
+
+	  rec = (struct index_name_ref *) bfd_malloc (sizeof (*rec));
+	  if (rec == NULL)
+	    goto out;
+	  rec->unit_offset = current_offset;
+	  rec->is_external = is_external;
+	  rec->name = strdup (qualified);
+	  slot = htab_find_slot (refs, rec, INSERT);
+	  if (rec->name == NULL || slot == NULL)
 	    {
-	      struct comp_unit *unit = leaf->ranges[i].unit;
-	      if (unit->mark
-		  || addr < leaf->ranges[i].low_pc
-		  || addr >= leaf->ranges[i].high_pc)
-	        continue;
-	      unit->mark = true;
-
-	      found = comp_unit_find_nearest_line (unit, addr,
-						   filename_ptr,
-						   &function,
-						   linenumber_ptr,
-						   discriminator_ptr);
-	      if (found)
-		goto done;
-	   }
+	      free (rec->name);
+	      free (rec);
+	      goto out;
+	    }
+	  if (*slot != NULL)
+	    del_index_name_ref (*slot);
+	  *slot = rec;
 	}
 
-      /* Also scan through all compilation units without any ranges,
-         taking them out of the list if they have acquired any since
-	 last time.  */
-      prev_each = &stash->f.all_comp_units_without_ranges;
-      for (each = *prev_each; each; each = each->next_unit_without_ranges)
-        {
-	  if (each->arange.high != 0)
+      if (scope->indexed
+	  && qualified != NULL
+	  && tag_indexed_by_name (abbrev->tag)
+	  /* Declarations are indexed where they are defined, except
+	     for external variables which may only be declared.  */
+	  && (!is_declaration
+	      || (abbrev->tag == DW_TAG_variable && is_external))
+	  && (abbrev->tag != DW_TAG_variable
+	      || has_location || ref != 0 || is_external))
+	{
+	  bool is_static = !is_external;
+
+	  switch (abbrev->tag)
 	    {
-	      *prev_each = each->next_unit_without_ranges;
-	      continue;
+	    case DW_TAG_namespace:
+	    case DW_TAG_module:
+	      is_static = false;
+	      break;
+	    case DW_TAG_class_type:
+	    case DW_TAG_interface_type:
+	    case DW_TAG_structure_type:
+	    case DW_TAG_union_type:
+	    case DW_TAG_enumeration_type:
+	    case DW_TAG_enumerator:
+	      if (sep != NULL)
+		is_static = false;
+	      break;
+	    default:
+	      break;
 	    }
 
-	  found = comp_unit_find_nearest_line (each, addr,
-					       filename_ptr,
-					       &function,
-					       linenumber_ptr,
-					       discriminator_ptr);
-	  if (found)
-	    goto done;
-	  prev_each = &each->next_unit_without_ranges;
+	  if (!name_fn (data, qualified, abbrev->tag, current_offset,
+			is_static)
+	      || (linkage_name != NULL
+		  && strcmp (linkage_name, qualified) != 0
+		  && !name_fn (data, linkage_name, abbrev->tag,
+			       current_offset, is_static)))
+	    {
+	      free (qualified);
+	      goto out;
+	    }
 	}
-    }
 
-  /* Read each remaining comp. units checking each as they are read.  */
-  while ((each = stash_comp_unit (stash, &stash->f)) != NULL)
-    {
-      /* DW_AT_low_pc and DW_AT_high_pc are optional for
-	 compilation units.  If we don't have them (i.e.,
-	 unit->high == 0), we need to consult the line info table
-	 to see if a compilation unit contains the given
-	 address.  */
-      if (do_line)
-	found = (((symbol->flags & BSF_FUNCTION) == 0
-		  || comp_unit_may_contain_address (each, addr))
-		 && comp_unit_find_line (each, symbol, addr,
-					 filename_ptr, linenumber_ptr));
-      else
-	found = (comp_unit_may_contain_address (each, addr)
-		 && comp_unit_find_nearest_line (each, addr,
-						 filename_ptr,
-						 &function,
-						 linenumber_ptr,
-						 discriminator_ptr));
+      if (abbrev->has_children)
+	{
+	  struct index_scope *child;
+	  const char *child_name = NULL;
 
-      if (found)
-	break;
-    }
+	  nesting_level++;
+	  if (nesting_level >= scopes_size)
+	    {
+	      struct index_scope *tmp;
 
- done:
-  if (functionname_ptr && function && function->is_linkage)
-    {
-      *functionname_ptr = function->name;
-      if (!found)
-        found = 2;
-    }
-  else if (functionname_ptr
-	   && (!*functionname_ptr
-	       || (function && !function->is_linkage)))
-    {
-      asymbol *fun;
-      asymbol **syms = symbols;
-      asection *sec = section;
+	      scopes_size *= 2;
+	      tmp = (struct index_scope *)
+		bfd_realloc (scopes, scopes_size * sizeof (*scopes));
+	      if (tmp == NULL)
+		{
+		  free (qualified);
+		  nesting_level--;
+		  goto out;
+		}
+	      scopes = tmp;
+	    }
+	  scope = &scopes[nesting_level - 1];
+	  child = &scopes[nesting_level];
+	  child->indexed = false;
 
-      _bfd_dwarf2_stash_syms (stash, abfd, &sec, &syms);
-      fun = _bfd_elf_find_function (abfd, syms, sec, offset,
-				    *filename_ptr ? NULL : filename_ptr,
-				    functionname_ptr);
+	  switch (abbrev->tag)
+	    {
+	    case DW_TAG_namespace:
+	    case DW_TAG_module:
+	      child->indexed = scope->indexed && qualified != NULL;
+	      child_name = qualified;
+	      break;
 
-      if (!found && fun != NULL)
-	found = 2;
+	    case DW_TAG_class_type:
+	    case DW_TAG_interface_type:
+	    case DW_TAG_structure_type:
+	    case DW_TAG_union_type:
+	      child->indexed = scope->indexed && sep != NULL && qualified != NULL;
+	      child_name = qualified;
+	      break;
 
-      if (function && !function->is_linkage)
-	{
-	  bfd_vma sec_vma;
+	    case DW_TAG_enumeration_type:
+	      /* Enumerators live in the enclosing scope unless this is
+		 an enum class.  */
+	      child->indexed = scope->indexed;
+	      child_name = (is_enum_class && qualified != NULL
+			    ? qualified : scope->name);
+	      break;
 
-	  sec_vma = section->vma;
-	  if (section->output_section != NULL)
-	    sec_vma = section->output_section->vma + section->output_offset;
-	  if (fun == NULL)
-	    *functionname_ptr = function->name;
-	  else if (fun->value + sec_vma == function->arange.low)
-	    function->name = *functionname_ptr;
-	  /* Even if we didn't find a linkage name, say that we have
-	     to stop a repeated search of symbols.  */
-	  function->is_linkage = true;
+	    default:
+	      break;
+	    }
+
+	  child->name = NULL;
+	  if (child->indexed && child_name != NULL)
+	    {
+	      child->name = strdup (child_name);
+	      if (child->name == NULL)
+		{
+		  free (qualified);
+		  goto out;
+		}
+	    }
 	}
+
+      free (qualified);
     }
 
-  unset_sections (stash);
+  ret = true;
 
-  return found;
+ out:
+  for (; nesting_level >= 0; nesting_level--)
+    free (scopes[nesting_level].name);
+  free (scopes);
+  if (refs != NULL)
+    htab_delete (refs);
+  return ret;
 }
 
+/* Call UNIT_FN for each compilation and type unit in the .debug_info
+   of ABFD, with the input section holding the unit and the offset of
+   the unit within that section, and then NAME_FN for each debugging
+   information entry of the unit that belongs in a DWARF 5 name index.
+   SYMBOLS are used to relocate the debug sections of a relocatable
+   object.  Return FALSE on error, or if the units could not all be
+   read.  */
+
 bool
-_bfd_dwarf2_find_inliner_info (bfd *abfd ATTRIBUTE_UNUSED,
-			       const char **filename_ptr,
-			       const char **functionname_ptr,
-			       unsigned int *linenumber_ptr,
-			       void **pinfo)
+_bfd_dwarf2_scan_index_names (bfd *abfd, asymbol **symbols, void **pinfo,
+			      dwarf2_index_unit_fn unit_fn,
+			      dwarf2_index_name_fn name_fn, void *data)
 {
   struct dwarf2_debug *stash;
+  struct dwarf2_debug_file *file;
+  struct comp_unit *each;
+  asection *msec;
+  bfd_size_type msec_start;
+  bfd_byte *info_ptr_end;
+  bool do_place = (abfd->flags & (EXEC_P | DYNAMIC)) == 0;
+  bool ret = false;
+
+  if (find_debug_info (abfd, dwarf_debug_sections, NULL) == NULL)
+    return true;
+
+  if (!_bfd_dwarf2_slurp_debug_info (abfd, NULL, dwarf_debug_sections,
+				     symbols, pinfo, do_place))
+    return false;
 
   stash = (struct dwarf2_debug *) *pinfo;
-  if (stash)
+  file = &stash->f;
+  if (file->bfd_ptr != abfd)
+    goto out;
+
+  /* Read whatever units an earlier lookup did not need.  */
+  info_ptr_end = file->dwarf_info_buffer + file->dwarf_info_size;
+  while (file->info_ptr < info_ptr_end)
     {
-      struct funcinfo *func = stash->inliner_chain;
+      bfd_byte *info_ptr = file->info_ptr;
 
-      if (func && func->caller_func)
+      if (stash_comp_unit (stash, file) == NULL)
 	{
-	  *filename_ptr = func->caller_file;
-	  *functionname_ptr = func->caller_func->name;
-	  *linenumber_ptr = func->caller_line;
-	  stash->inliner_chain = func->caller_func;
-	  return true;
+	  /* Anything other than zero padding after the last unit
+	     means some units could not be read.  */
+	  for (; info_ptr < info_ptr_end; info_ptr++)
+	    if (*info_ptr != 0)
+	      goto out;
+	  break;
 	}
     }
 
-  return false;
+  msec = find_debug_info (abfd, dwarf_debug_sections, NULL);
+  msec_start = 0;
+  for (each = file->last_comp_unit; each != NULL; each = each->prev_unit)
+    {
+      bfd_size_type offset = each->info_ptr_unit - file->dwarf_info_buffer;
+
+      while (msec != NULL && offset >= msec_start + msec->size)
+	{
+	  msec_start += msec->size;
+	  msec = find_debug_info (abfd, dwarf_debug_sections, msec);
+	}
+      if (msec == NULL)
+	goto out;
+
+      if (!unit_fn (data, msec, offset - msec_start,
+		    each->unit_type == DW_UT_type)
+	  || !scan_unit_for_index_names (each, name_fn, data))
+	goto out;
+    }
+
+  ret = true;
+
+ out:
+  if (do_place)
+    unset_sections (stash);
+  return ret;
 }
 
 void
@@ -6117,6 +7990,10 @@ _bfd_dwarf2_cleanup_debug_info (bfd *abfd, void **pinfo)
       if (file->comp_unit_tree != NULL)
 	splay_tree_delete (file->comp_unit_tree);
 
+      arange_index_free (&file->unit_index);
+      free (file->units);
+      arange_index_free (&file->aranges_index);
+
       free (file->dwarf_line_str_buffer);
       free (file->dwarf_str_buffer);
       free (file->dwarf_ranges_buffer);
@@ -6129,12 +8006,37 @@ _bfd_dwarf2_cleanup_debug_info (bfd *abfd, void **pinfo)
     }
   free (stash->sec_vma);
   free (stash->adjusted_sections);
+  line_cache_free (stash->line_cache);
   if (stash->close_on_cleanup)
     bfd_close (stash->f.bfd_ptr);
   if (stash->alt.bfd_ptr)
     bfd_close (stash->alt.bfd_ptr);
 }
 
+/* A symbol that may be a function in a section, as found by
+   maybe_function_sym, with the file name to report for it.  */
+
+struct elf_function_entry
+{
+  bfd_vma        code_off;
+  bfd_size_type  code_size;
+  asymbol *      sym;
+  const char *   filename;
+  /* The position of the symbol in the symbol table.  */
+  size_t         seq;
+};
+
+/* The possible functions in one section, sorted by address and then
+   by their position in the symbol table.  */
+
+struct elf_function_index
+{
+  struct elf_function_index *next;
+  asection *     section;
+  size_t         count;
+  struct elf_function_entry *entries;
+};
+
 typedef struct elf_find_function_cache
 {
   asection *     last_section;
@@ -6143,6 +8045,11 @@ typedef struct elf_find_function_cache
   bfd_size_type  code_size;
   bfd_vma        code_off;
 
+  /* The symbol table the indexes were built from, and the indexes of
+     the sections looked up so far.  */
+  asymbol **     syms;
+  struct elf_function_index *indexes;
+
 } elf_find_function_cache;
 
 
@@ -6211,6 +8118,136 @@ better_fit (elf_find_function_cache *  cache,
   return code_size < cache->code_size;
 }
 
+static int
+compare_elf_function_entries (const void *a, const void *b)
+{
+  const struct elf_function_entry *entry1 = a;
+  const struct elf_function_entry *entry2 = b;
+
+  if (entry1->code_off < entry2->code_off)
+    return -1;
+  if (entry1->code_off > entry2->code_off)
+    return 1;
+  if (entry1->seq < entry2->seq)
+    return -1;
+  if (entry1->seq > entry2->seq)
+    return 1;
+  return 0;
+}
+
+/* Return the index of the possible functions in SECTION, building it
+   from SYMBOLS the first time.  This scans the symbol table the same
+   way a linear search for the best fit would, once per section rather
+   than once per lookup.  */
+
+static struct elf_function_index *
+get_elf_function_index (bfd *abfd, elf_find_function_cache *cache,
+			asymbol **symbols, asection *section)
+{
+  const struct elf_backend_data *bed = get_elf_backend_data (abfd);
+  struct elf_function_index *idx;
+  asymbol *file;
+  asymbol **p;
+  size_t count, alloc;
+  /* ??? Given multiple file symbols, it is impossible to reliably
+     choose the right file name for global symbols.  File symbols are
+     local symbols, and thus all file symbols must sort before any
+     global symbols.  The ELF spec may be interpreted to say that a
+     file symbol must sort before other local symbols, but currently
+     ld -r doesn't do this.  So, for ld -r output, it is possible to
+     make a better choice of file name for local symbols by ignoring
+     file symbols appearing after a given local symbol.  */
+  enum { nothing_seen, symbol_seen, file_after_symbol_seen } state;
+
+  if (cache->syms != symbols)
+    {
+      cache->syms = symbols;
+      cache->indexes = NULL;
+    }
+
+  for (idx = cache->indexes; idx != NULL; idx = idx->next)
+    if (idx->section == section)
+      return idx;
+
+  idx = bfd_zalloc (abfd, sizeof (*idx));
+  if (idx == NULL)
+    return NULL;
+  idx->section = section;
+
+  file = NULL;
+  state = nothing_seen;
+  count = alloc = 0;
+  for (p = symbols; *p != NULL; p++)
+    {
+      asymbol *sym = *p;
+      struct elf_function_entry *entry;
+      bfd_vma code_off;
+      bfd_size_type size;
+
+      if ((sym->flags & BSF_FILE) != 0)
+	{
+	  file = sym;
+	  if (state == symbol_seen)
+	    state = file_after_symbol_seen;
+	  continue;
+	}
+
+      if (state == nothing_seen)
+	state = symbol_seen;
+
+      size = bed->maybe_function_sym (sym, section, &code_off);
+
+      if (size == 0)
+	continue;
+
+      if (count >= alloc)
+	{
+	  alloc = alloc * 2 + 64;
+	  entry = bfd_realloc (idx->entries, alloc * sizeof (*entry));
+	  if (entry == NULL)
+	    {
+	      free (idx->entries);
+	      return NULL;
+	    }
+	  idx->entries = entry;
+	}
+
+      entry = &idx->entries[count++];
+      entry->code_off = code_off;
+      entry->code_size = size;
+      entry->sym = sym;
+      entry->filename = NULL;
+      entry->seq = p - symbols;
+      if (file != NULL
+	  && ((sym->flags & BSF_LOCAL) != 0
+	      || state != file_after_symbol_seen))
+	entry->filename = bfd_asymbol_name (file);
+    }
+
+  /* Move the entries to memory that lives as long as ABFD.  */
+  if (count != 0)
+    {
+      struct elf_function_entry *entries;
+
+      qsort (idx->entries, count, sizeof (*idx->entries),
+	     compare_elf_function_entries);
+      entries = bfd_alloc (abfd, count * sizeof (*entries));
+      if (entries == NULL)
+	{
+	  free (idx->entries);
+	  return NULL;
+	}
+      memcpy (entries, idx->entries, count * sizeof (*entries));
+      free (idx->entries);
+      idx->entries = entries;
+    }
+  idx->count = count;
+
+  idx->next = cache->indexes;
+  cache->indexes = idx;
+  return idx;
+}
+
 /* Find the function to a particular section and offset,
    for error reporting.  */
 
@@ -6243,72 +8280,59 @@ _bfd_elf_find_function (bfd *abfd,
       || offset < cache->func->value
       || offset >= cache->func->value + cache->code_size)
     {
-      asymbol *file;
-      asymbol **p;
-      /* ??? Given multiple file symbols, it is impossible to reliably
-	 choose the right file name for global symbols.  File symbols are
-	 local symbols, and thus all file symbols must sort before any
-	 global symbols.  The ELF spec may be interpreted to say that a
-	 file symbol must sort before other local symbols, but currently
-	 ld -r doesn't do this.  So, for ld -r output, it is possible to
-	 make a better choice of file name for local symbols by ignoring
-	 file symbols appearing after a given local symbol.  */
-      enum { nothing_seen, symbol_seen, file_after_symbol_seen } state;
-      const struct elf_backend_data *bed = get_elf_backend_data (abfd);
-
-      file = NULL;
-      state = nothing_seen;
+      struct elf_function_index *idx;
+      size_t lo, hi, i;
+
       cache->filename = NULL;
       cache->func = NULL;
       cache->code_size = 0;
       cache->code_off = 0;
       cache->last_section = section;
 
-      for (p = symbols; *p != NULL; p++)
-	{
-	  asymbol *sym = *p;
-	  bfd_vma code_off;
-	  bfd_size_type size;
-
-	  if ((sym->flags & BSF_FILE) != 0)
-	    {
-	      file = sym;
-	      if (state == symbol_seen)
-		state = file_after_symbol_seen;
-	      continue;
-	    }
+      idx = get_elf_function_index (abfd, cache, symbols, section);
+      if (idx == NULL)
+	return NULL;
 
-	  if (state == nothing_seen)
-	    state = symbol_seen;
+      /* Find the first symbol beyond OFFSET.  */
+      lo = 0;
+      hi = idx->count;
+      while (lo < hi)
+	{
+	  size_t mid = lo + (hi - lo) / 2;
 
-	  size = bed->maybe_function_sym (sym, section, &code_off);
+	  if (idx->entries[mid].code_off <= offset)
+	    lo = mid + 1;
+	  else
+	    hi = mid;
+	}
 
-	  if (size == 0)
-	    continue;
+      /* The best fit is one of the symbols closest to OFFSET from
+	 below, which all start at the same address.  Choose between
+	 them in symbol table order.  */
+      for (i = lo; i > 0; i--)
+	if (idx->entries[i - 1].code_off != idx->entries[lo - 1].code_off)
+	  break;
+      for (; i < lo; i++)
+	{
+	  const struct elf_function_entry *entry = &idx->entries[i];
 
-	  if (better_fit (cache, sym, code_off, size, offset))
-	    {
-	      cache->func = sym;
-	      cache->code_size = size;
-	      cache->code_off = code_off;
-	      cache->filename = NULL;
-
-	      if (file != NULL
-		  && ((sym->flags & BSF_LOCAL) != 0
-		      || state != file_after_symbol_seen))
-		cache->filename = bfd_asymbol_name (file);
-	    }
-	  /* Otherwise, if the symbol is beyond the desired offset but it
-	     lies within the bounds of the current best match then reduce
-	     the size of the current best match so that future searches
-	     will not not used the cached symbol by mistake.  */
-	  else if (code_off > offset 
-		   && code_off > cache->code_off
-		   && code_off < cache->code_off + cache->code_size)
+	  if (better_fit (cache, entry->sym, entry->code_off,
+			  entry->code_size, offset))
 	    {
-	      cache->code_size = code_off - cache->code_off;
+	      cache->func = entry->sym;
+	      cache->code_size = entry->code_size;
+	      cache->code_off = entry->code_off;
+	      cache->filename = entry->filename;
 	    }
 	}
+
+      /* If the next symbol lies within the bounds of the best match,
+	 reduce the size of the match so that future searches will not
+	 use the cached symbol by mistake.  */
+      if (cache->func != NULL
+	  && lo < idx->count
+	  && idx->entries[lo].code_off < cache->code_off + cache->code_size)
+	cache->code_size = idx->entries[lo].code_off - cache->code_off;
     }
 
   if (cache->func == NULL)
@@ -604,6 +604,8 @@ struct sym_cache
   Elf_Internal_Sym sym[LOCAL_SYM_CACHE_SIZE];
 };
 
+struct elf_debug_names_info;
+
 /* ELF linker hash table.  */
 
 struct elf_link_hash_table
@@ -705,6 +707,9 @@ struct elf_link_hash_table
   /* Used to link stack trace info in .sframe sections.  */
   struct sframe_enc_info sfe_info;
 
+  /* Used to build a .debug_names index for --debug-names.  */
+  struct elf_debug_names_info *debug_names;
+
   /* A linked list of local symbols to be added to .dynsym.  */
   struct elf_link_local_dynamic_entry *dynlocal;
 
@@ -2493,6 +2498,9 @@ extern bool _bfd_elf_write_section_sframe
   (bfd *, struct bfd_link_info *);
 extern bool _bfd_elf_set_section_sframe (bfd *, struct bfd_link_info *);
 
+extern bool _bfd_elf_setup_debug_names (bfd *, struct bfd_link_info *);
+extern bool _bfd_elf_size_debug_names (bfd *, struct bfd_link_info *);
+
 extern bool _bfd_elf_hash_symbol (struct elf_link_hash_entry *);
 
 extern long _bfd_elf_link_lookup_local_dynindx
@@ -6602,11 +6602,55 @@ _bfd_elf_assign_file_positions_for_non_load (bfd *abfd)
   Elf_Internal_Shdr *shdrp;
   Elf_Internal_Ehdr *i_ehdrp;
   const struct elf_backend_data *bed;
+  bool precompressed = false;
 
   off = elf_next_file_pos (abfd);
 
   shdrpp = elf_elfsections (abfd);
   end_shdrpp = shdrpp + elf_numsections (abfd);
+
+  /* When threads are allowed, compress all the DWARF debug sections
+     up front so that the compression can be done in parallel.  The
+     loop below then only needs to place them.  */
+  if (bfd_get_thread_count () > 1)
+    {
+      asection **secs;
+      bfd_byte **buffers;
+      unsigned int count = 0;
+      bool ok;
+
+      secs = bfd_malloc (elf_numsections (abfd) * sizeof (*secs));
+      buffers = bfd_malloc (elf_numsections (abfd) * sizeof (*buffers));
+      if (secs == NULL || buffers == NULL)
+	{
+	  free (secs);
+	  free (buffers);
+	  return false;
+	}
+      for (shdrpp++; shdrpp < end_shdrpp; shdrpp++)
+	{
+	  shdrp = *shdrpp;
+	  if (shdrp->sh_offset == -1
+	      && shdrp->bfd_section != NULL
+	      && shdrp->sh_type != SHT_REL
+	      && shdrp->sh_type != SHT_RELA
+	      && !bfd_section_is_ctf (shdrp->bfd_section)
+	      && shdrp->sh_name == -1u)
+	    {
+	      secs[count] = shdrp->bfd_section;
+	      buffers[count++] = shdrp->contents;
+	      shdrp->contents = NULL;
+	    }
+	}
+      ok = _bfd_compress_sections (abfd, secs, buffers, count);
+      free (secs);
+      free (buffers);
+      if (!ok)
+	return false;
+      precompressed = true;
+      shdrpp = elf_elfsections (abfd);
+    }
+
   for (shdrpp++; shdrpp < end_shdrpp; shdrpp++)
     {
       shdrp = *shdrpp;
@@ -6628,8 +6672,10 @@ _bfd_elf_assign_file_positions_for_non_load (bfd *abfd)
 	      const char *name = sec->name;
 	      struct bfd_elf_section_data *d;
 
-	      /* Compress DWARF debug sections.  */
-	      if (!bfd_compress_section (abfd, sec, shdrp->contents))
+	      /* Compress DWARF debug sections, unless that was done
+		 above.  */
+	      if (!precompressed
+		  && !bfd_compress_section (abfd, sec, shdrp->contents))
 		return false;
 
 	      if (sec->compress_status == COMPRESS_SECTION_DONE
@@ -27,6 +27,7 @@
 #include "safe-ctype.h"
 #include "libiberty.h"
 #include "objalloc.h"
+#include "dwarf2.h"
 #if BFD_SUPPORTS_PLUGINS
 #include "plugin-api.h"
 #include "plugin.h"
@@ -1053,7 +1054,8 @@ elf_merge_st_other (bfd *abfd, struct elf_link_hash_entry *h,
    existing symbol.  It handles the various cases which arise when we
    find a definition in a dynamic object, or when there is already a
    definition in a dynamic object.  The new symbol is described by
-   NAME, SYM, PSEC, and PVALUE.  We set SYM_HASH to the hash table
+   NAME, SYM, PSEC, and PVALUE.  If NAME_HASH is not NULL, it points
+   to the hash code of NAME.  We set SYM_HASH to the hash table
    entry.  We set POLDBFD to the old symbol's BFD.  We set POLD_WEAK
    if the old symbol was weak.  We set POLD_ALIGNMENT to the alignment
    of an old common symbol.  We set OVERRIDE if the old symbol is
@@ -1066,6 +1068,7 @@ static bool
 _bfd_elf_merge_symbol (bfd *abfd,
 		       struct bfd_link_info *info,
 		       const char *name,
+		       const unsigned long *name_hash,
 		       Elf_Internal_Sym *sym,
 		       asection **psec,
 		       bfd_vma *pvalue,
@@ -1098,7 +1101,12 @@ _bfd_elf_merge_symbol (bfd *abfd,
   sec = *psec;
   bind = ELF_ST_BIND (sym->st_info);
 
-  if (! bfd_is_und_section (sec))
+  if (name_hash != NULL
+      && (! bfd_is_und_section (sec) || info->wrap_hash == NULL))
+    h = ((struct elf_link_hash_entry *)
+	 bfd_hash_lookup_hashed (&elf_hash_table (info)->root.table, name,
+				 *name_hash, true, false));
+  else if (! bfd_is_und_section (sec))
     h = elf_link_hash_lookup (elf_hash_table (info), name, true, false, false);
   else
     h = ((struct elf_link_hash_entry *)
@@ -1944,9 +1952,10 @@ _bfd_elf_add_default_symbol (bfd *abfd,
   size_change_ok = false;
   matched = true;
   tmp_sec = sec;
-  if (!_bfd_elf_merge_symbol (abfd, info, shortname, sym, &tmp_sec, &value,
-			      &hi, poldbfd, NULL, NULL, &skip, &override,
-			      &type_change_ok, &size_change_ok, &matched))
+  if (!_bfd_elf_merge_symbol (abfd, info, shortname, NULL, sym, &tmp_sec,
+			      &value, &hi, poldbfd, NULL, NULL, &skip,
+			      &override, &type_change_ok, &size_change_ok,
+			      &matched))
     return false;
 
   if (skip)
@@ -2103,9 +2112,10 @@ _bfd_elf_add_default_symbol (bfd *abfd,
   type_change_ok = false;
   size_change_ok = false;
   tmp_sec = sec;
-  if (!_bfd_elf_merge_symbol (abfd, info, shortname, sym, &tmp_sec, &value,
-			      &hi, poldbfd, NULL, NULL, &skip, &override,
-			      &type_change_ok, &size_change_ok, &matched))
+  if (!_bfd_elf_merge_symbol (abfd, info, shortname, NULL, sym, &tmp_sec,
+			      &value, &hi, poldbfd, NULL, NULL, &skip,
+			      &override, &type_change_ok, &size_change_ok,
+			      &matched))
     return false;
 
   if (skip)
@@ -4193,6 +4203,59 @@ _bfd_elf_link_check_relocs (bfd *abfd, struct bfd_link_info *info)
   return true;
 }
 
+/* How many symbols ahead elf_link_add_object_symbols starts fetching
+   the hash table slot of a symbol it is about to look up.  */
+#define ELF_HASH_PREFETCH 16
+
+/* Return a malloc'd array of the hash codes of the names of the
+   COUNT symbols ISYMBUF read from the symbol table HDR of ABFD, or
+   NULL if the names cannot be read without complaint.  Problems with
+   individual names are left to be diagnosed when the symbols are
+   added.  */
+
+static unsigned long *
+elf_link_hash_symbol_names (bfd *abfd, Elf_Internal_Shdr *hdr,
+			    Elf_Internal_Sym *isymbuf, size_t count)
+{
+  Elf_Internal_Shdr *strhdr;
+  unsigned long *hashes;
+  unsigned long empty;
+  size_t i;
+
+  if (elf_elfsections (abfd) == NULL
+      || hdr->sh_link >= elf_numsections (abfd))
+    return NULL;
+  strhdr = elf_elfsections (abfd)[hdr->sh_link];
+  if (strhdr->contents == NULL
+      && (strhdr->sh_type != SHT_STRTAB
+	  || bfd_elf_get_str_section (abfd, hdr->sh_link) == NULL))
+    return NULL;
+  if (strhdr->sh_size == 0
+      || strhdr->contents[strhdr->sh_size - 1] != 0)
+    return NULL;
+
+  hashes = (unsigned long *) bfd_malloc (count * sizeof (*hashes));
+  if (hashes == NULL)
+    return NULL;
+
+  empty = bfd_hash_value ("");
+  for (i = 0; i < count; i++)
+    {
+      unsigned long st_name = isymbuf[i].st_name;
+
+      if (ELF_ST_BIND (isymbuf[i].st_info) == STB_LOCAL)
+	hashes[i] = 0;
+      else if (st_name == 0)
+	hashes[i] = empty;
+      else if (st_name < strhdr->sh_size)
+	hashes[i] = bfd_hash_value ((const char *) strhdr->contents + st_name);
+      else
+	hashes[i] = 0;
+    }
+
+  return hashes;
+}
+
 /* Add symbols from an ELF object file to the linker hash table.  */
 
 static bool
@@ -4214,6 +4277,7 @@ elf_link_add_object_symbols (bfd *abfd, struct bfd_link_info *info)
   Elf_Internal_Sym *isymbuf = NULL;
   Elf_Internal_Sym *isym;
   Elf_Internal_Sym *isymend;
+  unsigned long *name_hashes = NULL;
   const struct elf_backend_data *bed;
   bool add_needed;
   struct elf_link_hash_table *htab;
@@ -4627,6 +4691,12 @@ elf_link_add_object_symbols (bfd *abfd, struct bfd_link_info *info)
 	    goto error_free_sym;
 	  elf_sym_hashes (abfd) = sym_hash;
 	}
+
+      /* Hash all the symbol names in one pass, so that the loop below
+	 can start fetching a symbol's hash table slot some way ahead
+	 of looking it up.  */
+      name_hashes = elf_link_hash_symbol_names (abfd, hdr, isymbuf,
+						extsymcount);
     }
 
   if (dynamic)
@@ -4783,9 +4853,16 @@ elf_link_add_object_symbols (bfd *abfd, struct bfd_link_info *info)
       unsigned int shindex;
       bfd *old_bfd;
       bool matched;
+      const unsigned long *name_hash;
+      const char *strtab_name;
 
       override = NULL;
 
+      if (name_hashes != NULL
+	  && (size_t) (isym - isymbuf) + ELF_HASH_PREFETCH < extsymcount)
+	bfd_hash_prefetch (&htab->root.table,
+			   name_hashes[isym - isymbuf + ELF_HASH_PREFETCH]);
+
       flags = BSF_NO_FLAGS;
       sec = NULL;
       value = isym->st_value;
@@ -4876,6 +4953,7 @@ elf_link_add_object_symbols (bfd *abfd, struct bfd_link_info *info)
 					      isym->st_name);
       if (name == NULL)
 	goto error_free_vers;
+      strtab_name = name;
 
       if (isym->st_shndx == SHN_COMMON
 	  && (abfd->flags & BFD_PLUGIN) != 0)
@@ -4924,6 +5002,12 @@ elf_link_add_object_symbols (bfd *abfd, struct bfd_link_info *info)
       if (sec == NULL)
 	abort ();
 
+      /* NAME_HASHES are of the names in the string table, and the
+	 add_symbol_hook may have changed NAME.  */
+      name_hash = NULL;
+      if (name_hashes != NULL && name == strtab_name)
+	name_hash = &name_hashes[isym - isymbuf];
+
       /* Silently discard TLS symbols from --just-syms.  There's
 	 no way to combine a static TLS block with a new TLS block
 	 for this executable.  */
@@ -5066,6 +5150,7 @@ elf_link_add_object_symbols (bfd *abfd, struct bfd_link_info *info)
 	      memcpy (p, verstr, verlen + 1);
 
 	      name = newname;
+	      name_hash = NULL;
 	    }
 
 	  /* If this symbol has default visibility and the user has
@@ -5077,11 +5162,11 @@ elf_link_add_object_symbols (bfd *abfd, struct bfd_link_info *info)
 	    isym->st_other = (STV_HIDDEN
 			      | (isym->st_other & ~ELF_ST_VISIBILITY (-1)));
 
-	  if (!_bfd_elf_merge_symbol (abfd, info, name, isym, &sec, &value,
-				      sym_hash, &old_bfd, &old_weak,
-				      &old_alignment, &skip, &override,
-				      &type_change_ok, &size_change_ok,
-				      &matched))
+	  if (!_bfd_elf_merge_symbol (abfd, info, name, name_hash, isym,
+				      &sec, &value, sym_hash, &old_bfd,
+				      &old_weak, &old_alignment, &skip,
+				      &override, &type_change_ok,
+				      &size_change_ok, &matched))
 	    goto error_free_vers;
 
 	  if (skip)
@@ -5538,6 +5623,8 @@ elf_link_add_object_symbols (bfd *abfd, struct bfd_link_info *info)
   extversym = NULL;
   free (isymbuf);
   isymbuf = NULL;
+  free (name_hashes);
+  name_hashes = NULL;
 
   if ((elf_dyn_lib_class (abfd) & DYN_AS_NEEDED) != 0)
     {
@@ -5887,6 +5974,7 @@ elf_link_add_object_symbols (bfd *abfd, struct bfd_link_info *info)
   free (nondeflt_vers);
   free (extversym);
  error_free_sym:
+  free (name_hashes);
   free (isymbuf);
  error_return:
   return false;
@@ -8099,6 +8187,844 @@ _bfd_elf_link_hash_table_create (bfd *abfd)
   return &ret->root;
 }
 
+/* Support for building a DWARF 5 .debug_names index at link time.
+   The names are read from the .debug_info of every input when the
+   inputs have been opened, and stored in a .debug_str fragment so
+   that they are merged into the output string table.  The index is
+   sized once the discarded sections are known and written by
+   bfd_elf_final_link once the units and strings have their final
+   offsets.  */
+
+/* A compilation or type unit in a .debug_info input section.  */
+
+struct elf_debug_names_unit
+{
+  /* The input section holding the unit, and its offset there.  */
+  asection *sec;
+  bfd_vma offset;
+
+  /* Whether this is a type unit rather than a compilation unit.  */
+  bool is_type_unit;
+
+  /* Whether the unit is part of the output.  */
+  bool kept;
+
+  /* The index of the unit in the CU or TU list.  */
+  unsigned int index;
+};
+
+/* One index entry for a name.  */
+
+struct elf_debug_names_entry
+{
+  /* The unit holding the DIE, as an index into the units array.  */
+  unsigned int unit;
+
+  /* The index abbreviation used for the entry.  */
+  unsigned int abbrev;
+
+  /* The DW_TAG_* of the DIE and its offset in the unit.  */
+  unsigned int tag;
+  bfd_vma die_offset;
+
+  bool is_static;
+
+  /* The next entry for the same name, plus one.  */
+  unsigned int next;
+};
+
+/* An entry in the name hash table.  */
+
+struct elf_debug_names_name
+{
+  struct bfd_hash_entry root;
+
+  /* The offset of the name in the .debug_str fragment.  */
+  bfd_size_type str_offset;
+
+  /* The DWARF 5 hash of the name.  */
+  uint32_t hash;
+
+  /* The first and last entries for the name, plus one.  */
+  unsigned int first_entry;
+  unsigned int last_entry;
+};
+
+struct elf_debug_names_info
+{
+  struct bfd_hash_table names;
+
+  struct elf_debug_names_unit *units;
+  unsigned int num_units;
+  unsigned int alloc_units;
+
+  struct elf_debug_names_entry *entries;
+  unsigned int num_entries;
+  unsigned int alloc_entries;
+
+  /* The contents of the .debug_str fragment.  */
+  bfd_byte *strings;
+  bfd_size_type strings_size;
+  bfd_size_type strings_alloc;
+
+  /* The output .debug_names and the .debug_str fragment.  */
+  asection *sec;
+  asection *str_sec;
+
+  /* The names in the index, in hash table order, and the number of
+     hash buckets.  Set by _bfd_elf_size_debug_names.  */
+  struct elf_debug_names_name **sorted;
+  unsigned int name_count;
+  unsigned int bucket_count;
+  unsigned int cu_count;
+  unsigned int tu_count;
+
+  /* The number of bytes used for each unit index in the entry pool.  */
+  unsigned int unit_index_size;
+
+  /* The encoded abbreviation table.  */
+  bfd_byte *abbrevs;
+  bfd_size_type abbrevs_size;
+};
+
+/* The augmentation string marking the DW_IDX_GNU_internal and
+   DW_IDX_GNU_external extension.  */
+static const char debug_names_augmentation[4] = "GDB";
+
+static struct bfd_hash_entry *
+debug_names_name_newfunc (struct bfd_hash_entry *entry,
+			  struct bfd_hash_table *table,
+			  const char *string)
+{
+  struct elf_debug_names_name *ret = (struct elf_debug_names_name *) entry;
+
+  if (ret == NULL)
+    {
+      ret = (struct elf_debug_names_name *)
+	bfd_hash_allocate (table, sizeof (*ret));
+      if (ret == NULL)
+	return NULL;
+    }
+
+  ret = ((struct elf_debug_names_name *)
+	 bfd_hash_newfunc ((struct bfd_hash_entry *) ret, table, string));
+  if (ret != NULL)
+    {
+      ret->str_offset = 0;
+      ret->hash = 0;
+      ret->first_entry = 0;
+      ret->last_entry = 0;
+    }
+  return (struct bfd_hash_entry *) ret;
+}
+
+/* The DWARF 5 name hash: DJB hash of the case folded name.  */
+
+static uint32_t
+debug_names_hash (const char *name)
+{
+  const unsigned char *p = (const unsigned char *) name;
+  uint32_t hash = 5381;
+
+  while (*p != 0)
+    hash = hash * 33 + TOLOWER (*p++);
+  return hash;
+}
+
+/* Return the tag to record for a DIE with TAG.  gdb only looks for
+   these few tags in an index carrying its augmentation string, so
+   map the others the way gdb's own index writer does.  */
+
+static unsigned int
+debug_names_tag (unsigned int tag)
+{
+  switch (tag)
+    {
+    case DW_TAG_module:
+    case DW_TAG_subprogram:
+    case DW_TAG_typedef:
+    case DW_TAG_variable:
+      return tag;
+    case DW_TAG_constant:
+    case DW_TAG_enumerator:
+      return DW_TAG_variable;
+    default:
+      return DW_TAG_structure_type;
+    }
+}
+
+static bool
+debug_names_add_unit (void *data, asection *sec, bfd_vma offset,
+		      bool is_type_unit)
+{
+  struct elf_debug_names_info *dn = (struct elf_debug_names_info *) data;
+  struct elf_debug_names_unit *unit;
+
+  if (dn->num_units == dn->alloc_units)
+    {
+      unsigned int alloc = dn->alloc_units ? dn->alloc_units * 2 : 64;
+      struct elf_debug_names_unit *units;
+
+      units = bfd_realloc (dn->units, alloc * sizeof (*units));
+      if (units == NULL)
+	return false;
+      dn->units = units;
+      dn->alloc_units = alloc;
+    }
+
+  unit = &dn->units[dn->num_units++];
+  unit->sec = sec;
+  unit->offset = offset;
+  unit->is_type_unit = is_type_unit;
+  unit->kept = false;
+  unit->index = 0;
+  return true;
+}
+
+static bool
+debug_names_add_name (void *data, const char *name, unsigned int tag,
+		      bfd_vma die_offset, bool is_static)
+{
+  struct elf_debug_names_info *dn = (struct elf_debug_names_info *) data;
+  struct elf_debug_names_name *h;
+  struct elf_debug_names_entry *entry;
+
+  h = ((struct elf_debug_names_name *)
+       bfd_hash_lookup (&dn->names, name, true, true));
+  if (h == NULL)
+    return false;
+
+  if (h->first_entry == 0)
+    {
+      size_t len = strlen (name) + 1;
+
+      if (dn->strings_size + len > dn->strings_alloc)
+	{
+	  bfd_size_type alloc = dn->strings_alloc ? dn->strings_alloc : 4096;
+	  bfd_byte *strings;
+
+	  while (dn->strings_size + len > alloc)
+	    alloc *= 2;
+	  strings = bfd_realloc (dn->strings, alloc);
+	  if (strings == NULL)
+	    return false;
+	  dn->strings = strings;
+	  dn->strings_alloc = alloc;
+	}
+      memcpy (dn->strings + dn->strings_size, name, len);
+      h->str_offset = dn->strings_size;
+      h->hash = debug_names_hash (name);
+      dn->strings_size += len;
+    }
+
+  if (dn->num_entries == dn->alloc_entries)
+    {
+      unsigned int alloc = dn->alloc_entries ? dn->alloc_entries * 2 : 1024;
+      struct elf_debug_names_entry *entries;
+
+      entries = bfd_realloc (dn->entries, alloc * sizeof (*entries));
+      if (entries == NULL)
+	return false;
+      dn->entries = entries;
+      dn->alloc_entries = alloc;
+    }
+
+  entry = &dn->entries[dn->num_entries++];
+  entry->unit = dn->num_units - 1;
+  entry->abbrev = 0;
+  entry->tag = debug_names_tag (tag);
+  entry->die_offset = die_offset;
+  entry->is_static = is_static;
+  entry->next = 0;
+  if (h->last_entry != 0)
+    dn->entries[h->last_entry - 1].next = dn->num_entries;
+  else
+    h->first_entry = dn->num_entries;
+  h->last_entry = dn->num_entries;
+  return true;
+}
+
+static void
+debug_names_free (struct elf_debug_names_info *dn)
+{
+  if (dn == NULL)
+    return;
+  bfd_hash_table_free (&dn->names);
+  free (dn->units);
+  free (dn->entries);
+  free (dn->sorted);
+  free (dn->abbrevs);
+  free (dn->strings);
+  free (dn);
+}
+
+/* Drop the index, leaving its empty sections out of the output.  */
+
+static void
+debug_names_disable (struct elf_link_hash_table *htab)
+{
+  struct elf_debug_names_info *dn = htab->debug_names;
+
+  dn->sec->size = 0;
+  dn->sec->flags |= SEC_EXCLUDE;
+  htab->debug_names = NULL;
+  debug_names_free (dn);
+}
+
+/* Read the names for a .debug_names index from the .debug_info of each
+   input, and create the .debug_names section and the .debug_str
+   fragment holding the names in IBFD.  Input .debug_names sections are
+   discarded, since they are superseded by the new index.  Return FALSE
+   on error.  If the inputs cannot be indexed, a warning is given and
+   no index is built.  */
+
+bool
+_bfd_elf_setup_debug_names (bfd *ibfd, struct bfd_link_info *info)
+{
+  struct elf_link_hash_table *htab = elf_hash_table (info);
+  struct elf_debug_names_info *dn;
+  flagword flags;
+  bfd *abfd;
+  bool ok;
+
+  if (!is_elf_hash_table (&htab->root)
+      || bfd_link_relocatable (info)
+      || htab->debug_names != NULL)
+    return true;
+
+  dn = (struct elf_debug_names_info *) bfd_zmalloc (sizeof (*dn));
+  if (dn == NULL)
+    return false;
+  if (!bfd_hash_table_init (&dn->names, debug_names_name_newfunc,
+			    sizeof (struct elf_debug_names_name)))
+    {
+      free (dn);
+      return false;
+    }
+
+  for (abfd = info->input_bfds; abfd != NULL; abfd = abfd->link.next)
+    {
+      asection *s;
+
+      if (bfd_get_flavour (abfd) != bfd_target_elf_flavour
+	  || (abfd->flags & (DYNAMIC | BFD_PLUGIN)) != 0
+	  || elf_tdata (abfd) == NULL)
+	continue;
+
+      for (s = abfd->sections; s != NULL; s = s->next)
+	if (strcmp (s->name, ".debug_names") == 0)
+	  s->flags |= SEC_EXCLUDE;
+
+      if (bfd_get_section_by_name (abfd, ".debug_types") != NULL)
+	{
+	  info->callbacks->einfo
+	    (_("%P: warning: %pB: .debug_types is not supported by "
+	       "--debug-names; no .debug_names section generated\n"), abfd);
+	  debug_names_free (dn);
+	  return true;
+	}
+
+      ok = bfd_generic_link_read_symbols (abfd);
+      if (ok)
+	{
+	  void **pinfo = &elf_tdata (abfd)->dwarf2_find_line_info;
+
+	  ok = _bfd_dwarf2_scan_index_names (abfd, bfd_get_outsymbols (abfd),
+					     pinfo, debug_names_add_unit,
+					     debug_names_add_name, dn);
+
+	  /* The names have been copied, so free the debug info read for
+	     them rather than keep that of every input for the rest of
+	     the link.  It is read again if anything else needs it.  */
+	  _bfd_dwarf2_cleanup_debug_info (abfd, pinfo);
+	  *pinfo = NULL;
+	}
+      if (!ok)
+	{
+	  info->callbacks->einfo
+	    (_("%P: warning: %pB: cannot read debug info for "
+	       "--debug-names; no .debug_names section generated\n"), abfd);
+	  debug_names_free (dn);
+	  return true;
+	}
+    }
+
+  if (dn->num_entries == 0)
+    {
+      debug_names_free (dn);
+      return true;
+    }
+
+  flags = (SEC_HAS_CONTENTS | SEC_IN_MEMORY | SEC_LINKER_CREATED
+	   | SEC_DEBUGGING | SEC_KEEP);
+  dn->sec = bfd_make_section_anyway_with_flags (ibfd, ".debug_names", flags);
+  flags = (SEC_HAS_CONTENTS | SEC_IN_MEMORY | SEC_MERGE | SEC_STRINGS
+	   | SEC_DEBUGGING | SEC_KEEP);
+  dn->str_sec = bfd_make_section_anyway_with_flags (ibfd, ".debug_str",
+						    flags);
+  if (dn->sec == NULL || dn->str_sec == NULL)
+    {
+      debug_names_free (dn);
+      return false;
+    }
+  elf_section_type (dn->sec) = SHT_PROGBITS;
+  elf_section_type (dn->str_sec) = SHT_PROGBITS;
+  elf_section_flags (dn->str_sec) = SHF_MERGE | SHF_STRINGS;
+  dn->str_sec->entsize = 1;
+  dn->str_sec->contents = (bfd_byte *) bfd_alloc (ibfd, dn->strings_size);
+  if (dn->str_sec->contents == NULL)
+    {
+      debug_names_free (dn);
+      return false;
+    }
+  memcpy (dn->str_sec->contents, dn->strings, dn->strings_size);
+  dn->str_sec->size = dn->strings_size;
+  free (dn->strings);
+  dn->strings = NULL;
+
+  htab->debug_names = dn;
+  return true;
+}
+
+/* Return the number of bytes of a ULEB128 encoding of VALUE.  */
+
+static unsigned int
+debug_names_uleb128_size (bfd_vma value)
+{
+  unsigned int size = 1;
+
+  while ((value >>= 7) != 0)
+    size++;
+  return size;
+}
+
+/* Write VALUE as a ULEB128 number padded to SIZE bytes at P, and
+   return the byte after it.  */
+
+static bfd_byte *
+debug_names_put_uleb128 (bfd_byte *p, bfd_vma value, unsigned int size)
+{
+  for (; size > 1; size--)
+    {
+      *p++ = (value & 0x7f) | 0x80;
+      value >>= 7;
+    }
+  *p++ = value & 0x7f;
+  return p;
+}
+
+/* A name to be sorted into hash table order, with its bucket.  */
+
+struct debug_names_sort_entry
+{
+  uint32_t bucket;
+  struct elf_debug_names_name *name;
+};
+
+/* Sort names by bucket, then hash, then string.  */
+
+static int
+debug_names_compare (const void *a, const void *b)
+{
+  const struct debug_names_sort_entry *sa
+    = (const struct debug_names_sort_entry *) a;
+  const struct debug_names_sort_entry *sb
+    = (const struct debug_names_sort_entry *) b;
+  const struct elf_debug_names_name *na = sa->name;
+  const struct elf_debug_names_name *nb = sb->name;
+
+  if (sa->bucket != sb->bucket)
+    return sa->bucket < sb->bucket ? -1 : 1;
+  if (na->hash != nb->hash)
+    return na->hash < nb->hash ? -1 : 1;
+  return strcmp (na->root.string, nb->root.string);
+}
+
+/* Add the name H to the sorted array if any of its entries is for a
+   unit in the output.  */
+
+static bool
+debug_names_collect_name (struct bfd_hash_entry *bh, void *data)
+{
+  struct elf_debug_names_name *h = (struct elf_debug_names_name *) bh;
+  struct elf_debug_names_info *dn = (struct elf_debug_names_info *) data;
+  unsigned int i;
+
+  for (i = h->first_entry; i != 0; i = dn->entries[i - 1].next)
+    if (dn->units[dn->entries[i - 1].unit].kept)
+      {
+	dn->sorted[dn->name_count++] = h;
+	break;
+      }
+  return true;
+}
+
+/* Size the .debug_names section.  This is called once the discarded
+   input sections are known, but before sections are laid out.  */
+
+bool
+_bfd_elf_size_debug_names (bfd *obfd ATTRIBUTE_UNUSED,
+			   struct bfd_link_info *info)
+{
+  struct elf_link_hash_table *htab = elf_hash_table (info);
+  struct elf_debug_names_info *dn;
+  asection *info_output = NULL;
+  struct debug_names_sort_entry *sort;
+  unsigned int *abbrev_tags = NULL;
+  unsigned int num_abbrevs = 0, alloc_abbrevs = 0;
+  unsigned int i, pass, max_units;
+  bfd_size_type pool_size, size;
+  bfd_byte *p;
+
+  if (!is_elf_hash_table (&htab->root) || htab->debug_names == NULL)
+    return true;
+  dn = htab->debug_names;
+
+  for (i = 0; i < dn->num_units; i++)
+    {
+      struct elf_debug_names_unit *unit = &dn->units[i];
+      asection *sec = unit->sec;
+
+      if (sec->output_section == NULL
+	  || bfd_is_abs_section (sec->output_section)
+	  || (sec->flags & SEC_EXCLUDE) != 0
+	  || discarded_section (sec))
+	continue;
+
+      /* The unit offsets are only meaningful if all the units end up
+	 in one output .debug_info.  */
+      if (info_output == NULL)
+	info_output = sec->output_section;
+      else if (info_output != sec->output_section)
+	{
+	  info->callbacks->einfo
+	    (_("%P: warning: debug info is split over several output "
+	       "sections; no .debug_names section generated\n"));
+	  debug_names_disable (htab);
+	  return true;
+	}
+      unit->kept = true;
+      if (unit->is_type_unit)
+	dn->tu_count++;
+      else
+	dn->cu_count++;
+    }
+
+  if (dn->cu_count == 0
+      || dn->str_sec->output_section == NULL
+      || bfd_is_abs_section (dn->str_sec->output_section))
+    {
+      debug_names_disable (htab);
+      return true;
+    }
+
+  dn->sorted = (struct elf_debug_names_name **)
+    bfd_malloc (dn->names.count * sizeof (*dn->sorted));
+  if (dn->sorted == NULL)
+    return false;
+  bfd_hash_traverse (&dn->names, debug_names_collect_name, dn);
+  if (dn->name_count == 0)
+    {
+      debug_names_disable (htab);
+      return true;
+    }
+
+  /* Use a power of two number of buckets, with the hash table at most
+     three quarters full.  */
+  dn->bucket_count = 1;
+  while ((bfd_size_type) dn->bucket_count * 3
+	 < (bfd_size_type) dn->name_count * 4)
+    dn->bucket_count *= 2;
+  sort = (struct debug_names_sort_entry *)
+    bfd_malloc (dn->name_count * sizeof (*sort));
+  if (sort == NULL)
+    return false;
+  for (i = 0; i < dn->name_count; i++)
+    {
+      sort[i].bucket = dn->sorted[i]->hash % dn->bucket_count;
+      sort[i].name = dn->sorted[i];
+    }
+  qsort (sort, dn->name_count, sizeof (*sort), debug_names_compare);
+  for (i = 0; i < dn->name_count; i++)
+    dn->sorted[i] = sort[i].name;
+  free (sort);
+
+  max_units = dn->cu_count > dn->tu_count ? dn->cu_count : dn->tu_count;
+  dn->unit_index_size = debug_names_uleb128_size (max_units - 1);
+
+  /* Assign an abbreviation to each combination of tag, unit kind and
+     linkage, in the order the entries are written, and size the entry
+     pool.  */
+  pool_size = 0;
+  for (i = 0; i < dn->name_count; i++)
+    {
+      unsigned int e;
+
+      for (e = dn->sorted[i]->first_entry; e != 0; e = dn->entries[e - 1].next)
+	{
+	  struct elf_debug_names_entry *entry = &dn->entries[e - 1];
+	  unsigned int key, code;
+
+	  if (!dn->units[entry->unit].kept)
+	    continue;
+
+	  key = ((entry->tag << 2)
+		 | (dn->units[entry->unit].is_type_unit << 1)
+		 | entry->is_static);
+	  for (code = 0; code < num_abbrevs; code++)
+	    if (abbrev_tags[code] == key)
+	      break;
+	  if (code == num_abbrevs)
+	    {
+	      if (num_abbrevs == alloc_abbrevs)
+		{
+		  unsigned int *tags;
+
+		  alloc_abbrevs = alloc_abbrevs * 2 + 16;
+		  tags = bfd_realloc (abbrev_tags,
+				      alloc_abbrevs * sizeof (*tags));
+		  if (tags == NULL)
+		    {
+		      free (abbrev_tags);
+		      return false;
+		    }
+		  abbrev_tags = tags;
+		}
+	      abbrev_tags[num_abbrevs++] = key;
+	    }
+	  entry->abbrev = code + 1;
+	  pool_size += (debug_names_uleb128_size (entry->abbrev)
+			+ dn->unit_index_size + 4);
+	}
+      /* The terminating zero abbreviation code.  */
+      pool_size += 1;
+    }
+
+  /* Each abbreviation has a code, a tag, a unit index, a DIE offset
+     and a linkage flag, followed by a zero index and form.  The table
+     ends with a zero code.  */
+  dn->abbrevs_size = 0;
+  for (pass = 0; pass < 2; pass++)
+    {
+      bfd_vma abbrev[10];
+
+      p = dn->abbrevs;
+      size = 0;
+      for (i = 0; i <= num_abbrevs; i++)
+	{
+	  unsigned int key = i < num_abbrevs ? abbrev_tags[i] : 0;
+	  unsigned int j, count;
+
+	  if (i < num_abbrevs)
+	    {
+	      abbrev[0] = i + 1;
+	      abbrev[1] = key >> 2;
+	      abbrev[2] = ((key & 2) != 0
+			   ? DW_IDX_type_unit : DW_IDX_compile_unit);
+	      abbrev[3] = DW_FORM_udata;
+	      abbrev[4] = DW_IDX_die_offset;
+	      abbrev[5] = DW_FORM_ref4;
+	      abbrev[6] = ((key & 1) != 0
+			   ? DW_IDX_GNU_internal : DW_IDX_GNU_external);
+	      abbrev[7] = DW_FORM_flag_present;
+	      abbrev[8] = 0;
+	      abbrev[9] = 0;
+	      count = 10;
+	    }
+	  else
+	    {
+	      abbrev[0] = 0;
+	      count = 1;
+	    }
+
+	  for (j = 0; j < count; j++)
+	    {
+	      unsigned int len = debug_names_uleb128_size (abbrev[j]);
+
+	      if (p != NULL)
+		p = debug_names_put_uleb128 (p, abbrev[j], len);
+	      size += len;
+	    }
+	}
+
+      if (pass == 0)
+	{
+	  dn->abbrevs_size = size;
+	  dn->abbrevs = (bfd_byte *) bfd_malloc (size);
+	  if (dn->abbrevs == NULL)
+	    {
+	      free (abbrev_tags);
+	      return false;
+	    }
+	}
+    }
+  BFD_ASSERT ((bfd_size_type) (p - dn->abbrevs) == dn->abbrevs_size);
+  free (abbrev_tags);
+
+  size = (4 + 2 + 2 + 7 * 4 + sizeof (debug_names_augmentation)
+	  + (dn->cu_count + dn->tu_count) * 4
+	  + dn->bucket_count * 4
+	  + dn->name_count * 4 * 3
+	  + dn->abbrevs_size
+	  + pool_size);
+  dn->sec->size = size;
+  return true;
+}
+
+/* Sort units by their position in the output.  */
+
+static int
+debug_names_compare_units (const void *a, const void *b)
+{
+  const struct elf_debug_names_unit *ua
+    = *(const struct elf_debug_names_unit *const *) a;
+  const struct elf_debug_names_unit *ub
+    = *(const struct elf_debug_names_unit *const *) b;
+  bfd_vma oa = ua->sec->output_offset + ua->offset;
+  bfd_vma ob = ub->sec->output_offset + ub->offset;
+
+  if (oa != ob)
+    return oa < ob ? -1 : 1;
+  return 0;
+}
+
+/* Write out the .debug_names section sized by
+   _bfd_elf_size_debug_names.  */
+
+static bool
+elf_write_debug_names (bfd *obfd, struct bfd_link_info *info)
+{
+  struct elf_link_hash_table *htab = elf_hash_table (info);
+  struct elf_debug_names_info *dn = htab->debug_names;
+  struct elf_debug_names_unit **units;
+  bfd_byte *contents, *p, *pool;
+  bfd_byte *buckets, *hashes, *str_offsets, *entry_offsets;
+  unsigned int i, n, cu_index, tu_index;
+  uint32_t prev_bucket;
+  bool ret = false;
+
+  if (dn == NULL)
+    return true;
+
+  units = (struct elf_debug_names_unit **)
+    bfd_malloc ((dn->cu_count + dn->tu_count) * sizeof (*units));
+  contents = (bfd_byte *) bfd_zmalloc (dn->sec->size);
+  if (units == NULL || contents == NULL)
+    goto out;
+
+  for (i = n = 0; i < dn->num_units; i++)
+    if (dn->units[i].kept)
+      units[n++] = &dn->units[i];
+  qsort (units, n, sizeof (*units), debug_names_compare_units);
+
+  /* Header.  */
+  p = contents;
+  bfd_put_32 (obfd, dn->sec->size - 4, p);
+  bfd_put_16 (obfd, 5, p + 4);
+  bfd_put_16 (obfd, 0, p + 6);
+  bfd_put_32 (obfd, dn->cu_count, p + 8);
+  bfd_put_32 (obfd, dn->tu_count, p + 12);
+  bfd_put_32 (obfd, 0, p + 16);
+  bfd_put_32 (obfd, dn->bucket_count, p + 20);
+  bfd_put_32 (obfd, dn->name_count, p + 24);
+  bfd_put_32 (obfd, dn->abbrevs_size, p + 28);
+  bfd_put_32 (obfd, sizeof (debug_names_augmentation), p + 32);
+  memcpy (p + 36, debug_names_augmentation,
+	  sizeof (debug_names_augmentation));
+  p += 36 + sizeof (debug_names_augmentation);
+
+  /* The CU list followed by the TU list, each in output order.  */
+  cu_index = tu_index = 0;
+  for (i = 0; i < n; i++)
+    if (!units[i]->is_type_unit)
+      {
+	bfd_vma offset = units[i]->sec->output_offset + units[i]->offset;
+
+	if (offset > 0xffffffff)
+	  goto too_big;
+	units[i]->index = cu_index++;
+	bfd_put_32 (obfd, offset, p);
+	p += 4;
+      }
+  for (i = 0; i < n; i++)
+    if (units[i]->is_type_unit)
+      {
+	bfd_vma offset = units[i]->sec->output_offset + units[i]->offset;
+
+	if (offset > 0xffffffff)
+	  goto too_big;
+	units[i]->index = tu_index++;
+	bfd_put_32 (obfd, offset, p);
+	p += 4;
+      }
+
+  buckets = p;
+  hashes = buckets + dn->bucket_count * 4;
+  str_offsets = hashes + dn->name_count * 4;
+  entry_offsets = str_offsets + dn->name_count * 4;
+  p = entry_offsets + dn->name_count * 4;
+  memcpy (p, dn->abbrevs, dn->abbrevs_size);
+  pool = p + dn->abbrevs_size;
+
+  prev_bucket = -1u;
+  p = pool;
+  for (i = 0; i < dn->name_count; i++)
+    {
+      struct elf_debug_names_name *h = dn->sorted[i];
+      uint32_t bucket = h->hash % dn->bucket_count;
+      asection *str_sec = dn->str_sec;
+      bfd_vma str_offset = h->str_offset;
+      unsigned int e;
+
+      /* The hashes array is indexed from one.  */
+      if (bucket != prev_bucket)
+	bfd_put_32 (obfd, i + 1, buckets + bucket * 4);
+      prev_bucket = bucket;
+      bfd_put_32 (obfd, h->hash, hashes + i * 4);
+
+      if (str_sec->sec_info_type == SEC_INFO_TYPE_MERGE)
+	str_offset = _bfd_merged_section_offset
+	  (obfd, &str_sec, elf_section_data (str_sec)->sec_info, str_offset);
+      str_offset += str_sec->output_offset;
+      if (str_offset > 0xffffffff)
+	goto too_big;
+      bfd_put_32 (obfd, str_offset, str_offsets + i * 4);
+      bfd_put_32 (obfd, p - pool, entry_offsets + i * 4);
+
+      for (e = h->first_entry; e != 0; e = dn->entries[e - 1].next)
+	{
+	  struct elf_debug_names_entry *entry = &dn->entries[e - 1];
+	  struct elf_debug_names_unit *unit = &dn->units[entry->unit];
+
+	  if (!unit->kept)
+	    continue;
+	  if (entry->die_offset > 0xffffffff)
+	    goto too_big;
+	  p = debug_names_put_uleb128
+	    (p, entry->abbrev, debug_names_uleb128_size (entry->abbrev));
+	  p = debug_names_put_uleb128 (p, unit->index, dn->unit_index_size);
+	  bfd_put_32 (obfd, entry->die_offset, p);
+	  p += 4;
+	}
+      *p++ = 0;
+    }
+  BFD_ASSERT ((bfd_size_type) (p - contents) == dn->sec->size);
+
+  ret = bfd_set_section_contents (obfd, dn->sec->output_section, contents,
+				  dn->sec->output_offset, dn->sec->size);
+  goto out;
+
+ too_big:
+  _bfd_error_handler (_("%pB: debug info too large for 32-bit "
+			".debug_names offsets"), obfd);
+  bfd_set_error (bfd_error_file_too_big);
+
+ out:
+  free (units);
+  free (contents);
+  return ret;
+}
+
 /* Destroy an ELF linker hash table.  */
 
 void
@@ -8110,6 +9036,7 @@ _bfd_elf_link_hash_table_free (bfd *obfd)
   if (htab->dynstr != NULL)
     _bfd_elf_strtab_free (htab->dynstr);
   _bfd_merge_sections_free (htab->merge_info);
+  debug_names_free (htab->debug_names);
   _bfd_generic_link_hash_table_free (obfd);
 }
 
@@ -13462,6 +14389,9 @@ bfd_elf_final_link (bfd *abfd, struct bfd_link_info *info)
   if (! _bfd_elf_write_section_sframe (abfd, info))
     goto error_return;
 
+  if (! elf_write_debug_names (abfd, info))
+    goto error_return;
+
   if (info->callbacks->emit_ctf)
       info->callbacks->emit_ctf ();
 
@@ -122,6 +122,15 @@ SUBSECTION
 	deallocate or modify the string as long as the hash table
 	exists.
 
+@findex bfd_hash_value
+@findex bfd_hash_lookup_hashed
+@findex bfd_hash_prefetch
+	A caller with many strings to look up at once may compute
+	their hash codes first with <<bfd_hash_value>>, call
+	<<bfd_hash_prefetch>> for each some way ahead of looking it up,
+	and then look it up with <<bfd_hash_lookup_hashed>>, which
+	takes the hash code rather than computing it again.
+
 INODE
 Traversing a Hash Table, Deriving a New Hash Table Type, Looking Up or Entering a String, Hash Tables
 SUBSECTION
@@ -452,20 +461,27 @@ bfd_hash_hash (const char *string, unsigned int *lenp)
   return hash;
 }
 
-/* Look up a string in a hash table.  */
+/* Return the hash code of STRING, as used by the hash tables.  */
 
-struct bfd_hash_entry *
-bfd_hash_lookup (struct bfd_hash_table *table,
-		 const char *string,
-		 bool create,
-		 bool copy)
+unsigned long
+bfd_hash_value (const char *string)
+{
+  return bfd_hash_hash (string, NULL);
+}
+
+/* Look up STRING, whose hash code is HASH and length LEN, in TABLE.  */
+
+static struct bfd_hash_entry *
+bfd_hash_lookup_1 (struct bfd_hash_table *table,
+		   const char *string,
+		   unsigned long hash,
+		   unsigned int len,
+		   bool create,
+		   bool copy)
 {
-  unsigned long hash;
   struct bfd_hash_entry *hashp;
-  unsigned int len;
   unsigned int _index;
 
-  hash = bfd_hash_hash (string, &len);
   _index = hash % table->size;
   for (hashp = table->table[_index];
        hashp != NULL;
@@ -497,6 +513,51 @@ bfd_hash_lookup (struct bfd_hash_table *table,
   return bfd_hash_insert (table, string, hash);
 }
 
+/* Look up a string in a hash table.  */
+
+struct bfd_hash_entry *
+bfd_hash_lookup (struct bfd_hash_table *table,
+		 const char *string,
+		 bool create,
+		 bool copy)
+{
+  unsigned long hash;
+  unsigned int len;
+
+  hash = bfd_hash_hash (string, &len);
+  return bfd_hash_lookup_1 (table, string, hash, len, create, copy);
+}
+
+/* Look up a string whose hash code, from bfd_hash_value, is already
+   known.  */
+
+struct bfd_hash_entry *
+bfd_hash_lookup_hashed (struct bfd_hash_table *table,
+			const char *string,
+			unsigned long hash,
+			bool create,
+			bool copy)
+{
+  unsigned int len = copy ? strlen (string) : 0;
+
+  return bfd_hash_lookup_1 (table, string, hash, len, create, copy);
+}
+
+/* Start loading the slot of TABLE where a string with hash code HASH
+   would be, so that a lookup of it a little later does not wait for
+   memory.  */
+
+void
+bfd_hash_prefetch (struct bfd_hash_table *table, unsigned long hash)
+{
+#if GCC_VERSION >= 3001
+  __builtin_prefetch (&table->table[hash % table->size]);
+#else
+  (void) table;
+  (void) hash;
+#endif
+}
+
 /* Insert an entry in a hash table.  */
 
 struct bfd_hash_entry *
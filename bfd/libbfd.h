@@ -625,6 +625,19 @@ extern bool _bfd_dwarf2_slurp_debug_info
 extern void _bfd_dwarf2_cleanup_debug_info
   (bfd *, void **) ATTRIBUTE_HIDDEN;
 
+/* Callbacks for _bfd_dwarf2_scan_index_names, called with a unit's
+   section, offset and whether it is a type unit, and with an indexed
+   name, its DW_TAG_*, unit relative DIE offset and whether it is
+   static.  */
+typedef bool (*dwarf2_index_unit_fn) (void *, asection *, bfd_vma, bool);
+typedef bool (*dwarf2_index_name_fn) (void *, const char *, unsigned int,
+				      bfd_vma, bool);
+
+/* Find the names for a DWARF 5 name index.  */
+extern bool _bfd_dwarf2_scan_index_names
+  (bfd *, asymbol **, void **, dwarf2_index_unit_fn, dwarf2_index_name_fn,
+   void *) ATTRIBUTE_HIDDEN;
+
 extern void _bfd_stab_cleanup
   (bfd *, void **) ATTRIBUTE_HIDDEN;
 
@@ -916,6 +929,9 @@ extern bfd_vma _bfd_safe_read_leb128
 extern bfd_byte * _bfd_write_unsigned_leb128
   (bfd_byte *, bfd_byte *, bfd_vma) ATTRIBUTE_HIDDEN;
 
+extern bool _bfd_compress_sections
+  (bfd *, asection **, bfd_byte **, unsigned int) ATTRIBUTE_HIDDEN;
+
 extern struct bfd_link_info *_bfd_get_link_info (bfd *);
 
 extern bool _bfd_link_keep_memory (struct bfd_link_info *)
@@ -1043,6 +1059,8 @@ bool bfd_cache_init (bfd *abfd);
 
 bool bfd_cache_close (bfd *abfd);
 
+bool bfd_cache_unmap (bfd *abfd);
+
 FILE* bfd_open_file (bfd *abfd);
 
 /* Extracted from reloc.c.  */
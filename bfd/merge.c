@@ -109,6 +109,11 @@ struct sec_merge_info
   struct sec_merge_sec_info **last;
   /* A hash table used to hold section content.  */
   struct sec_merge_hash *htab;
+  /* If the content is entered on several threads, the NSHARDS hash
+     tables that hold it instead, each for the entities whose hash
+     selects it.  HTAB then only keeps the list of all entities.  */
+  struct sec_merge_hash **shards;
+  unsigned int nshards;
 };
 
 /* Offset into input mergable sections are represented by this type.
@@ -674,6 +679,8 @@ _bfd_add_merge_section (bfd *abfd, void **psinfo, asection *sec,
       sinfo->next = (struct sec_merge_info *) *psinfo;
       sinfo->chain = NULL;
       sinfo->last = &sinfo->chain;
+      sinfo->shards = NULL;
+      sinfo->nshards = 0;
       *psinfo = sinfo;
       sinfo->htab = sec_merge_init (sec->entsize, (sec->flags & SEC_STRINGS));
       if (sinfo->htab == NULL)
@@ -693,6 +700,20 @@ _bfd_add_merge_section (bfd *abfd, void **psinfo, asection *sec,
   return false;
 }
 
+/* Return the alignment, in octets, that an entity at input offset OFS
+   of a section whose alignment mask is MASK has.  */
+
+static inline unsigned int
+entity_alignment (unsigned int ofs, bfd_vma mask)
+{
+  bfd_vma eltalign = ofs;
+
+  eltalign = ((eltalign ^ (eltalign - 1)) + 1) >> 1;
+  if (!eltalign || eltalign > mask)
+    eltalign = mask + 1;
+  return eltalign;
+}
+
 /* Record one whole input section (described by SECINFO) into the hash table
    SINFO.  */
 
@@ -703,7 +724,7 @@ record_section (struct sec_merge_info *sinfo,
   asection *sec = secinfo->sec;
   struct sec_merge_hash_entry *entry;
   unsigned char *p, *end;
-  bfd_vma mask, eltalign;
+  bfd_vma mask;
   unsigned int align;
   bfd_size_type amt;
   bfd_byte *contents;
@@ -747,12 +768,8 @@ record_section (struct sec_merge_info *sinfo,
       unsigned len;
       uint32_t hash = hashit (sinfo->htab, (char*) p, &len);
       unsigned int ofs = p - contents;
-      eltalign = ofs;
-      eltalign = ((eltalign ^ (eltalign - 1)) + 1) >> 1;
-      if (!eltalign || eltalign > mask)
-	eltalign = mask + 1;
       entry = sec_merge_hash_lookup (sinfo->htab, (char *) p, len, hash,
-				     (unsigned) eltalign);
+				     entity_alignment (ofs, mask));
       if (! entry)
 	goto error_return;
       if (! append_offsetmap (secinfo, ofs, entry))
@@ -780,6 +797,297 @@ record_section (struct sec_merge_info *sinfo,
   return false;
 }
 
+/* When more than one thread may be used, a set of input sections is
+   merged on several threads once it has at least MERGE_PARALLEL_MIN
+   octets of content.  The sections are read in batches of about
+   MERGE_BATCH_SIZE octets.  */
+#define MERGE_PARALLEL_MIN (1024 * 1024)
+#define MERGE_BATCH_SIZE (64 * 1024 * 1024)
+/* The most hash tables a set is split into.  */
+#define MERGE_MAX_SHARDS 64
+
+/* An input section of a batch being recorded on several threads.  */
+
+struct merge_batch_sec
+{
+  struct sec_merge_sec_info *secinfo;
+  bfd_byte *contents;
+  /* 'hashcode << 32 | len' of each entity, as in sec_merge_hash.  */
+  uint64_t *key_lens;
+  /* How many of the entities go into each shard.  */
+  unsigned int *shard_counts;
+  bool ok;
+};
+
+/* A batch of input sections of SINFO being recorded.  */
+
+struct merge_batch
+{
+  struct sec_merge_info *sinfo;
+  struct merge_batch_sec *secs;
+  unsigned int nsecs;
+  /* Whether the entities of the batch were entered into each shard.  */
+  bool *shard_ok;
+};
+
+/* Return the shard of SINFO that holds entities with hash HASH.  The
+   top bits are used, as the bottom ones choose the bucket.  */
+
+static inline unsigned int
+merge_shard (const struct sec_merge_info *sinfo, uint32_t hash)
+{
+  return (hash >> 24) & (sinfo->nshards - 1);
+}
+
+/* Find the entities of section I of the batch DATA, and their hashes.
+   This runs on any thread, so uses malloc rather than bfd_malloc to
+   leave bfd_error alone.  */
+
+static void
+scan_section_job (void *data, unsigned int i)
+{
+  struct merge_batch *batch = (struct merge_batch *) data;
+  struct merge_batch_sec *bs = &batch->secs[i];
+  struct sec_merge_sec_info *secinfo = bs->secinfo;
+  struct sec_merge_hash *htab = batch->sinfo->htab;
+  bfd_size_type size = secinfo->sec->size;
+  unsigned char *p, *end;
+  unsigned int n = 0, alloc = 0;
+
+  end = bs->contents + size;
+  for (p = bs->contents; p < end;)
+    {
+      unsigned int len;
+      uint32_t hash;
+
+      if (n == alloc)
+	{
+	  mapofs_type *map_ofs;
+	  uint64_t *key_lens;
+
+	  alloc = alloc ? alloc * 2 : 2048;
+	  /* Leave room for the sentinel.  */
+	  map_ofs = realloc (secinfo->map_ofs,
+			     (alloc + 1) * sizeof (secinfo->map_ofs[0]));
+	  if (map_ofs == NULL)
+	    return;
+	  secinfo->map_ofs = map_ofs;
+	  key_lens = realloc (bs->key_lens, alloc * sizeof (bs->key_lens[0]));
+	  if (key_lens == NULL)
+	    return;
+	  bs->key_lens = key_lens;
+	}
+      hash = hashit (htab, (char *) p, &len);
+      MAP_OFS (secinfo, n) = p - bs->contents;
+      bs->key_lens[n] = ((uint64_t) hash << 32) | len;
+      bs->shard_counts[merge_shard (batch->sinfo, hash)]++;
+      n++;
+      p += len;
+    }
+
+  /* Add a sentinel element that's conceptually behind all others,
+     but don't count it.  */
+  MAP_OFS (secinfo, n) = size;
+  secinfo->map = malloc ((n + 1) * sizeof (secinfo->map[0]));
+  if (secinfo->map == NULL)
+    return;
+  secinfo->map[n].entry = NULL;
+  secinfo->noffsetmap = n;
+  bs->ok = true;
+}
+
+/* Enter the entities of the batch DATA that belong in shard S into
+   that shard, in order.  Each shard is only touched by one thread, and
+   each entity's offset map slot is written by the thread of its shard.
+   Finally unlink the entities new in this batch from the shard's list,
+   so that record_batch can link them into the list of the whole set.  */
+
+static void
+insert_shard_job (void *data, unsigned int s)
+{
+  struct merge_batch *batch = (struct merge_batch *) data;
+  struct sec_merge_hash *table = batch->sinfo->shards[s];
+  struct sec_merge_hash_entry *e, *next;
+  unsigned int j;
+
+  for (j = 0; j < batch->nsecs; j++)
+    {
+      struct merge_batch_sec *bs = &batch->secs[j];
+      struct sec_merge_sec_info *secinfo = bs->secinfo;
+      bfd_vma mask = ((bfd_vma) 1 << secinfo->sec->alignment_power) - 1;
+      unsigned int i;
+
+      if (!sec_merge_maybe_resize (table, bs->shard_counts[s]))
+	return;
+      for (i = 0; i < secinfo->noffsetmap; i++)
+	{
+	  uint64_t key_len = bs->key_lens[i];
+	  uint32_t hash = key_len >> 32;
+	  mapofs_type ofs;
+
+	  if (merge_shard (batch->sinfo, hash) != s)
+	    continue;
+	  ofs = MAP_OFS (secinfo, i);
+	  e = sec_merge_hash_lookup (table, (char *) bs->contents + ofs,
+				     (uint32_t) key_len, hash,
+				     entity_alignment (ofs, mask));
+	  /* On failure bfd_hash_allocate has set bfd_error, which
+	     record_batch sets again on this thread anyway.  */
+	  if (e == NULL)
+	    return;
+	  secinfo->map[i].entry = e;
+	}
+    }
+
+  for (e = table->first; e != NULL; e = next)
+    {
+      next = e->next;
+      e->next = NULL;
+    }
+  table->first = NULL;
+  table->last = NULL;
+  batch->shard_ok[s] = true;
+}
+
+/* Record the NSECS input sections SECS of SINFO into its shards, on as
+   many threads as are allowed, and link the new entities into the list
+   of SINFO->htab in the order in which record_section would have.  */
+
+static bool
+record_batch (struct sec_merge_info *sinfo,
+	      struct sec_merge_sec_info **secs, unsigned int nsecs)
+{
+  struct merge_batch batch;
+  struct sec_merge_hash *htab = sinfo->htab;
+  unsigned int i, j;
+  bool ret = false;
+
+  batch.sinfo = sinfo;
+  batch.nsecs = nsecs;
+  batch.secs = bfd_zmalloc (nsecs * sizeof (*batch.secs));
+  batch.shard_ok = bfd_zmalloc (sinfo->nshards * sizeof (*batch.shard_ok));
+  if (batch.secs == NULL || batch.shard_ok == NULL)
+    goto out;
+
+  /* Reading is done on this thread.  */
+  for (j = 0; j < nsecs; j++)
+    {
+      struct merge_batch_sec *bs = &batch.secs[j];
+      asection *sec = secs[j]->sec;
+      bfd_size_type amt = sec->size;
+
+      bs->secinfo = secs[j];
+      bs->shard_counts = bfd_zmalloc (sinfo->nshards
+				      * sizeof (*bs->shard_counts));
+      if (bs->shard_counts == NULL)
+	goto out;
+      if (sec->flags & SEC_STRINGS)
+	/* Allocate space for an extra zero, as record_section does.  */
+	amt += sec->entsize;
+      bs->contents = bfd_malloc (amt);
+      if (bs->contents == NULL)
+	goto out;
+      sec->rawsize = sec->size;
+      if (sec->flags & SEC_STRINGS)
+	memset (bs->contents + sec->size, 0, sec->entsize);
+      if (!bfd_get_full_section_contents (sec->owner, sec, &bs->contents))
+	goto out;
+    }
+
+  bfd_run_parallel (nsecs, scan_section_job, &batch);
+  for (j = 0; j < nsecs; j++)
+    if (!batch.secs[j].ok)
+      {
+	bfd_set_error (bfd_error_no_memory);
+	goto out;
+      }
+
+  bfd_run_parallel (sinfo->nshards, insert_shard_job, &batch);
+  for (i = 0; i < sinfo->nshards; i++)
+    if (!batch.shard_ok[i])
+      {
+	bfd_set_error (bfd_error_no_memory);
+	goto out;
+      }
+
+  /* An entity that is not yet on the list of the set (which has a NULL
+     next, but is not the last one) was first seen here.  */
+  for (j = 0; j < nsecs; j++)
+    {
+      struct sec_merge_sec_info *secinfo = batch.secs[j].secinfo;
+
+      for (i = 0; i < secinfo->noffsetmap; i++)
+	{
+	  struct sec_merge_hash_entry *e = secinfo->map[i].entry;
+
+	  if (e->next != NULL || e == htab->last)
+	    continue;
+	  if (htab->first == NULL)
+	    htab->first = e;
+	  else
+	    htab->last->next = e;
+	  htab->last = e;
+	  htab->size++;
+	}
+    }
+  ret = true;
+
+ out:
+  if (batch.secs != NULL)
+    for (j = 0; j < nsecs; j++)
+      {
+	free (batch.secs[j].contents);
+	free (batch.secs[j].key_lens);
+	free (batch.secs[j].shard_counts);
+      }
+  free (batch.secs);
+  free (batch.shard_ok);
+  return ret;
+}
+
+/* Record the input sections of SINFO that are not excluded (the
+   NSECS sections SECS) into the hash table, like record_section does
+   for each of them, but on as many threads as are allowed.  The
+   entities are spread over several hash tables by their hash.  */
+
+static bool
+record_sections_in_parallel (struct sec_merge_info *sinfo,
+			     struct sec_merge_sec_info **secs,
+			     unsigned int nsecs)
+{
+  unsigned int nthreads = bfd_get_thread_count ();
+  unsigned int i, start;
+  bfd_size_type batch_size;
+
+  sinfo->nshards = 1;
+  while (sinfo->nshards < nthreads && sinfo->nshards < MERGE_MAX_SHARDS)
+    sinfo->nshards *= 2;
+  sinfo->shards = bfd_zmalloc (sinfo->nshards * sizeof (*sinfo->shards));
+  if (sinfo->shards == NULL)
+    return false;
+  for (i = 0; i < sinfo->nshards; i++)
+    {
+      sinfo->shards[i] = sec_merge_init (sinfo->htab->entsize,
+					 sinfo->htab->strings);
+      if (sinfo->shards[i] == NULL)
+	return false;
+    }
+
+  for (start = 0; start < nsecs; start = i)
+    {
+      batch_size = 0;
+      for (i = start; i < nsecs; i++)
+	{
+	  if (i != start && batch_size + secs[i]->sec->size > MERGE_BATCH_SIZE)
+	    break;
+	  batch_size += secs[i]->sec->size;
+	}
+      if (!record_batch (sinfo, secs + start, i - start))
+	return false;
+    }
+  return true;
+}
+
 /* qsort comparison function.  Won't ever return zero as all entries
    differ, so there is no issue with qsort stability here.  */
 
@@ -948,21 +1256,42 @@ merge_strings (struct sec_merge_info *sinfo)
 
 bool
 _bfd_merge_sections (bfd *abfd,
-		     struct bfd_link_info *info ATTRIBUTE_UNUSED,
+		     struct bfd_link_info *info,
 		     void *xsinfo,
 		     void (*remove_hook) (bfd *, asection *))
 {
   struct sec_merge_info *sinfo;
+  struct bfd_link_merge_stats *stats = info->merge_stats;
 
   for (sinfo = (struct sec_merge_info *) xsinfo; sinfo; sinfo = sinfo->next)
     {
       struct sec_merge_sec_info *secinfo;
+      struct sec_merge_sec_info **secs = NULL;
+      unsigned int nsecs = 0;
+      bfd_size_type input_size = 0;
       bfd_size_type align;  /* Bytes.  */
 
       if (! sinfo->chain)
 	continue;
 
+      for (secinfo = sinfo->chain; secinfo; secinfo = secinfo->next)
+	if ((secinfo->sec->flags & SEC_EXCLUDE) == 0)
+	  {
+	    nsecs++;
+	    input_size += secinfo->sec->size;
+	  }
+
+      /* Big sets are recorded on several threads if allowed, which
+	 gives the same result.  */
+      if (bfd_get_thread_count () > 1 && input_size >= MERGE_PARALLEL_MIN)
+	{
+	  secs = bfd_malloc (nsecs * sizeof (*secs));
+	  if (secs == NULL)
+	    return false;
+	}
+
       /* Record the sections into the hash table.  */
+      nsecs = 0;
       align = 1;
       for (secinfo = sinfo->chain; secinfo; secinfo = secinfo->next)
 	if (secinfo->sec->flags & SEC_EXCLUDE)
@@ -973,8 +1302,11 @@ _bfd_merge_sections (bfd *abfd,
 	  }
 	else
 	  {
-	    if (!record_section (sinfo, secinfo))
+	    if (secs != NULL)
+	      secs[nsecs] = secinfo;
+	    else if (!record_section (sinfo, secinfo))
 	      return false;
+	    nsecs++;
 	    if (align)
 	      {
 		unsigned int opb = bfd_octets_per_byte (abfd, secinfo->sec);
@@ -985,6 +1317,29 @@ _bfd_merge_sections (bfd *abfd,
 	      }
 	  }
 
+      if (secs != NULL)
+	{
+	  bool ok = record_sections_in_parallel (sinfo, secs, nsecs);
+
+	  free (secs);
+	  if (!ok)
+	    {
+	      for (secinfo = sinfo->chain; secinfo; secinfo = secinfo->next)
+		*secinfo->psecinfo = NULL;
+	      return false;
+	    }
+	}
+
+      if (stats != NULL)
+	{
+	  stats->sections += nsecs;
+	  stats->input_size += input_size;
+	  for (secinfo = sinfo->chain; secinfo; secinfo = secinfo->next)
+	    if ((secinfo->sec->flags & SEC_EXCLUDE) == 0)
+	      stats->input_entities += secinfo->noffsetmap;
+	  stats->unique_entities += sinfo->htab->size;
+	}
+
       if (sinfo->htab->first == NULL)
 	continue;
 
@@ -1022,6 +1377,9 @@ _bfd_merge_sections (bfd *abfd,
       if (align)
 	secinfo->sec->size = (secinfo->sec->size + align - 1) & -align;
 
+      if (stats != NULL)
+	stats->output_size += secinfo->sec->size;
+
       /* Finally remove all input sections which have not made it into
 	 the hash table at all.  */
       for (secinfo = sinfo->chain; secinfo; secinfo = secinfo->next)
@@ -1143,5 +1501,17 @@ _bfd_merge_sections_free (void *xsinfo)
 	}
       bfd_hash_table_free (&sinfo->htab->table);
       free (sinfo->htab);
+      if (sinfo->shards != NULL)
+	{
+	  unsigned int i;
+
+	  for (i = 0; i < sinfo->nshards; i++)
+	    if (sinfo->shards[i] != NULL)
+	      {
+		bfd_hash_table_free (&sinfo->shards[i]->table);
+		free (sinfo->shards[i]);
+	      }
+	  free (sinfo->shards);
+	}
     }
 }
@@ -38,6 +38,7 @@
 #include "bucomm.h"
 #include "elf-bfd.h"
 #include "safe-ctype.h"
+#include "hashtab.h"
 
 static bool unwind_inlines;	/* -i, unwind inlined functions. */
 static bool with_addresses;	/* -a, show addresses.  */
@@ -45,6 +46,7 @@ static bool with_functions;	/* -f, show function names.  */
 static bool do_demangle;	/* -C, demangle names.  */
 static bool pretty_print;	/* -p, print on one line.  */
 static bool base_names;		/* -s, strip directory names.  */
+static bool batch_mode;		/* --batch, read all addresses first.  */
 
 /* Flags passed to the name demangler.  */
 static int demangle_flags = DMGL_PARAMS | DMGL_ANSI;
@@ -55,10 +57,18 @@ static char **addr;		/* Hex addresses to process.  */
 static long symcount;
 static asymbol **syms;		/* Symbol table.  */
 
+enum option_values
+{
+  OPTION_BATCH = 150,
+  OPTION_CACHE_DIR
+};
+
 static struct option long_options[] =
 {
   {"addresses", no_argument, NULL, 'a'},
   {"basenames", no_argument, NULL, 's'},
+  {"batch", no_argument, NULL, OPTION_BATCH},
+  {"cache-dir", required_argument, NULL, OPTION_CACHE_DIR},
   {"demangle", optional_argument, NULL, 'C'},
   {"exe", required_argument, NULL, 'e'},
   {"functions", no_argument, NULL, 'f'},
@@ -80,6 +90,7 @@ static void slurp_symtab (bfd *);
 static void find_address_in_section (bfd *, asection *, void *);
 static void find_offset_in_section (bfd *, asection *);
 static void translate_addresses (bfd *, asection *);
+static void translate_addresses_in_batch (bfd *, asection *);
 
 /* Print a usage message to STREAM and exit with STATUS.  */
 
@@ -102,6 +113,8 @@ usage (FILE *stream, int status)
   -C --demangle[=style]  Demangle function names\n\
   -R --recurse-limit     Enable a limit on recursion whilst demangling.  [Default]\n\
   -r --no-recurse-limit  Disable a limit on recursion whilst demangling\n\
+     --batch             Read all the addresses before translating them\n\
+     --cache-dir=<dir>   Keep line number tables in <dir> for next time\n\
   -h --help              Display this information\n\
   -v --version           Display the program's version\n\
 \n"));
@@ -280,154 +293,448 @@ is_symbol (char *adr, char **symp, size_t *offset)
   return true;
 }
 
-/* Read hexadecimal or symbolic with offset addresses from stdin, translate into
-   file_name:line_number and optionally function name.  */
+/* Read the next hexadecimal or symbolic with offset address, from
+   stdin if READ_STDIN and otherwise from the command line, into PC.
+   Return false if there are no more.  */
 
-static void
-translate_addresses (bfd *abfd, asection *section)
+static bool
+next_address (bfd *abfd, bool read_stdin)
 {
-  int read_stdin = (naddr == 0);
   char *adr;
-  char addr_hex[100];
+  static char addr_hex[100];
   char *symp;
   size_t offset;
 
-  for (;;)
+  if (read_stdin)
     {
-      if (read_stdin)
-	{
-	  if (fgets (addr_hex, sizeof addr_hex, stdin) == NULL)
-	    break;
-	  adr = addr_hex;
-	}
+      if (fgets (addr_hex, sizeof addr_hex, stdin) == NULL)
+	return false;
+      adr = addr_hex;
+    }
+  else
+    {
+      if (naddr <= 0)
+	return false;
+      --naddr;
+      adr = *addr++;
+    }
+
+  if (is_symbol (adr, &symp, &offset))
+    pc = lookup_symbol (abfd, symp, offset);
+  else
+    pc = bfd_scan_vma (adr, NULL, 16);
+  if (bfd_get_flavour (abfd) == bfd_target_elf_flavour)
+    {
+      const struct elf_backend_data *bed = get_elf_backend_data (abfd);
+      bfd_vma sign = (bfd_vma) 1 << (bed->s->arch_size - 1);
+
+      pc &= (sign << 1) - 1;
+      if (bed->sign_extend_vma)
+	pc = (pc ^ sign) - sign;
+    }
+  return true;
+}
+
+/* Look up PC, in SECTION if it is not NULL and otherwise in whichever
+   section holds it.  Return true and set the location variables if it
+   is found.  */
+
+static bool
+find_location (bfd *abfd, asection *section)
+{
+  found = false;
+  if (section)
+    find_offset_in_section (abfd, section);
+  else
+    bfd_map_over_sections (abfd, find_address_in_section, NULL);
+  return found;
+}
+
+/* Print PC, if asked to.  */
+
+static void
+print_address (bfd *abfd)
+{
+  if (with_addresses)
+    {
+      printf ("0x");
+      bfd_printf_vma (abfd, pc);
+
+      if (pretty_print)
+	printf (": ");
+      else
+	printf ("\n");
+    }
+}
+
+/* Print the location of an address that could not be found.  */
+
+static void
+print_unknown_location (void)
+{
+  if (with_functions)
+    {
+      if (pretty_print)
+	printf ("?? ");
       else
+	printf ("??\n");
+    }
+  printf ("??:0\n");
+}
+
+/* Print one FILE_NAME:LINE location, with FUNCTION_NAME if asked to.  */
+
+static void
+print_location (bfd *abfd, const char *file_name, const char *function_name,
+		unsigned int line_number, unsigned int disc)
+{
+  if (with_functions)
+    {
+      const char *name;
+      char *alloc = NULL;
+
+      name = function_name;
+      if (name == NULL || *name == '\0')
+	name = "??";
+      else if (do_demangle)
 	{
-	  if (naddr <= 0)
-	    break;
-	  --naddr;
-	  adr = *addr++;
+	  alloc = bfd_demangle (abfd, name, demangle_flags);
+	  if (alloc != NULL)
+	    name = alloc;
 	}
 
-      if (is_symbol (adr, &symp, &offset))
-        pc = lookup_symbol (abfd, symp, offset);
+      printf ("%s", name);
+      if (pretty_print)
+	/* Note for translators:  This printf is used to join the
+	   function name just printed above to the line number/
+	   file name pair that is about to be printed below.  Eg:
+
+	     foo at 123:bar.c  */
+	printf (_(" at "));
       else
-        pc = bfd_scan_vma (adr, NULL, 16);
-      if (bfd_get_flavour (abfd) == bfd_target_elf_flavour)
-	{
-	  const struct elf_backend_data *bed = get_elf_backend_data (abfd);
-	  bfd_vma sign = (bfd_vma) 1 << (bed->s->arch_size - 1);
+	printf ("\n");
 
-	  pc &= (sign << 1) - 1;
-	  if (bed->sign_extend_vma)
-	    pc = (pc ^ sign) - sign;
-	}
+      free (alloc);
+    }
 
-      if (with_addresses)
-        {
-          printf ("0x");
-          bfd_printf_vma (abfd, pc);
+  if (base_names && file_name != NULL)
+    {
+      const char *h;
 
-          if (pretty_print)
-            printf (": ");
-          else
-            printf ("\n");
-        }
+      h = strrchr (file_name, '/');
+      if (h != NULL)
+	file_name = h + 1;
+    }
 
-      found = false;
-      if (section)
-	find_offset_in_section (abfd, section);
+  printf ("%s:", file_name ? file_name : "??");
+  if (line_number != 0)
+    {
+      if (disc != 0)
+	printf ("%u (discriminator %u)\n", line_number, disc);
       else
-	bfd_map_over_sections (abfd, find_address_in_section, NULL);
+	printf ("%u\n", line_number);
+    }
+  else
+    printf ("?\n");
+}
 
-      if (! found)
-	{
-	  if (with_functions)
-	    {
-	      if (pretty_print)
-		printf ("?? ");
-	      else
-		printf ("??\n");
-	    }
-	  printf ("??:0\n");
-	}
+/* Print the separator between the locations of an address and of the
+   function it was inlined into.  */
+
+static void
+print_inlined_by (void)
+{
+  if (pretty_print)
+    /* Note for translators: This printf is used to join the
+       line number/file name pair that has just been printed with
+       the line number/file name pair that is going to be printed
+       by the next iteration of the while loop.  Eg:
+
+	 123:bar.c (inlined by) 456:main.c  */
+    printf (_(" (inlined by) "));
+}
+
+/* Read hexadecimal or symbolic with offset addresses from stdin, translate into
+   file_name:line_number and optionally function name.  */
+
+static void
+translate_addresses (bfd *abfd, asection *section)
+{
+  bool read_stdin = (naddr == 0);
+
+  while (next_address (abfd, read_stdin))
+    {
+      print_address (abfd);
+
+      if (! find_location (abfd, section))
+	print_unknown_location ();
       else
 	{
 	  while (1)
-            {
-              if (with_functions)
-                {
-                  const char *name;
-                  char *alloc = NULL;
-
-                  name = functionname;
-                  if (name == NULL || *name == '\0')
-                    name = "??";
-                  else if (do_demangle)
-                    {
-                      alloc = bfd_demangle (abfd, name, demangle_flags);
-                      if (alloc != NULL)
-                        name = alloc;
-                    }
-
-                  printf ("%s", name);
-                  if (pretty_print)
-		    /* Note for translators:  This printf is used to join the
-		       function name just printed above to the line number/
-		       file name pair that is about to be printed below.  Eg:
-
-		         foo at 123:bar.c  */
-                    printf (_(" at "));
-                  else
-                    printf ("\n");
-
-		  free (alloc);
-                }
-
-              if (base_names && filename != NULL)
-                {
-                  char *h;
-
-                  h = strrchr (filename, '/');
-                  if (h != NULL)
-                    filename = h + 1;
-                }
-
-              printf ("%s:", filename ? filename : "??");
-	      if (line != 0)
-                {
-                  if (discriminator != 0)
-                    printf ("%u (discriminator %u)\n", line, discriminator);
-                  else
-                    printf ("%u\n", line);
-                }
+	    {
+	      print_location (abfd, filename, functionname, line,
+			      discriminator);
+	      if (!unwind_inlines)
+		found = false;
 	      else
-		printf ("?\n");
-              if (!unwind_inlines)
-                found = false;
-              else
-                found = bfd_find_inliner_info (abfd, &filename, &functionname,
+		found = bfd_find_inliner_info (abfd, &filename, &functionname,
 					       &line);
-              if (! found)
-                break;
-              if (pretty_print)
-		/* Note for translators: This printf is used to join the
-		   line number/file name pair that has just been printed with
-		   the line number/file name pair that is going to be printed
-		   by the next iteration of the while loop.  Eg:
-
-		     123:bar.c (inlined by) 456:main.c  */
-                printf (_(" (inlined by) "));
-            }
+	      if (! found)
+		break;
+	      print_inlined_by ();
+	    }
 	}
 
       /* fflush() is essential for using this command as a server
-         child process that reads addresses from a pipe and responds
-         with line number information, processing one address at a
-         time.  */
+	 child process that reads addresses from a pipe and responds
+	 with line number information, processing one address at a
+	 time.  */
       fflush (stdout);
     }
 }
 
+/* In batch mode every address is read before any is translated.  Each
+   distinct address is then looked up once, in address order, and the
+   results are kept in a table sorted by address.  */
+
+/* One location in the table.  The file and function names are offsets
+   plus one into the table's string pool, or zero if unknown.  */
+
+struct table_frame
+{
+  uint32_t file_name;
+  uint32_t function_name;
+  uint32_t line;
+  uint32_t discriminator;
+};
+
+/* The locations of one address: the location of the address itself
+   followed by those of the functions it is inlined into.  NFRAMES is
+   zero if the address could not be found.  */
+
+struct table_entry
+{
+  uint64_t pc;
+  uint32_t frame;
+  uint32_t nframes;
+};
+
+static struct
+{
+  struct table_entry *entries;
+  size_t nentries, entries_alloc;
+  struct table_frame *frames;
+  size_t nframes, frames_alloc;
+  char *strings;
+  size_t string_size, strings_alloc;
+  htab_t string_htab;
+} table;
+
+static hashval_t
+hash_table_string (const void *p)
+{
+  return htab_hash_string (table.strings + (uintptr_t) p - 1);
+}
+
+static int
+eq_table_string (const void *p, const void *key)
+{
+  return strcmp (table.strings + (uintptr_t) p - 1, (const char *) key) == 0;
+}
+
+/* Return the offset plus one of STR in the table's string pool, adding
+   it if need be, or zero if STR is NULL.  */
+
+static uint32_t
+table_string (const char *str)
+{
+  void **slot;
+  size_t len;
+
+  if (str == NULL)
+    return 0;
+
+  slot = htab_find_slot_with_hash (table.string_htab, str,
+				   htab_hash_string (str), INSERT);
+  if (*slot != NULL)
+    return (uintptr_t) *slot;
+
+  len = strlen (str) + 1;
+  if (table.string_size + len > table.strings_alloc)
+    {
+      table.strings_alloc = (table.string_size + len) * 2;
+      table.strings = xrealloc (table.strings, table.strings_alloc);
+    }
+  memcpy (table.strings + table.string_size, str, len);
+  *slot = (void *) (uintptr_t) (table.string_size + 1);
+  table.string_size += len;
+  return (uintptr_t) *slot;
+}
+
+static const char *
+table_string_at (uint32_t offset)
+{
+  return offset == 0 ? NULL : table.strings + offset - 1;
+}
+
+static void
+add_table_frame (const char *file_name, const char *function_name,
+		 unsigned int line_number, unsigned int disc)
+{
+  struct table_frame *frame;
+
+  if (table.nframes == table.frames_alloc)
+    {
+      table.frames_alloc = table.frames_alloc * 2 + 64;
+      table.frames = xrealloc (table.frames,
+			       table.frames_alloc * sizeof (*table.frames));
+    }
+  frame = &table.frames[table.nframes++];
+  frame->file_name = table_string (file_name);
+  frame->function_name = table_string (function_name);
+  frame->line = line_number;
+  frame->discriminator = disc;
+}
+
+/* Look up PC and add its locations to the table.  */
+
+static void
+add_table_entry (bfd *abfd, asection *section)
+{
+  struct table_entry *entry;
+
+  if (table.nentries == table.entries_alloc)
+    {
+      table.entries_alloc = table.entries_alloc * 2 + 64;
+      table.entries = xrealloc (table.entries,
+				table.entries_alloc * sizeof (*table.entries));
+    }
+  entry = &table.entries[table.nentries++];
+  entry->pc = pc;
+  entry->frame = table.nframes;
+  entry->nframes = 0;
+  if (! find_location (abfd, section))
+    return;
+
+  /* The whole inline chain is kept, with or without -i, so that the
+     table serves any set of options.  As when printing directly, the
+     functions an address is inlined into are shown with its
+     discriminator.  */
+  do
+    {
+      add_table_frame (filename, functionname, line, discriminator);
+      entry->nframes++;
+    }
+  while (bfd_find_inliner_info (abfd, &filename, &functionname, &line));
+}
+
+static int
+compare_vmas (const void *a, const void *b)
+{
+  bfd_vma va = *(const bfd_vma *) a;
+  bfd_vma vb = *(const bfd_vma *) b;
+
+  if (va != vb)
+    return va < vb ? -1 : 1;
+  return 0;
+}
+
+/* Return the entry for ADDRESS in the table, which is sorted, or NULL
+   if there is none.  */
+
+static struct table_entry *
+find_table_entry (bfd_vma address)
+{
+  size_t lo = 0, hi = table.nentries;
+
+  while (lo < hi)
+    {
+      size_t mid = lo + (hi - lo) / 2;
+
+      if (table.entries[mid].pc == address)
+	return &table.entries[mid];
+      if (table.entries[mid].pc < address)
+	lo = mid + 1;
+      else
+	hi = mid;
+    }
+  return NULL;
+}
+
+/* Read all the addresses, from stdin or the command line, look up each
+   distinct one to build the table, and then print the
+   locations of them all in the order they were given.  */
+
+static void
+translate_addresses_in_batch (bfd *abfd, asection *section)
+{
+  bool read_stdin = (naddr == 0);
+  bfd_vma *pcs = NULL, *sorted;
+  size_t npcs = 0, pcs_alloc = 0, i;
+
+  while (next_address (abfd, read_stdin))
+    {
+      if (npcs == pcs_alloc)
+	{
+	  pcs_alloc = pcs_alloc * 2 + 1024;
+	  pcs = xrealloc (pcs, pcs_alloc * sizeof (*pcs));
+	}
+      pcs[npcs++] = pc;
+    }
+
+  table.string_htab = htab_create_alloc (1024, hash_table_string,
+					 eq_table_string, NULL,
+					 xcalloc, free);
+
+  /* Look up the addresses in order, which makes the best use of the
+     information BFD keeps from one lookup to the next, and leaves the
+     table sorted.  */
+  sorted = xmalloc (npcs * sizeof (*sorted) + 1);
+  memcpy (sorted, pcs, npcs * sizeof (*sorted));
+  qsort (sorted, npcs, sizeof (*sorted), compare_vmas);
+  for (i = 0; i < npcs; i++)
+    if (i == 0 || sorted[i] != sorted[i - 1])
+      {
+	pc = sorted[i];
+	add_table_entry (abfd, section);
+      }
+  free (sorted);
+
+  for (i = 0; i < npcs; i++)
+    {
+      struct table_entry *entry;
+      uint32_t j;
+
+      pc = pcs[i];
+      print_address (abfd);
+
+      entry = find_table_entry (pc);
+      if (entry->nframes == 0)
+	print_unknown_location ();
+      for (j = 0; j < entry->nframes; j++)
+	{
+	  struct table_frame *frame = &table.frames[entry->frame + j];
+
+	  if (j != 0)
+	    {
+	      if (!unwind_inlines)
+		break;
+	      print_inlined_by ();
+	    }
+	  print_location (abfd, table_string_at (frame->file_name),
+			  table_string_at (frame->function_name),
+			  frame->line, frame->discriminator);
+	}
+    }
+
+  free (pcs);
+  htab_delete (table.string_htab);
+  free (table.entries);
+  free (table.frames);
+  free (table.strings);
+  memset (&table, 0, sizeof table);
+}
+
 /* Process a file.  Returns an exit value for main().  */
 
 static int
@@ -476,7 +783,10 @@ process_file (const char *file_name, const char *section_name,
 
   slurp_symtab (abfd);
 
-  translate_addresses (abfd, section);
+  if (batch_mode)
+    translate_addresses_in_batch (abfd, section);
+  else
+    translate_addresses (abfd, section);
 
   free (syms);
   syms = NULL;
@@ -573,6 +883,12 @@ main (int argc, char **argv)
 	case 'j':
 	  section_name = optarg;
 	  break;
+	case OPTION_BATCH:
+	  batch_mode = true;
+	  break;
+	case OPTION_CACHE_DIR:
+	  bfd_set_line_cache_dir (optarg);
+	  break;
 	default:
 	  usage (stderr, 1);
 	  break;
@@ -29,6 +29,7 @@
 #include "getopt.h"
 #include "aout/ar.h"
 #include "bucomm.h"
+#include "parallel.h"
 #include "arsup.h"
 #include "filenames.h"
 #include "binemul.h"
@@ -137,6 +138,9 @@ static bool full_pathname = false;
 /* Whether to create a "thin" archive (symbol index only -- no files).  */
 static bool make_thin_archive = false;
 
+/* The number of processes to use to extract or print members.  */
+static unsigned int thread_count = 1;
+
 #define LIBDEPS	"__.LIBDEP"
 /* Text to store in the __.LIBDEP archive element for the linker to use.  */
 static char * libdeps = NULL;
@@ -158,7 +162,8 @@ enum long_option_numbers
 {
   OPTION_PLUGIN = 201,
   OPTION_TARGET,
-  OPTION_OUTPUT
+  OPTION_OUTPUT,
+  OPTION_THREADS
 };
 
 static const char * output_dir = NULL;
@@ -172,6 +177,7 @@ static struct option long_options[] =
   {"output", required_argument, NULL, OPTION_OUTPUT},
   {"record-libdeps", required_argument, NULL, 'l'},
   {"thin", no_argument, NULL, 'T'},
+  {"threads", optional_argument, NULL, OPTION_THREADS},
   {NULL, no_argument, NULL, 0}
 };
 
@@ -271,6 +277,115 @@ map_over_members (bfd *arch, void (*function)(bfd *), char **files, int count)
     }
 }
 
+/* The members of an archive, split between --threads jobs.  */
+
+struct member_jobs
+{
+  void (*function) (bfd *);
+  bfd **members;
+  /* Job I handles the members from SPLITS[I] up to SPLITS[I + 1].  */
+  unsigned int *splits;
+};
+
+static int
+map_over_members_job (void *data, unsigned int i)
+{
+  struct member_jobs *jobs = (struct member_jobs *) data;
+  unsigned int j;
+
+  for (j = jobs->splits[i]; j < jobs->splits[i + 1]; j++)
+    jobs->function (jobs->members[j]);
+  return 0;
+}
+
+/* Like map_over_members, but with --threads and no FILES, call
+   FUNCTION on the members in up to THREAD_COUNT processes at once.
+   If OUTPUT_FILES, FUNCTION writes each member to a file named after
+   it, and that is only done in parallel if the names are distinct, so
+   that the last of several same-named members still wins.  */
+
+static void
+map_over_members_parallel (bfd *arch, void (*function) (bfd *),
+			   char **files, int count, bool output_files)
+{
+  struct member_jobs jobs;
+  unsigned int nmembers, njobs, i, j;
+  htab_t names = NULL;
+  uint64_t total = 0, sum;
+  bool done = false;
+  int status;
+  bfd *head;
+
+  nmembers = 0;
+  for (head = arch->archive_next; head; head = head->archive_next)
+    nmembers++;
+
+  njobs = thread_count * 4;
+  if (njobs > nmembers)
+    njobs = nmembers;
+  if (count != 0 || njobs < 2)
+    {
+      map_over_members (arch, function, files, count);
+      return;
+    }
+
+  jobs.function = function;
+  jobs.members = xmalloc (nmembers * sizeof (bfd *));
+  if (output_files)
+    names = htab_create_alloc (nmembers, htab_hash_string, htab_eq_string,
+			       NULL, xcalloc, free);
+  for (i = 0, head = arch->archive_next; head; head = head->archive_next)
+    {
+      jobs.members[i++] = head;
+      total += bfd_get_size (head);
+      if (names != NULL)
+	{
+	  const char *name = bfd_get_filename (head);
+	  void **slot;
+
+	  if (name == NULL)
+	    break;
+	  slot = htab_find_slot (names, lbasename (name), INSERT);
+	  if (*slot != NULL)
+	    break;
+	  *slot = (void *) lbasename (name);
+	}
+    }
+
+  if (head == NULL)
+    {
+      /* Give each job about the same number of bytes to copy.  */
+      jobs.splits = xmalloc ((njobs + 1) * sizeof (unsigned int));
+      jobs.splits[0] = 0;
+      for (i = 1, j = 0, sum = 0; i < njobs; i++)
+	{
+	  while (j < nmembers - (njobs - i) && sum < total / njobs * i)
+	    sum += bfd_get_size (jobs.members[j++]);
+	  if (j <= jobs.splits[i - 1])
+	    j = jobs.splits[i - 1] + 1;
+	  jobs.splits[i] = j;
+	}
+      jobs.splits[njobs] = nmembers;
+
+      /* Make each job open the archive for itself, rather than share
+	 the file position of our descriptor.  */
+      bfd_cache_close_all ();
+      done = run_parallel_output (njobs, thread_count, map_over_members_job,
+				  &jobs, &status);
+      free (jobs.splits);
+      /* A job that failed exited early, as we would have done.  */
+      if (done && status != 0)
+	xexit (1);
+    }
+
+  if (names != NULL)
+    htab_delete (names);
+  free (jobs.members);
+
+  if (!done)
+    map_over_members (arch, function, files, count);
+}
+
 bool operation_alters_arch = false;
 
 static void
@@ -341,6 +456,7 @@ usage (int help)
   fprintf (s, _("  --output=DIRNAME - specify the output directory for extraction operations\n"));
   fprintf (s, _("  --record-libdeps=<text> - specify the dependencies of this library\n"));
   fprintf (s, _("  --thin       - make a thin archive\n"));
+  fprintf (s, _("  --threads[=N] - use up to N processes to extract or print members\n"));
 #if BFD_SUPPORTS_PLUGINS
   fprintf (s, _(" optional:\n"));
   fprintf (s, _("  --plugin <p> - load the specified plugin\n"));
@@ -609,6 +725,11 @@ decode_options (int argc, char **argv)
 	case OPTION_OUTPUT:
 	  output_dir = optarg;
 	  break;
+	case OPTION_THREADS:
+	  thread_count = parse_thread_count (optarg);
+	  if (thread_count == 0)
+	    fatal (_("%s: invalid thread count: %s"), "--threads", optarg);
+	  break;
 	case 0:		/* A long option that just sets a flag.  */
 	  break;
         default:
@@ -903,11 +1024,13 @@ main (int argc, char **argv)
 	  break;
 
 	case print_files:
-	  map_over_members (arch, print_contents, files, file_count);
+	  map_over_members_parallel (arch, print_contents, files, file_count,
+				     false);
 	  break;
 
 	case extract:
-	  map_over_members (arch, extract_file, files, file_count);
+	  map_over_members_parallel (arch, extract_file, files, file_count,
+				     true);
 	  break;
 
 	case del:
@@ -24,6 +24,7 @@
 #include <stdint.h>
 #include "bucomm.h"
 #include "elfcomm.h"
+#include "parallel.h"
 #include "elf/common.h"
 #include "dwarf2.h"
 #include "dwarf.h"
@@ -32,6 +33,10 @@
 #include "safe-ctype.h"
 #include <assert.h>
 
+#ifdef HAVE_MMAP
+#include <sys/mman.h>
+#endif
+
 #ifdef HAVE_LIBDEBUGINFOD
 #include <elfutils/debuginfod.h>
 #endif
@@ -119,6 +124,9 @@ unsigned long dwarf_start_die;
 
 int dwarf_check = 0;
 
+/* The number of processes that may be used to display a section.  */
+unsigned int dwarf_thread_count = 1;
+
 /* Collection of CU/TU section sets from .debug_cu_index and .debug_tu_index
    sections.  For version 1 package files, each set is stored in SHNDX_POOL
    as a zero-terminated list of section indexes comprising one set of debug
@@ -821,26 +829,41 @@ typedef struct abbrev_map
 {
   uint64_t start;
   uint64_t end;
+  /* The abbrevs, or NULL if they have not been read in yet.  */
   abbrev_list *list;
+  /* Where to find the abbrevs.  */
+  struct dwarf_section *abbrev_section;
+  uint64_t abbrev_base;
+  uint64_t abbrev_size;
+  uint64_t abbrev_offset;
 } abbrev_map;
 
-/* Maps between CU offsets and abbrev sets.  */
+/* Maps between CU offsets and abbrev sets, in order of CU offset.  */
 static abbrev_map *   cu_abbrev_map = NULL;
 static unsigned long  num_abbrev_map_entries = 0;
 static unsigned long  next_free_abbrev_map_entry = 0;
 
 #define INITIAL_NUM_ABBREV_MAP_ENTRIES 8
-#define ABBREV_MAP_ENTRIES_INCREMENT   8
+
+/* With --threads, sections smaller than twice this are displayed in one
+   go, and larger ones are split into parts no smaller than this.  */
+#define MIN_PARALLEL_DWARF_SIZE 0x10000
+
+/* How much of a mapped section to read before dropping pages.  */
+#define RELEASE_MAPPED_DATA_BATCH (1024 * 1024)
+
+/* Record that the CU between START and END uses the abbrevs at
+   ABBREV_OFFSET in the part of ABBREV_SECTION starting at ABBREV_BASE.
+   They are only read in when another CU refers to this one, so that
+   the abbrevs of every CU need not be kept in memory at once.  */
 
 static void
 record_abbrev_list_for_cu (uint64_t start, uint64_t end,
-			   abbrev_list *list, abbrev_list *free_list)
+			   struct dwarf_section *abbrev_section,
+			   uint64_t abbrev_base, uint64_t abbrev_size,
+			   uint64_t abbrev_offset)
 {
-  if (free_list != NULL)
-    {
-      list->next = abbrev_lists;
-      abbrev_lists = list;
-    }
+  abbrev_map *map;
 
   if (cu_abbrev_map == NULL)
     {
@@ -849,13 +872,18 @@ record_abbrev_list_for_cu (uint64_t start, uint64_t end,
     }
   else if (next_free_abbrev_map_entry == num_abbrev_map_entries)
     {
-      num_abbrev_map_entries += ABBREV_MAP_ENTRIES_INCREMENT;
+      num_abbrev_map_entries *= 2;
       cu_abbrev_map = xrealloc (cu_abbrev_map, num_abbrev_map_entries * sizeof (* cu_abbrev_map));
     }
 
-  cu_abbrev_map[next_free_abbrev_map_entry].start = start;
-  cu_abbrev_map[next_free_abbrev_map_entry].end = end;
-  cu_abbrev_map[next_free_abbrev_map_entry].list = list;
+  map = &cu_abbrev_map[next_free_abbrev_map_entry];
+  map->start = start;
+  map->end = end;
+  map->list = NULL;
+  map->abbrev_section = abbrev_section;
+  map->abbrev_base = abbrev_base;
+  map->abbrev_size = abbrev_size;
+  map->abbrev_offset = abbrev_offset;
   next_free_abbrev_map_entry ++;
 }
 
@@ -910,18 +938,24 @@ find_abbrev_list_by_raw_abbrev (unsigned char *raw)
 
 /* Find the abbreviation map for the CU that includes OFFSET.
    OFFSET is an absolute offset from the start of the .debug_info section.  */
-/* FIXME: This function is going to slow down readelf & objdump.
-   Not caching abbrevs is likely the answer.  */
 
 static  abbrev_map *
 find_abbrev_map_by_offset (uint64_t offset)
 {
-  unsigned long i;
+  unsigned long lo = 0;
+  unsigned long hi = next_free_abbrev_map_entry;
 
-  for (i = 0; i < next_free_abbrev_map_entry; i++)
-    if (cu_abbrev_map[i].start <= offset
-	&& cu_abbrev_map[i].end > offset)
-      return cu_abbrev_map + i;
+  while (lo < hi)
+    {
+      unsigned long mid = lo + (hi - lo) / 2;
+
+      if (cu_abbrev_map[mid].end <= offset)
+	lo = mid + 1;
+      else if (cu_abbrev_map[mid].start > offset)
+	hi = mid;
+      else
+	return cu_abbrev_map + mid;
+    }
 
   return NULL;
 }
@@ -1103,6 +1137,30 @@ find_and_process_abbrev_set (struct dwarf_section *section,
   return list;
 }
 
+/* Return the abbrevs for the CU recorded in MAP, reading them in if
+   that has not been done yet.  */
+
+static abbrev_list *
+get_abbrev_list_for_map (abbrev_map *map)
+{
+  if (map->list == NULL)
+    {
+      abbrev_list *free_list;
+
+      map->list = find_and_process_abbrev_set (map->abbrev_section,
+					       map->abbrev_base,
+					       map->abbrev_size,
+					       map->abbrev_offset,
+					       &free_list);
+      if (free_list != NULL)
+	{
+	  free_list->next = abbrev_lists;
+	  abbrev_lists = free_list;
+	}
+    }
+  return map->list;
+}
+
 static const char *
 get_TAG_name (uint64_t tag)
 {
@@ -2129,7 +2187,7 @@ get_type_abbrev_from_form (unsigned long form,
       warn (_("Unable to find abbreviations for CU offset %#lx\n"), uvalue);
       return NULL;
     }
-  if (map->list == NULL)
+  if (get_abbrev_list_for_map (map) == NULL)
     {
       warn (_("Empty abbreviation list encountered for CU offset %lx\n"), uvalue);
       return NULL;
@@ -3524,6 +3582,64 @@ introduce (struct dwarf_section * section, bool raw)
     }
 }
 
+/* If SECTION is mapped, drop the pages between *FROM and UPTO, which
+   have been read and will probably not be needed again, so that
+   decoding a large section does not keep all of it in memory.  Pages
+   are dropped in batches; *FROM is advanced past those that are.  */
+
+static void
+release_mapped_data (struct dwarf_section *section ATTRIBUTE_UNUSED,
+		     unsigned char *upto ATTRIBUTE_UNUSED,
+		     unsigned char **from ATTRIBUTE_UNUSED)
+{
+#if defined (HAVE_MMAP) && defined (MADV_DONTNEED)
+  uintptr_t page_mask;
+  unsigned char *lo;
+  unsigned char *hi;
+
+  if (!section->mapped
+      || upto <= *from
+      || (size_t) (upto - *from) < RELEASE_MAPPED_DATA_BATCH)
+    return;
+
+  page_mask = getpagesize () - 1;
+  lo = (unsigned char *) (((uintptr_t) *from + page_mask) & ~page_mask);
+  hi = (unsigned char *) ((uintptr_t) upto & ~page_mask);
+  if (lo < hi)
+    madvise (lo, hi - lo, MADV_DONTNEED);
+  *from = hi;
+#endif
+}
+
+/* Free the parts of ENT that no section to be displayed will need.
+   Only the location and range list offsets can take much memory, and
+   only .debug_loc and .debug_ranges and their variants use them once
+   the unit has been processed.  */
+
+static void
+trim_debug_information (debug_info *ent)
+{
+  if (!do_debug_loc && ent->max_loc_offsets)
+    {
+      free (ent->loc_offsets);
+      free (ent->loc_views);
+      free (ent->have_frame_base);
+      ent->loc_offsets = NULL;
+      ent->loc_views = NULL;
+      ent->have_frame_base = NULL;
+      ent->num_loc_offsets = 0;
+      ent->max_loc_offsets = 0;
+      ent->num_loc_views = 0;
+    }
+  if (!do_debug_ranges && ent->max_range_lists)
+    {
+      free (ent->range_lists);
+      ent->range_lists = NULL;
+      ent->num_range_lists = 0;
+      ent->max_range_lists = 0;
+    }
+}
+
 /* Free memory allocated for one unit in debug_information.  */
 
 static void
@@ -3539,206 +3655,159 @@ free_debug_information (debug_info *ent)
     free (ent->range_lists);
 }
 
-/* Process the contents of a .debug_info section.
-   If do_loc is TRUE then we are scanning for location lists and dwo tags
-   and we do not want to display anything to the user.
-   If do_types is TRUE, we are processing a .debug_types section instead of
-   a .debug_info section.
-   The information displayed is restricted by the values in DWARF_START_DIE
-   and DWARF_CUTOFF_LEVEL.
-   Returns TRUE upon success.  Otherwise an error or warning message is
-   printed and FALSE is returned.  */
+/* A section split into parts that are displayed by separate jobs.  */
+
+struct dwarf_section_jobs
+{
+  struct dwarf_section *section;
+  void *file;
+  enum dwarf_section_display_enum abbrev_sec;
+  /* For .debug_line, whether the decoded lines are displayed.  */
+  bool decoded;
+  unsigned int count;
+  /* Where each part starts, and the end of the section.  */
+  unsigned char **starts;
+  /* The number of the first unit of each part, and the value of
+     DO_TYPES in process_debug_info at its start.  */
+  unsigned int *units;
+  bool *types;
+};
+
+static void
+free_dwarf_jobs (struct dwarf_section_jobs *jobs)
+{
+  free (jobs->starts);
+  free (jobs->units);
+  free (jobs->types);
+  jobs->count = 0;
+}
+
+/* With --threads, split SECTION, which holds units that start with an
+   initial length field, into parts of whole units for JOBS.  IS_INFO
+   says whether it is a .debug_info or .debug_types section, whose
+   units change DO_TYPES as they do in process_debug_info.  Return
+   FALSE if the section should be displayed in one go.  */
 
 static bool
-process_debug_info (struct dwarf_section * section,
-		    void *file,
-		    enum dwarf_section_display_enum abbrev_sec,
-		    bool do_loc,
-		    bool do_types)
+split_dwarf_units (struct dwarf_section *section, bool is_info,
+		   bool do_types, struct dwarf_section_jobs *jobs)
 {
   unsigned char *start = section->start;
   unsigned char *end = start + section->size;
-  unsigned char *section_begin;
+  unsigned char *data;
+  unsigned char *next_job;
+  unsigned int max_jobs;
   unsigned int unit;
-  unsigned int num_units = 0;
+  uint64_t job_size;
 
-  /* First scan the section to get the number of comp units.
-     Length sanity checks are done here.  */
-  for (section_begin = start, num_units = 0; section_begin < end;
-       num_units ++)
-    {
-      uint64_t length;
+  jobs->count = 0;
+  if (dwarf_thread_count < 2
+      || section->size < 2 * MIN_PARALLEL_DWARF_SIZE)
+    return false;
 
-      /* Read the first 4 bytes.  For a 32-bit DWARF section, this
-	 will be the length.  For a 64-bit DWARF section, it'll be
-	 the escape code 0xffffffff followed by an 8 byte length.  */
-      SAFE_BYTE_GET_AND_INC (length, section_begin, 4, end);
+  max_jobs = dwarf_thread_count * 4;
+  if (max_jobs > section->size / MIN_PARALLEL_DWARF_SIZE)
+    max_jobs = section->size / MIN_PARALLEL_DWARF_SIZE;
+  job_size = section->size / max_jobs;
 
-      if (length == 0xffffffff)
-	SAFE_BYTE_GET_AND_INC (length, section_begin, 8, end);
-      else if (length >= 0xfffffff0 && length < 0xffffffff)
-	{
-	  warn (_("Reserved length value (%#" PRIx64 ") found in section %s\n"),
-		length, section->name);
-	  return false;
-	}
+  jobs->starts = xmalloc ((max_jobs + 1) * sizeof (*jobs->starts));
+  jobs->units = xmalloc (max_jobs * sizeof (*jobs->units));
+  jobs->types = xmalloc (max_jobs * sizeof (*jobs->types));
 
-      /* Negative values are illegal, they may even cause infinite
-	 looping.  This can happen if we can't accurately apply
-	 relocations to an object file, or if the file is corrupt.  */
-      if (length > (size_t) (end - section_begin))
-	{
-	  warn (_("Corrupt unit length (got %#" PRIx64
-		  " expected at most %#tx) in section %s\n"),
-		length, end - section_begin, section->name);
-	  return false;
-	}
-      section_begin += length;
-    }
-
-  if (num_units == 0)
-    {
-      error (_("No comp units in %s section ?\n"), section->name);
-      return false;
-    }
-
-  if ((do_loc || do_debug_loc || do_debug_ranges || do_debug_info)
-      && num_debug_info_entries == 0
-      && ! do_types)
+  next_job = start;
+  for (data = start, unit = 0; data < end; unit++)
     {
+      unsigned char *hdrptr = data;
+      unsigned char *end_unit;
+      uint64_t length;
 
-      /* Then allocate an array to hold the information.  */
-      debug_information = (debug_info *) cmalloc (num_units,
-						  sizeof (* debug_information));
-      if (debug_information == NULL)
+      if (data >= next_job && jobs->count < max_jobs)
 	{
-	  error (_("Not enough memory for a debug info array of %u entries\n"),
-		 num_units);
-	  alloc_num_debug_info_entries = num_debug_info_entries = 0;
-	  return false;
+	  jobs->starts[jobs->count] = data;
+	  jobs->units[jobs->count] = unit;
+	  jobs->types[jobs->count] = do_types;
+	  jobs->count++;
+	  next_job = (size_t) (end - data) > job_size ? data + job_size : end;
 	}
 
-      /* PR 17531: file: 92ca3797.
-	 We cannot rely upon the debug_information array being initialised
-	 before it is used.  A corrupt file could easily contain references
-	 to a unit for which information has not been made available.  So
-	 we ensure that the array is zeroed here.  */
-      memset (debug_information, 0, num_units * sizeof (*debug_information));
+      /* Anything after a bad length is left to the last part.  */
+      SAFE_BYTE_GET_AND_INC (length, hdrptr, 4, end);
+      if (length == 0xffffffff)
+	SAFE_BYTE_GET_AND_INC (length, hdrptr, 8, end);
+      else if (length >= 0xfffffff0)
+	break;
+      if (length > (size_t) (end - hdrptr))
+	break;
+      end_unit = hdrptr + length;
 
-      alloc_num_debug_info_entries = num_units;
-    }
+      if (is_info)
+	{
+	  unsigned int version;
+	  enum dwarf_unit_type unit_type;
 
-  if (!do_loc)
-    {
-      load_debug_section_with_follow (str, file);
-      load_debug_section_with_follow (line_str, file);
-      load_debug_section_with_follow (str_dwo, file);
-      load_debug_section_with_follow (str_index, file);
-      load_debug_section_with_follow (str_index_dwo, file);
-      load_debug_section_with_follow (debug_addr, file);
+	  SAFE_BYTE_GET_AND_INC (version, hdrptr, 2, end_unit);
+	  if (version >= 5)
+	    {
+	      SAFE_BYTE_GET_AND_INC (unit_type, hdrptr, 1, end_unit);
+	      do_types = unit_type == DW_UT_type;
+	    }
+	}
+      data = end_unit;
     }
+  jobs->starts[jobs->count] = end;
 
-  load_debug_section_with_follow (abbrev_sec, file);
-  load_debug_section_with_follow (loclists, file);
-  load_debug_section_with_follow (rnglists, file);
-  load_debug_section_with_follow (loclists_dwo, file);
-  load_debug_section_with_follow (rnglists_dwo, file);
-
-  if (debug_displays [abbrev_sec].section.start == NULL)
+  if (jobs->count < 2)
     {
-      warn (_("Unable to locate %s section!\n"),
-	    debug_displays [abbrev_sec].section.uncompressed_name);
+      free_dwarf_jobs (jobs);
       return false;
     }
+  return true;
+}
 
-  if (!do_loc && dwarf_start_die == 0)
-    introduce (section, false);
-
-  free_all_abbrevs ();
-
-  /* In order to be able to resolve DW_FORM_ref_addr forms we need
-     to load *all* of the abbrevs for all CUs in this .debug_info
-     section.  This does effectively mean that we (partially) read
-     every CU header twice.  */
-  for (section_begin = start; start < end;)
-    {
-      DWARF2_Internal_CompUnit compunit;
-      unsigned char *hdrptr;
-      uint64_t abbrev_base;
-      size_t abbrev_size;
-      uint64_t cu_offset;
-      unsigned int offset_size;
-      struct cu_tu_set *this_set;
-      unsigned char *end_cu;
-
-      hdrptr = start;
-      cu_offset = start - section_begin;
-
-      SAFE_BYTE_GET_AND_INC (compunit.cu_length, hdrptr, 4, end);
-
-      if (compunit.cu_length == 0xffffffff)
-	{
-	  SAFE_BYTE_GET_AND_INC (compunit.cu_length, hdrptr, 8, end);
-	  offset_size = 8;
-	}
-      else
-	offset_size = 4;
-      end_cu = hdrptr + compunit.cu_length;
-
-      SAFE_BYTE_GET_AND_INC (compunit.cu_version, hdrptr, 2, end_cu);
-
-      this_set = find_cu_tu_set_v2 (cu_offset, do_types);
+/* Run JOB for each part of JOBS, in parallel if possible, with the
+   output in order.  The last part is done in this process, so that the
+   state left behind for the sections displayed after this one is as it
+   would be without --threads.  A job returns zero, or -1 if the rest of
+   the section should not be displayed, in which case FALSE is returned.  */
 
-      if (compunit.cu_version < 5)
-	{
-	  compunit.cu_unit_type = DW_UT_compile;
-	  /* Initialize it due to a false compiler warning.  */
-	  compunit.cu_pointer_size = -1;
-	}
-      else
-	{
-	  SAFE_BYTE_GET_AND_INC (compunit.cu_unit_type, hdrptr, 1, end_cu);
-	  do_types = (compunit.cu_unit_type == DW_UT_type);
+static bool
+run_dwarf_jobs (struct dwarf_section_jobs *jobs,
+		int (*job) (void *, unsigned int))
+{
+  unsigned int last = jobs->count - 1;
+  unsigned int i;
+  int status = 0;
 
-	  SAFE_BYTE_GET_AND_INC (compunit.cu_pointer_size, hdrptr, 1, end_cu);
-	}
+  if (!run_parallel_output (last, dwarf_thread_count, job, jobs, &status))
+    for (i = 0; i < last && status == 0; i++)
+      status = job (jobs, i);
 
-      SAFE_BYTE_GET_AND_INC (compunit.cu_abbrev_offset, hdrptr, offset_size,
-			     end_cu);
+  if (status != 0)
+    return false;
+  return job (jobs, last) == 0;
+}
 
-      if (compunit.cu_unit_type == DW_UT_split_compile
-	  || compunit.cu_unit_type == DW_UT_skeleton)
-	{
-	  uint64_t dwo_id;
-	  SAFE_BYTE_GET_AND_INC (dwo_id, hdrptr, 8, end_cu);
-	}
+/* Display the units of SECTION from START up to STOP, or with DO_LOC
+   just scan them, as process_debug_info does.  The first of them is
+   unit number UNIT, and DO_TYPES is as it is at the start of that
+   unit.  *STOPPED is set if --dwarf-start was given and all of the
+   DIEs to be displayed have been.  Returns FALSE upon an error.  */
 
-      if (this_set == NULL)
-	{
-	  abbrev_base = 0;
-	  abbrev_size = debug_displays [abbrev_sec].section.size;
-	}
-      else
-	{
-	  abbrev_base = this_set->section_offsets [DW_SECT_ABBREV];
-	  abbrev_size = this_set->section_sizes [DW_SECT_ABBREV];
-	}
-
-      abbrev_list *list;
-      abbrev_list *free_list;
-      list = find_and_process_abbrev_set (&debug_displays[abbrev_sec].section,
-					  abbrev_base, abbrev_size,
-					  compunit.cu_abbrev_offset,
-					  &free_list);
-      start = end_cu;
-      if (list != NULL && list->first_abbrev != NULL)
-	record_abbrev_list_for_cu (cu_offset, start - section_begin,
-				   list, free_list);
-      else if (free_list != NULL)
-	free_abbrev_list (free_list);
-    }
+static bool
+process_debug_info_units (struct dwarf_section *section,
+			  enum dwarf_section_display_enum abbrev_sec,
+			  bool do_loc,
+			  bool do_types,
+			  unsigned int unit,
+			  unsigned char *start,
+			  unsigned char *stop,
+			  bool *stopped)
+{
+  unsigned char *section_begin = section->start;
+  unsigned char *end = section_begin + section->size;
+  unsigned char *released = start;
 
-  for (start = section_begin, unit = 0; start < end; unit++)
+  for (; start < stop; unit++)
     {
       DWARF2_Internal_CompUnit compunit;
       unsigned char *hdrptr;
@@ -3753,6 +3822,9 @@ process_debug_info (struct dwarf_section * section,
       size_t abbrev_size;
       unsigned char *end_cu;
 
+      /* The units before this one have been dealt with.  */
+      release_mapped_data (section, start, &released);
+
       hdrptr = start;
       cu_offset = start - section_begin;
 
@@ -3911,11 +3983,18 @@ process_debug_info (struct dwarf_section * section,
 	  continue;
 	}
 
-      /* Process the abbrevs used by this compilation unit.  */
+      /* Process the abbrevs used by this compilation unit, and let
+	 references into it use them too.  */
       abbrev_list *list;
+      abbrev_map *map;
       list = find_and_process_abbrev_set (&debug_displays[abbrev_sec].section,
 					  abbrev_base, abbrev_size,
 					  compunit.cu_abbrev_offset, NULL);
+      map = find_abbrev_map_by_offset (cu_offset);
+      if (map != NULL && map->list == NULL)
+	map->list = list;
+      else
+	map = NULL;
       level = 0;
       last_level = level;
       saved_level = -1;
@@ -3968,7 +4047,10 @@ process_debug_info (struct dwarf_section * section,
 		    }
 		}
 	      if (dwarf_start_die != 0 && level < saved_level)
-		return true;
+		{
+		  *stopped = true;
+		  return true;
+		}
 	      continue;
 	    }
 
@@ -4093,8 +4175,300 @@ process_debug_info (struct dwarf_section * section,
 	  if (entry->children)
 	    ++level;
 	}
+      if (map != NULL)
+	map->list = NULL;
       if (list != NULL)
 	free_abbrev_list (list);
+
+      if ((do_loc || do_debug_loc || do_debug_ranges || do_debug_info)
+	  && num_debug_info_entries == 0
+	  && alloc_num_debug_info_entries > unit
+	  && ! do_types)
+	trim_debug_information (&debug_information[unit]);
+    }
+
+  return true;
+}
+
+/* Display part I of the units in DATA, a struct dwarf_section_jobs.  */
+
+static int
+process_debug_info_job (void *data, unsigned int i)
+{
+  struct dwarf_section_jobs *jobs = (struct dwarf_section_jobs *) data;
+  bool stopped = false;
+
+  if (!process_debug_info_units (jobs->section, jobs->abbrev_sec, false,
+				 jobs->types[i], jobs->units[i],
+				 jobs->starts[i], jobs->starts[i + 1],
+				 &stopped))
+    return -1;
+  return 0;
+}
+
+/* Process the contents of a .debug_info section.
+   If do_loc is TRUE then we are scanning for location lists and dwo tags
+   and we do not want to display anything to the user.
+   If do_types is TRUE, we are processing a .debug_types section instead of
+   a .debug_info section.
+   The information displayed is restricted by the values in DWARF_START_DIE
+   and DWARF_CUTOFF_LEVEL.
+   Returns TRUE upon success.  Otherwise an error or warning message is
+   printed and FALSE is returned.  */
+
+static bool
+process_debug_info (struct dwarf_section * section,
+		    void *file,
+		    enum dwarf_section_display_enum abbrev_sec,
+		    bool do_loc,
+		    bool do_types)
+{
+  unsigned char *start = section->start;
+  unsigned char *end = start + section->size;
+  unsigned char *section_begin;
+  unsigned char *released = start;
+  unsigned int unit;
+  unsigned int num_units = 0;
+  uint64_t last_abbrev_base = 0;
+  uint64_t last_abbrev_offset = 0;
+  size_t last_abbrev_size = 0;
+  bool have_last_abbrev = false;
+  bool last_abbrev_ok = false;
+  struct dwarf_section_jobs jobs;
+
+  /* First scan the section to get the number of comp units.
+     Length sanity checks are done here.  */
+  for (section_begin = start, num_units = 0; section_begin < end;
+       num_units ++)
+    {
+      uint64_t length;
+
+      release_mapped_data (section, section_begin, &released);
+
+      /* Read the first 4 bytes.  For a 32-bit DWARF section, this
+	 will be the length.  For a 64-bit DWARF section, it'll be
+	 the escape code 0xffffffff followed by an 8 byte length.  */
+      SAFE_BYTE_GET_AND_INC (length, section_begin, 4, end);
+
+      if (length == 0xffffffff)
+	SAFE_BYTE_GET_AND_INC (length, section_begin, 8, end);
+      else if (length >= 0xfffffff0 && length < 0xffffffff)
+	{
+	  warn (_("Reserved length value (%#" PRIx64 ") found in section %s\n"),
+		length, section->name);
+	  return false;
+	}
+
+      /* Negative values are illegal, they may even cause infinite
+	 looping.  This can happen if we can't accurately apply
+	 relocations to an object file, or if the file is corrupt.  */
+      if (length > (size_t) (end - section_begin))
+	{
+	  warn (_("Corrupt unit length (got %#" PRIx64
+		  " expected at most %#tx) in section %s\n"),
+		length, end - section_begin, section->name);
+	  return false;
+	}
+      section_begin += length;
+    }
+
+  if (num_units == 0)
+    {
+      error (_("No comp units in %s section ?\n"), section->name);
+      return false;
+    }
+
+  if ((do_loc || do_debug_loc || do_debug_ranges || do_debug_info)
+      && num_debug_info_entries == 0
+      && ! do_types)
+    {
+
+      /* Then allocate an array to hold the information.  */
+      debug_information = (debug_info *) cmalloc (num_units,
+						  sizeof (* debug_information));
+      if (debug_information == NULL)
+	{
+	  error (_("Not enough memory for a debug info array of %u entries\n"),
+		 num_units);
+	  alloc_num_debug_info_entries = num_debug_info_entries = 0;
+	  return false;
+	}
+
+      /* PR 17531: file: 92ca3797.
+	 We cannot rely upon the debug_information array being initialised
+	 before it is used.  A corrupt file could easily contain references
+	 to a unit for which information has not been made available.  So
+	 we ensure that the array is zeroed here.  */
+      memset (debug_information, 0, num_units * sizeof (*debug_information));
+
+      alloc_num_debug_info_entries = num_units;
+    }
+
+  if (!do_loc)
+    {
+      load_debug_section_with_follow (str, file);
+      load_debug_section_with_follow (line_str, file);
+      load_debug_section_with_follow (str_dwo, file);
+      load_debug_section_with_follow (str_index, file);
+      load_debug_section_with_follow (str_index_dwo, file);
+      load_debug_section_with_follow (debug_addr, file);
+    }
+
+  load_debug_section_with_follow (abbrev_sec, file);
+  load_debug_section_with_follow (loclists, file);
+  load_debug_section_with_follow (rnglists, file);
+  load_debug_section_with_follow (loclists_dwo, file);
+  load_debug_section_with_follow (rnglists_dwo, file);
+
+  if (debug_displays [abbrev_sec].section.start == NULL)
+    {
+      warn (_("Unable to locate %s section!\n"),
+	    debug_displays [abbrev_sec].section.uncompressed_name);
+      return false;
+    }
+
+  if (!do_loc && dwarf_start_die == 0)
+    introduce (section, false);
+
+  free_all_abbrevs ();
+
+  /* In order to be able to resolve DW_FORM_ref_addr forms we need
+     to load *all* of the abbrevs for all CUs in this .debug_info
+     section.  This does effectively mean that we (partially) read
+     every CU header twice.  */
+  released = start;
+  for (section_begin = start; start < end;)
+    {
+      DWARF2_Internal_CompUnit compunit;
+      unsigned char *hdrptr;
+      uint64_t abbrev_base;
+      size_t abbrev_size;
+      uint64_t cu_offset;
+      unsigned int offset_size;
+      struct cu_tu_set *this_set;
+      unsigned char *end_cu;
+
+      hdrptr = start;
+      cu_offset = start - section_begin;
+
+      SAFE_BYTE_GET_AND_INC (compunit.cu_length, hdrptr, 4, end);
+
+      if (compunit.cu_length == 0xffffffff)
+	{
+	  SAFE_BYTE_GET_AND_INC (compunit.cu_length, hdrptr, 8, end);
+	  offset_size = 8;
+	}
+      else
+	offset_size = 4;
+      end_cu = hdrptr + compunit.cu_length;
+
+      SAFE_BYTE_GET_AND_INC (compunit.cu_version, hdrptr, 2, end_cu);
+
+      this_set = find_cu_tu_set_v2 (cu_offset, do_types);
+
+      if (compunit.cu_version < 5)
+	{
+	  compunit.cu_unit_type = DW_UT_compile;
+	  /* Initialize it due to a false compiler warning.  */
+	  compunit.cu_pointer_size = -1;
+	}
+      else
+	{
+	  SAFE_BYTE_GET_AND_INC (compunit.cu_unit_type, hdrptr, 1, end_cu);
+	  do_types = (compunit.cu_unit_type == DW_UT_type);
+
+	  SAFE_BYTE_GET_AND_INC (compunit.cu_pointer_size, hdrptr, 1, end_cu);
+	}
+
+      SAFE_BYTE_GET_AND_INC (compunit.cu_abbrev_offset, hdrptr, offset_size,
+			     end_cu);
+
+      if (compunit.cu_unit_type == DW_UT_split_compile
+	  || compunit.cu_unit_type == DW_UT_skeleton)
+	{
+	  uint64_t dwo_id;
+	  SAFE_BYTE_GET_AND_INC (dwo_id, hdrptr, 8, end_cu);
+	}
+
+      if (this_set == NULL)
+	{
+	  abbrev_base = 0;
+	  abbrev_size = debug_displays [abbrev_sec].section.size;
+	}
+      else
+	{
+	  abbrev_base = this_set->section_offsets [DW_SECT_ABBREV];
+	  abbrev_size = this_set->section_sizes [DW_SECT_ABBREV];
+	}
+
+      /* Check the abbrevs here, but only keep them if they are needed
+	 to follow a reference into this CU.  Consecutive CUs often
+	 share a set.  */
+      if (!have_last_abbrev
+	  || abbrev_base != last_abbrev_base
+	  || abbrev_size != last_abbrev_size
+	  || compunit.cu_abbrev_offset != last_abbrev_offset)
+	{
+	  abbrev_list *list;
+
+	  list = find_and_process_abbrev_set (&debug_displays[abbrev_sec].section,
+					      abbrev_base, abbrev_size,
+					      compunit.cu_abbrev_offset, NULL);
+	  have_last_abbrev = true;
+	  last_abbrev_ok = list != NULL && list->first_abbrev != NULL;
+	  last_abbrev_base = abbrev_base;
+	  last_abbrev_size = abbrev_size;
+	  last_abbrev_offset = compunit.cu_abbrev_offset;
+	  if (list != NULL)
+	    free_abbrev_list (list);
+	}
+      start = end_cu;
+      if (last_abbrev_ok)
+	record_abbrev_list_for_cu (cu_offset, start - section_begin,
+				   &debug_displays[abbrev_sec].section,
+				   abbrev_base, abbrev_size,
+				   compunit.cu_abbrev_offset);
+      release_mapped_data (section, start, &released);
+    }
+
+  if (!do_loc
+      && dwarf_start_die == 0
+      && split_dwarf_units (section, true, do_types, &jobs))
+    {
+      /* With --threads, display groups of units in parallel.  */
+      bool ok;
+
+      jobs.section = section;
+      jobs.file = file;
+      jobs.abbrev_sec = abbrev_sec;
+      jobs.decoded = false;
+      ok = run_dwarf_jobs (&jobs, process_debug_info_job);
+      free_dwarf_jobs (&jobs);
+
+      /* The information recorded about the units by the jobs is lost.
+	 Forget all of it, and let load_debug_info read it again if it
+	 is needed.  */
+      if (num_debug_info_entries == 0 && ! do_types)
+	{
+	  for (unit = 0; unit < alloc_num_debug_info_entries; unit++)
+	    free_debug_information (&debug_information[unit]);
+	  free (debug_information);
+	  debug_information = NULL;
+	  alloc_num_debug_info_entries = 0;
+	}
+
+      if (!ok)
+	return false;
+    }
+  else
+    {
+      bool stopped = false;
+
+      if (!process_debug_info_units (section, abbrev_sec, do_loc, do_types,
+				     0, section_begin, end, &stopped))
+	return false;
+      if (stopped)
+	return true;
     }
 
   /* Set num_debug_info_entries here so that it can be used to check if
@@ -4464,8 +4838,6 @@ display_debug_lines_raw (struct dwarf_section *  section,
   unsigned char *start = section->start;
   int verbose_view = 0;
 
-  introduce (section, true);
-
   while (data < end)
     {
       static DWARF2_Internal_LineInfo saved_linfo;
@@ -4887,8 +5259,6 @@ display_debug_lines_decoded (struct dwarf_section *  section,
 {
   static DWARF2_Internal_LineInfo saved_linfo;
 
-  introduce (section, false);
-
   while (data < end)
     {
       /* This loop amounts to one iteration per compilation unit.  */
@@ -5672,6 +6042,47 @@ display_debug_lines_decoded (struct dwarf_section *  section,
   return 1;
 }
 
+/* With --threads, split the line number programs in SECTION between
+   jobs that display them, decoded if DECODED.  Return FALSE if the
+   section should be displayed in one go.  */
+
+static bool
+split_debug_lines (struct dwarf_section *section, void *file, bool decoded,
+		   struct dwarf_section_jobs *jobs)
+{
+  /* A .debug_line.<foo> fragment holds just one set of statements.  */
+  if (startswith (section->name, ".debug_line.")
+      && strcmp (section->name, ".debug_line.dwo") != 0)
+    return false;
+
+  if (!split_dwarf_units (section, false, false, jobs))
+    return false;
+
+  jobs->section = section;
+  jobs->file = file;
+  jobs->decoded = decoded;
+  return true;
+}
+
+/* Display part I of the line number programs in DATA, a struct
+   dwarf_section_jobs.  */
+
+static int
+display_debug_lines_job (void *data, unsigned int i)
+{
+  struct dwarf_section_jobs *jobs = (struct dwarf_section_jobs *) data;
+  int ret;
+
+  if (jobs->decoded)
+    ret = display_debug_lines_decoded (jobs->section, jobs->section->start,
+				       jobs->starts[i], jobs->starts[i + 1],
+				       jobs->file);
+  else
+    ret = display_debug_lines_raw (jobs->section, jobs->starts[i],
+				   jobs->starts[i + 1], jobs->file);
+  return ret ? 0 : -1;
+}
+
 static int
 display_debug_lines (struct dwarf_section *section, void *file)
 {
@@ -5679,15 +6090,35 @@ display_debug_lines (struct dwarf_section *section, void *file)
   unsigned char *end = data + section->size;
   int retValRaw = 1;
   int retValDecoded = 1;
+  struct dwarf_section_jobs jobs;
 
   if (do_debug_lines == 0)
     do_debug_lines |= FLAG_DEBUG_LINES_RAW;
 
   if (do_debug_lines & FLAG_DEBUG_LINES_RAW)
-    retValRaw = display_debug_lines_raw (section, data, end, file);
+    {
+      introduce (section, true);
+      if (split_debug_lines (section, file, false, &jobs))
+	{
+	  retValRaw = run_dwarf_jobs (&jobs, display_debug_lines_job);
+	  free_dwarf_jobs (&jobs);
+	}
+      else
+	retValRaw = display_debug_lines_raw (section, data, end, file);
+    }
 
   if (do_debug_lines & FLAG_DEBUG_LINES_DECODED)
-    retValDecoded = display_debug_lines_decoded (section, data, data, end, file);
+    {
+      introduce (section, false);
+      if (split_debug_lines (section, file, true, &jobs))
+	{
+	  retValDecoded = run_dwarf_jobs (&jobs, display_debug_lines_job);
+	  free_dwarf_jobs (&jobs);
+	}
+      else
+	retValDecoded = display_debug_lines_decoded (section, data, data, end,
+						     file);
+    }
 
   if (!retValRaw || !retValDecoded)
     return 0;
@@ -12294,8 +12725,8 @@ dwarf_select_sections_all (void)
   do_debug_str_offsets = 1;
 }
 
-#define NO_ABBREVS   NULL, NULL, NULL, 0, 0, 0, NULL, 0
-#define ABBREV(N)    NULL, NULL, NULL, 0, 0, N, NULL, 0
+#define NO_ABBREVS   NULL, NULL, NULL, 0, 0, 0, NULL, 0, false
+#define ABBREV(N)    NULL, NULL, NULL, 0, 0, N, NULL, 0, false
 
 /* N.B. The order here must match the order in section_display_enum.  */
 
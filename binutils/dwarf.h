@@ -145,6 +145,11 @@ struct dwarf_section
   /* Used by clients to help them implement the reloc_at callback.  */
   void *                           reloc_info;
   uint64_t                         num_relocs;
+  /* Set by clients if START points into a read-only mapping of the
+     file rather than into allocated memory.  Pages of such a section
+     that have been read can be dropped, and are read in again from the
+     file if they are needed later.  */
+  bool                             mapped;
 };
 
 /* A structure containing the name of a debug section
@@ -238,6 +243,8 @@ extern unsigned long dwarf_start_die;
 
 extern int dwarf_check;
 
+extern unsigned int dwarf_thread_count;
+
 extern void init_dwarf_regnames_by_elf_machine_code (unsigned int);
 extern void init_dwarf_regnames_by_bfd_arch_and_mach (enum bfd_architecture arch,
 						      unsigned long mach);
@@ -35,6 +35,7 @@
 #include "coff/internal.h"
 #include "libcoff.h"
 #include "bucomm.h"
+#include "parallel.h"
 #include "demanguse.h"
 #include "plugin-api.h"
 #include "plugin.h"
@@ -180,6 +181,7 @@ static int non_weak = 0;	/* Ignore weak symbols.  */
 static int no_sort = 0;		/* Don't sort; print syms in order found.  */
 static int print_debug_syms = 0;/* Print debugger-only symbols too.  */
 static int print_armap = 0;	/* Describe __.SYMDEF data in archive files.  */
+static int armap_only = 0;	/* Print only the __.SYMDEF data.  */
 static int print_size = 0;	/* Print size of defined symbols.  */
 static int reverse_sort = 0;	/* Sort in downward(alpha or numeric) order.  */
 static int sort_numerically = 0;/* Sort in numeric rather than alpha order.  */
@@ -192,6 +194,7 @@ static int line_numbers = 0;	/* Print line numbers for symbols.  */
 static int allow_special_symbols = 0;  /* Allow special symbols.  */
 static int with_symbol_versions = -1; /* Output symbol version information.  */
 static int quiet = 0;		/* Suppress "no symbols" diagnostic.  */
+static unsigned int thread_count = 1;	/* --threads */
 
 /* The characters to use for global and local ifunc symbols.  */
 #if DEFAULT_F_FOR_IFUNC_SYMBOLS
@@ -240,7 +243,8 @@ enum long_option_values
   OPTION_NO_RECURSE_LIMIT,
   OPTION_IFUNC_CHARS,
   OPTION_UNICODE,
-  OPTION_QUIET
+  OPTION_QUIET,
+  OPTION_THREADS
 };
 
 static struct option long_options[] =
@@ -262,6 +266,7 @@ static struct option long_options[] =
   {"numeric-sort", no_argument, 0, 'n'},
   {"plugin", required_argument, 0, OPTION_PLUGIN},
   {"portability", no_argument, 0, 'P'},
+  {"armap-only", no_argument, &armap_only, 1},
   {"print-armap", no_argument, &print_armap, 1},
   {"print-file-name", no_argument, 0, 'o'},
   {"print-size", no_argument, 0, 'S'},
@@ -274,6 +279,7 @@ static struct option long_options[] =
   {"special-syms", no_argument, &allow_special_symbols, 1},
   {"synthetic", no_argument, &show_synthetic, 1},
   {"target", required_argument, 0, OPTION_TARGET},
+  {"threads", optional_argument, 0, OPTION_THREADS},
   {"defined-only", no_argument, 0, 'U'},
   {"undefined-only", no_argument, 0, 'u'},
   {"unicode", required_argument, NULL, OPTION_UNICODE},
@@ -343,6 +349,9 @@ usage (FILE *stream, int status)
   -S, --print-size       Print size of defined symbols\n"));
   fprintf (stream, _("\
   -s, --print-armap      Include index for symbols from archive members\n"));
+  fprintf (stream, _("\
+      --armap-only       Display only the index of archives, without reading\n\
+                           their members\n"));
   fprintf (stream, _("\
       --quiet            Suppress \"no symbols\" diagnostic\n"));
   fprintf (stream, _("\
@@ -355,6 +364,8 @@ usage (FILE *stream, int status)
   -t, --radix=RADIX      Use RADIX for printing symbol values\n"));
   fprintf (stream, _("\
       --target=BFDNAME   Specify the target object format as BFDNAME\n"));
+  fprintf (stream, _("\
+      --threads[=N]      Use up to N processes to read archive members\n"));
   fprintf (stream, _("\
   -u, --undefined-only   Display only undefined symbols\n"));
   fprintf (stream, _("\
@@ -1558,18 +1569,162 @@ set_print_width (bfd *file)
   print_format_string = get_print_format ();
 }
 
+/* Display the symbols of ARFILE, a member of archive FILE.  */
+
+static void
+display_archive_member (bfd *file, bfd *arfile)
+{
+  char **matching;
+
+  if (bfd_check_format_matches (arfile, bfd_object, &matching))
+    {
+      set_print_width (arfile);
+      format->print_archive_member (bfd_get_filename (file),
+				    bfd_get_filename (arfile));
+      display_rel_file (arfile, file);
+    }
+  else
+    {
+      bfd_nonfatal (bfd_get_filename (arfile));
+      if (bfd_get_error () == bfd_error_file_ambiguously_recognized)
+	list_matching_formats (matching);
+    }
+}
+
+/* The members of an archive, split between --threads jobs.  */
+
+struct archive_members
+{
+  bfd *archive;
+  bfd **members;
+  /* Job I displays the members from SPLITS[I] up to SPLITS[I + 1].  */
+  unsigned int *splits;
+};
+
+static int
+display_archive_members_job (void *data, unsigned int i)
+{
+  struct archive_members *info = (struct archive_members *) data;
+  unsigned int j;
+
+  for (j = info->splits[i]; j < info->splits[i + 1]; j++)
+    display_archive_member (info->archive, info->members[j]);
+  return 0;
+}
+
+/* Display the members of archive FILE in up to THREAD_COUNT processes
+   at once, with the same output as the loop in display_archive.  */
+
+static void
+display_archive_parallel (bfd *file)
+{
+  struct archive_members info;
+  bfd *arfile = NULL;
+  bfd_error_type err;
+  unsigned int count = 0, max = 0, njobs, i, j;
+  bool looped = false;
+  uint64_t total = 0, sum;
+  bool done = false;
+  int status;
+
+  info.archive = file;
+  info.members = NULL;
+
+  /* Opening a member only reads its header, so find them all first.  */
+  for (;;)
+    {
+      bfd *next = bfd_openr_next_archived_file (file, arfile);
+
+      if (next == NULL)
+	break;
+      if (count == max)
+	{
+	  max = max ? max * 2 : 64;
+	  info.members = xrealloc (info.members, max * sizeof (bfd *));
+	}
+      info.members[count++] = next;
+      total += bfd_get_size (next);
+      /* A broken archive can point back at the same member, which
+	 the serial loop displays a second time before it stops.  */
+      if (next == arfile)
+	{
+	  looped = true;
+	  break;
+	}
+      arfile = next;
+    }
+  err = bfd_get_error ();
+
+  njobs = thread_count * 4;
+  if (njobs > count)
+    njobs = count;
+  if (njobs > 1)
+    {
+      /* Give each job about the same number of bytes to read.  */
+      info.splits = xmalloc ((njobs + 1) * sizeof (unsigned int));
+      info.splits[0] = 0;
+      for (i = 1, j = 0, sum = 0; i < njobs; i++)
+	{
+	  while (j < count - (njobs - i) && sum < total / njobs * i)
+	    sum += bfd_get_size (info.members[j++]);
+	  if (j <= info.splits[i - 1])
+	    j = info.splits[i - 1] + 1;
+	  info.splits[i] = j;
+	}
+      info.splits[njobs] = count;
+
+      /* Make each job open the archive for itself, rather than share
+	 the file position of our descriptor.  */
+      bfd_cache_close_all ();
+      done = run_parallel_output (njobs, thread_count,
+				  display_archive_members_job, &info,
+				  &status);
+      free (info.splits);
+      /* A job that failed exited early, as we would have done.  */
+      if (done && status != 0)
+	xexit (1);
+    }
+
+  if (!done)
+    for (i = 0; i < count; i++)
+      display_archive_member (file, info.members[i]);
+
+  if (!looped && err != bfd_error_no_more_archived_files)
+    {
+      bfd_set_error (err);
+      bfd_nonfatal (bfd_get_filename (file));
+    }
+
+  for (i = 0; i < count - looped; i++)
+    {
+      free_lineno_cache (info.members[i]);
+      bfd_close (info.members[i]);
+    }
+  free (info.members);
+}
+
 static void
 display_archive (bfd *file)
 {
   bfd *arfile = NULL;
   bfd *last_arfile = NULL;
-  char **matching;
 
   format->print_archive_filename (bfd_get_filename (file));
 
-  if (print_armap)
+  if (print_armap || armap_only)
     print_symdef_entry (file);
 
+  /* The index says which members define which symbols without the
+     members having to be read.  */
+  if (armap_only)
+    return;
+
+  if (thread_count > 1)
+    {
+      display_archive_parallel (file);
+      return;
+    }
+
   for (;;)
     {
       arfile = bfd_openr_next_archived_file (file, arfile);
@@ -1581,19 +1736,7 @@ display_archive (bfd *file)
 	  break;
 	}
 
-      if (bfd_check_format_matches (arfile, bfd_object, &matching))
-	{
-	  set_print_width (arfile);
-	  format->print_archive_member (bfd_get_filename (file),
-					bfd_get_filename (arfile));
-	  display_rel_file (arfile, file);
-	}
-      else
-	{
-	  bfd_nonfatal (bfd_get_filename (arfile));
-	  if (bfd_get_error () == bfd_error_file_ambiguously_recognized)
-	    list_matching_formats (matching);
-	}
+      display_archive_member (file, arfile);
 
       if (last_arfile != NULL)
 	{
@@ -2123,6 +2266,12 @@ main (int argc, char **argv)
 	  ifunc_type_chars = optarg;
 	  break;
 
+	case OPTION_THREADS:
+	  thread_count = parse_thread_count (optarg);
+	  if (thread_count == 0)
+	    fatal (_("%s: invalid thread count: %s"), "--threads", optarg);
+	  break;
+
 	case 0:		/* A long option that just sets a flag.  */
 	  break;
 
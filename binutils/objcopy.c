@@ -24,6 +24,7 @@
 #include "libiberty.h"
 #include "bucomm.h"
 #include "budbg.h"
+#include "parallel.h"
 #include "filenames.h"
 #include "fnmatch.h"
 #include "elf-bfd.h"
@@ -95,6 +96,15 @@ static bool verbose;		/* Print file and target names.  */
 static bool preserve_dates;	/* Preserve input file timestamp.  */
 static int deterministic = -1;		/* Enable deterministic archives.  */
 static int status = 0;			/* Exit status.  */
+static unsigned int thread_count = 1;	/* --threads.  */
+
+/* Sections bigger than this whose contents are copied unchanged are
+   copied this many bytes at a time.  */
+#define COPY_CHUNK_SIZE (1024 * 1024)
+
+/* With more than one thread, the most bytes of decompressed section
+   contents to read in at once, unless a single section is bigger.  */
+#define COPY_BATCH_SIZE (64 * 1024 * 1024)
 
 static bool    merge_notes = false;	/* Merge note sections.  */
 
@@ -370,6 +380,7 @@ enum command_line_switch
   OPTION_STRIP_UNNEEDED_SYMBOL,
   OPTION_STRIP_UNNEEDED_SYMBOLS,
   OPTION_SUBSYSTEM,
+  OPTION_THREADS,
   OPTION_UPDATE_SECTION,
   OPTION_VERILOG_DATA_WIDTH,
   OPTION_WEAKEN,
@@ -511,6 +522,7 @@ static struct option copy_options[] =
   {"strip-unneeded-symbols", required_argument, 0, OPTION_STRIP_UNNEEDED_SYMBOLS},
   {"subsystem", required_argument, 0, OPTION_SUBSYSTEM},
   {"target", required_argument, 0, 'F'},
+  {"threads", optional_argument, 0, OPTION_THREADS},
   {"update-section", required_argument, 0, OPTION_UPDATE_SECTION},
   {"verbose", no_argument, 0, 'v'},
   {"verilog-data-width", required_argument, 0, OPTION_VERILOG_DATA_WIDTH},
@@ -554,7 +566,7 @@ extern enum bfd_endian VerilogDataEndianness;
 static void setup_section (bfd *, asection *, void *);
 static void setup_bfd_headers (bfd *, bfd *);
 static void copy_relocations_in_section (bfd *, asection *, void *);
-static void copy_section (bfd *, asection *, void *);
+static void copy_sections (bfd *, bfd *);
 static void get_sections (bfd *, asection *, void *);
 static int compare_section_lma (const void *, const void *);
 static void mark_symbols_used_in_relocations (bfd *, asection *, void *);
@@ -686,6 +698,8 @@ copy_usage (FILE *stream, int exit_status)
      --compress-debug-sections[={none|zlib|zlib-gnu|zlib-gabi|zstd}]\n\
 				   Compress DWARF debug sections\n\
      --decompress-debug-sections   Decompress DWARF debug sections using zlib\n\
+     --threads[=<number>]          Use up to <number> threads to compress and\n\
+                                     decompress debug sections\n\
      --elf-stt-common=[yes|no]     Generate ELF common symbols with STT_COMMON\n\
                                      type\n\
      --verilog-data-width <number> Specifies data width, in bytes, for verilog output\n\
@@ -3357,7 +3371,7 @@ copy_object (bfd *ibfd, bfd *obfd, const bfd_arch_info_type *input_arch)
     return false;
 
   /* This has to happen after the symbol table has been set.  */
-  bfd_map_over_sections (ibfd, copy_section, obfd);
+  copy_sections (ibfd, obfd);
   if (status != 0)
     return false;
 
@@ -4406,19 +4420,82 @@ copy_relocations_in_section (bfd *ibfd, sec_ptr isection, void *obfdarg)
     }
 }
 
-/* Copy the data of input section ISECTION of IBFD
-   to an output section with the same name in OBFD.  */
+/* Return TRUE if the SIZE bytes of contents of ISECTION in IBFD can
+   be copied to the output section in OBFD a piece at a time, because
+   they are big enough for it to matter and are to be copied unchanged.
+   The contents of sections that are decompressed, converted for an
+   output of a different ELF class, or rearranged by --reverse-bytes or
+   --interleave all have to be read in at once.  So do those of a
+   section that claims to be bigger than the file holding it, so that
+   bfd_get_full_section_contents can complain about it.  */
+
+static bool
+can_copy_section_in_chunks (bfd *ibfd, sec_ptr isection, bfd *obfd,
+			    bfd_size_type size)
+{
+  ufile_ptr filesize = bfd_get_file_size (ibfd);
+
+  return (size > COPY_CHUNK_SIZE
+	  && (filesize == 0 || size <= filesize)
+	  && reverse_bytes == 0
+	  && copy_byte < 0
+	  && isection->compress_status == COMPRESS_SECTION_NONE
+	  && bfd_get_flavour (ibfd) == bfd_target_elf_flavour
+	  && bfd_get_flavour (obfd) == bfd_target_elf_flavour
+	  && (get_elf_backend_data (ibfd)->s->elfclass
+	      == get_elf_backend_data (obfd)->s->elfclass));
+}
+
+/* Copy the SIZE bytes of contents of ISECTION in IBFD to OSECTION in
+   OBFD, COPY_CHUNK_SIZE bytes at a time.  */
 
 static void
-copy_section (bfd *ibfd, sec_ptr isection, void *obfdarg)
+copy_section_in_chunks (bfd *ibfd, sec_ptr isection, bfd *obfd,
+			sec_ptr osection, bfd_size_type size)
+{
+  bfd_byte *chunk = xmalloc (COPY_CHUNK_SIZE);
+  bfd_size_type off;
+
+  for (off = 0; off < size; off += COPY_CHUNK_SIZE)
+    {
+      bfd_size_type count = size - off;
+
+      if (count > COPY_CHUNK_SIZE)
+	count = COPY_CHUNK_SIZE;
+      if (!bfd_get_section_contents (ibfd, isection, chunk, off, count))
+	{
+	  bfd_set_section_size (osection, 0);
+	  status = 1;
+	  bfd_nonfatal_message (NULL, ibfd, isection, NULL);
+	  break;
+	}
+      if (!bfd_set_section_contents (obfd, osection, chunk, off, count))
+	{
+	  status = 1;
+	  bfd_nonfatal_message (NULL, obfd, osection, NULL);
+	  break;
+	}
+    }
+  free (chunk);
+}
+
+/* Copy the data of input section ISECTION of IBFD to an output
+   section with the same name in OBFD.  If MEMHUNK is not NULL it holds
+   the full contents of ISECTION, already read in, and is freed.  */
+
+static void
+copy_section_contents (bfd *ibfd, sec_ptr isection, bfd *obfd,
+		       bfd_byte *memhunk)
 {
-  bfd *obfd = (bfd *) obfdarg;
   struct section_list *p;
   sec_ptr osection;
   bfd_size_type size;
 
   if (skip_section (ibfd, isection, true))
-    return;
+    {
+      free (memhunk);
+      return;
+    }
 
   osection = isection->output_section;
   /* The output SHF_COMPRESSED section size is different from input if
@@ -4430,9 +4507,15 @@ copy_section (bfd *ibfd, sec_ptr isection, void *obfdarg)
   if (bfd_section_flags (isection) & SEC_HAS_CONTENTS
       && bfd_section_flags (osection) & SEC_HAS_CONTENTS)
     {
-      bfd_byte *memhunk = NULL;
+      if (memhunk == NULL
+	  && can_copy_section_in_chunks (ibfd, isection, obfd, size))
+	{
+	  copy_section_in_chunks (ibfd, isection, obfd, osection, size);
+	  return;
+	}
 
-      if (!bfd_get_full_section_contents (ibfd, isection, &memhunk)
+      if ((memhunk == NULL
+	   && !bfd_get_full_section_contents (ibfd, isection, &memhunk))
 	  || !bfd_convert_section_contents (ibfd, isection, obfd,
 					    &memhunk, &size))
 	{
@@ -4513,7 +4596,8 @@ copy_section (bfd *ibfd, sec_ptr isection, void *obfdarg)
 				   false, SECTION_CONTEXT_SET_FLAGS)) != NULL
 	   && (p->flags & SEC_HAS_CONTENTS) != 0)
     {
-      void *memhunk = xmalloc (size);
+      free (memhunk);
+      memhunk = xmalloc (size);
 
       /* We don't permit the user to turn off the SEC_HAS_CONTENTS
 	 flag--they can just remove the section entirely and add it
@@ -4533,6 +4617,83 @@ copy_section (bfd *ibfd, sec_ptr isection, void *obfdarg)
     }
 }
 
+/* Return TRUE if ISECTION of IBFD is to be copied and needs
+   decompressing.  */
+
+static bool
+is_decompressed_section (bfd *ibfd, sec_ptr isection)
+{
+  return ((isection->compress_status == DECOMPRESS_SECTION_ZLIB
+	   || isection->compress_status == DECOMPRESS_SECTION_ZSTD)
+	  && !skip_section (ibfd, isection, true)
+	  && (bfd_section_flags (isection) & SEC_HAS_CONTENTS) != 0
+	  && (bfd_section_flags (isection->output_section)
+	      & SEC_HAS_CONTENTS) != 0);
+}
+
+/* Copy the data of all the sections of IBFD to OBFD.  With more than
+   one thread, the sections that need decompressing are read in and
+   decompressed in batches of up to COPY_BATCH_SIZE bytes, each batch
+   on several threads, ahead of being copied in turn.  */
+
+static void
+copy_sections (bfd *ibfd, bfd *obfd)
+{
+  asection **secs;
+  bfd_byte **contents;
+  unsigned int count, next, batch;
+  asection *isection;
+
+  if (thread_count <= 1)
+    {
+      for (isection = ibfd->sections; isection; isection = isection->next)
+	copy_section_contents (ibfd, isection, obfd, NULL);
+      return;
+    }
+
+  count = 0;
+  for (isection = ibfd->sections; isection; isection = isection->next)
+    if (is_decompressed_section (ibfd, isection))
+      count++;
+  secs = xmalloc ((count + 1) * sizeof (*secs));
+  contents = xcalloc (count + 1, sizeof (*contents));
+  count = 0;
+  for (isection = ibfd->sections; isection; isection = isection->next)
+    if (is_decompressed_section (ibfd, isection))
+      secs[count++] = isection;
+
+  next = 0;
+  batch = 0;
+  for (isection = ibfd->sections; isection; isection = isection->next)
+    {
+      bfd_byte *memhunk = NULL;
+
+      if (next < count && secs[next] == isection)
+	{
+	  if (next == batch)
+	    {
+	      bfd_size_type total = 0;
+
+	      /* Start a new batch.  It always takes in at least one
+		 section, however big.  */
+	      do
+		total += bfd_section_size (secs[batch++]);
+	      while (batch < count
+		     && total + bfd_section_size (secs[batch]) <= COPY_BATCH_SIZE);
+	      /* Sections whose contents can't be got here are read again
+		 by copy_section_contents, which reports the error.  */
+	      bfd_get_full_sections_contents (ibfd, secs + next,
+					      contents + next, batch - next);
+	    }
+	  memhunk = contents[next++];
+	}
+      copy_section_contents (ibfd, isection, obfd, memhunk);
+    }
+
+  free (contents);
+  free (secs);
+}
+
 /* Get all the sections.  This is used when --gap-fill or --pad-to is
    used.  */
 
@@ -5856,6 +6017,12 @@ copy_main (int argc, char *argv[])
 	  set_pe_subsystem (optarg);
 	  break;
 
+	case OPTION_THREADS:
+	  thread_count = parse_thread_count (optarg);
+	  if (thread_count == 0)
+	    fatal (_("%s: invalid thread count: %s"), "--threads", optarg);
+	  break;
+
 	case OPTION_STACK:
 	  {
 	    char *end;
@@ -5932,6 +6099,7 @@ copy_main (int argc, char *argv[])
     output_filename = argv[optind + 1];
 
   default_deterministic ();
+  bfd_set_thread_count (thread_count);
 
   /* Default is to strip no symbols.  */
   if (strip_symbols == STRIP_UNDEF && discard_locals == LOCALS_UNDEF)
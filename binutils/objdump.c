@@ -54,6 +54,7 @@
 #include "coff-bfd.h"
 #include "bucomm.h"
 #include "elfcomm.h"
+#include "parallel.h"
 #include "demanguse.h"
 #include "dwarf.h"
 #include "ctf-api.h"
@@ -117,6 +118,7 @@ static int disassemble_zeroes;		/* --disassemble-zeroes */
 static bool formats_info;		/* -i */
 static int wide_output;			/* -w */
 static int insn_width;			/* --insn-width */
+static unsigned int thread_count = 1;	/* --threads */
 static bfd_vma start_address = (bfd_vma) -1; /* --start-address */
 static bfd_vma stop_address = (bfd_vma) -1;  /* --stop-address */
 static int dump_debugging;		/* --debugging */
@@ -208,6 +210,42 @@ static asymbol **sorted_syms;
 /* Number of symbols in `sorted_syms'.  */
 static long sorted_symcount = 0;
 
+/* The symbols in `sorted_syms' grouped by the name of their section,
+   so that a symbol in a given section can be found without looking at
+   the symbols in all the others.  */
+struct section_syms
+{
+  /* The section name.  */
+  const char *name;
+  /* Number of symbols in sections with that name.  */
+  long count;
+  /* Indices in `sorted_syms' of the symbols, in increasing order.  */
+  long *places;
+};
+
+/* The groups, sorted by section name.  */
+static struct section_syms *section_syms;
+
+/* Number of groups in `section_syms'.  */
+static long section_syms_count;
+
+/* Storage for the `places' of all the groups.  */
+static long *section_sym_places;
+
+/* `sorted_syms' in the order the groups' `places' refer to, where no
+   section is preferred over another.  */
+static asymbol **sorted_syms_base;
+
+/* Whether `sorted_syms' differs from `sorted_syms_base'.  */
+static bool sorted_syms_changed;
+
+/* Scratch space for sort_symbols_for_section.  */
+static asymbol **sorted_syms_scratch;
+
+/* The symbols in the section being disassembled, with `places' that
+   refer to the current order of `sorted_syms'.  */
+static struct section_syms sorted_section_syms;
+
 /* The dynamic symbol table.  */
 static asymbol **dynsyms;
 
@@ -401,6 +439,8 @@ usage (FILE *stream, int status)
       fprintf (stream, _("\
       --show-all-symbols         When disassembling, display all symbols at a given address\n"));
       fprintf (stream, _("\
+      --threads[=N]              Use up to N processes to disassemble large sections\n"));
+      fprintf (stream, _("\
       --special-syms             Include special symbols in symbol dumps\n"));
       fprintf (stream, _("\
       --inlines                  Print all inlines for source line (with -l)\n"));
@@ -485,7 +525,8 @@ enum option_values
 #endif
     OPTION_SFRAME,
     OPTION_VISUALIZE_JUMPS,
-    OPTION_DISASSEMBLER_COLOR
+    OPTION_DISASSEMBLER_COLOR,
+    OPTION_THREADS
   };
 
 static struct option long_options[]=
@@ -549,6 +590,7 @@ static struct option long_options[]=
   {"stop-address", required_argument, NULL, OPTION_STOP_ADDRESS},
   {"syms", no_argument, NULL, 't'},
   {"target", required_argument, NULL, 'b'},
+  {"threads", optional_argument, NULL, OPTION_THREADS},
   {"unicode", required_argument, NULL, 'U'},
   {"version", no_argument, NULL, 'V'},
   {"visualize-jumps", optional_argument, 0, OPTION_VISUALIZE_JUMPS},
@@ -1091,9 +1133,9 @@ remove_useless_symbols (asymbol **symbols, long count)
   return out_ptr - symbols;
 }
 
-static const asection *compare_section;
-
-/* Sort symbols into value order.  */
+/* Sort symbols into value order.  Among symbols with the same value,
+   sort_symbols_for_section later moves those in the section being
+   disassembled to the front.  */
 
 static int
 compare_symbols (const void *ap, const void *bp)
@@ -1104,7 +1146,7 @@ compare_symbols (const void *ap, const void *bp)
   const char *bn;
   size_t anl;
   size_t bnl;
-  bool as, af, bs, bf;
+  bool af, bf;
   flagword aflags;
   flagword bflags;
 
@@ -1113,17 +1155,6 @@ compare_symbols (const void *ap, const void *bp)
   else if (bfd_asymbol_value (a) < bfd_asymbol_value (b))
     return -1;
 
-  /* Prefer symbols from the section currently being disassembled.
-     Don't sort symbols from other sections by section, since there
-     isn't much reason to prefer one section over another otherwise.
-     See sym_ok comment for why we compare by section name.  */
-  as = strcmp (compare_section->name, a->section->name) == 0;
-  bs = strcmp (compare_section->name, b->section->name) == 0;
-  if (as && !bs)
-    return -1;
-  if (!as && bs)
-    return 1;
-
   an = bfd_asymbol_name (a);
   bn = bfd_asymbol_name (b);
   anl = strlen (an);
@@ -1330,6 +1361,224 @@ objdump_print_symname (bfd *abfd, struct disassemble_info *inf,
     free (alloc);
 }
 
+static int
+compare_section_names (const void *ap, const void *bp)
+{
+  return strcmp (* (const char **) ap, * (const char **) bp);
+}
+
+static int
+compare_section_syms (const void *key, const void *elt)
+{
+  return strcmp ((const char *) key,
+		 ((const struct section_syms *) elt)->name);
+}
+
+/* Return the group of symbols in sections called NAME, or NULL if
+   there are none.  */
+
+static struct section_syms *
+find_section_syms (const char *name)
+{
+  if (section_syms_count == 0)
+    return NULL;
+  return (struct section_syms *) bsearch (name, section_syms,
+					  section_syms_count,
+					  sizeof (*section_syms),
+					  compare_section_syms);
+}
+
+/* Sort `sorted_syms' and group the symbols by section name.  This is
+   done once for each file; sort_symbols_for_section then adjusts the
+   order for each section that is disassembled.  */
+
+static void
+build_section_syms (void)
+{
+  const char **names;
+  long *places;
+  long count;
+  long largest;
+  long i;
+
+  section_syms = NULL;
+  section_syms_count = 0;
+  section_sym_places = NULL;
+  sorted_syms_base = NULL;
+  sorted_syms_scratch = NULL;
+  sorted_syms_changed = false;
+  sorted_section_syms.name = NULL;
+  sorted_section_syms.count = 0;
+  sorted_section_syms.places = NULL;
+  if (sorted_symcount < 1)
+    return;
+
+  qsort (sorted_syms, sorted_symcount, sizeof (asymbol *), compare_symbols);
+
+  names = (const char **) xmalloc (sorted_symcount * sizeof (*names));
+  for (i = 0; i < sorted_symcount; i++)
+    names[i] = bfd_section_name (sorted_syms[i]->section);
+  qsort (names, sorted_symcount, sizeof (*names), compare_section_names);
+
+  count = 1;
+  for (i = 1; i < sorted_symcount; i++)
+    if (strcmp (names[i], names[count - 1]) != 0)
+      names[count++] = names[i];
+
+  section_syms = (struct section_syms *) xmalloc (count
+						  * sizeof (*section_syms));
+  for (i = 0; i < count; i++)
+    {
+      section_syms[i].name = names[i];
+      section_syms[i].count = 0;
+    }
+  section_syms_count = count;
+  free (names);
+
+  for (i = 0; i < sorted_symcount; i++)
+    find_section_syms (bfd_section_name (sorted_syms[i]->section))->count++;
+
+  section_sym_places = (long *) xmalloc (sorted_symcount * sizeof (long));
+  places = section_sym_places;
+  largest = 0;
+  for (i = 0; i < count; i++)
+    {
+      section_syms[i].places = places;
+      places += section_syms[i].count;
+      if (largest < section_syms[i].count)
+	largest = section_syms[i].count;
+      section_syms[i].count = 0;
+    }
+
+  for (i = 0; i < sorted_symcount; i++)
+    {
+      struct section_syms *group;
+
+      group = find_section_syms (bfd_section_name (sorted_syms[i]->section));
+      group->places[group->count++] = i;
+    }
+
+  sorted_syms_base = (asymbol **) xmalloc (sorted_symcount
+					   * sizeof (asymbol *));
+  sorted_syms_scratch = (asymbol **) xmalloc (sorted_symcount
+					      * sizeof (asymbol *));
+  memcpy (sorted_syms_base, sorted_syms, sorted_symcount * sizeof (asymbol *));
+  sorted_section_syms.places = (long *) xmalloc (largest * sizeof (long));
+}
+
+static void
+free_section_syms (void)
+{
+  free (sorted_section_syms.places);
+  free (sorted_syms_scratch);
+  free (sorted_syms_base);
+  free (section_sym_places);
+  free (section_syms);
+  sorted_section_syms.places = NULL;
+  sorted_syms_scratch = NULL;
+  sorted_syms_base = NULL;
+  section_sym_places = NULL;
+  section_syms = NULL;
+  section_syms_count = 0;
+}
+
+/* Put `sorted_syms' into the order for disassembling SECTION, where
+   symbols in the section come first among those with the same value,
+   and set up `sorted_section_syms' to match.  Rather than sorting all
+   the symbols again, start from the order build_section_syms left them
+   in and move the symbols in SECTION to the front of their runs of
+   equal values.  See sym_ok comment for why we compare by section
+   name.  */
+
+static void
+sort_symbols_for_section (const asection *section)
+{
+  const struct section_syms *group;
+  asymbol **others;
+  long i, j, k;
+
+  if (sorted_syms_changed)
+    {
+      memcpy (sorted_syms, sorted_syms_base,
+	      sorted_symcount * sizeof (asymbol *));
+      sorted_syms_changed = false;
+    }
+
+  sorted_section_syms.name = bfd_section_name (section);
+  sorted_section_syms.count = 0;
+  group = find_section_syms (sorted_section_syms.name);
+  if (group == NULL)
+    return;
+
+  others = sorted_syms_scratch;
+  for (i = 0; i < group->count; i = j)
+    {
+      long first = group->places[i];
+      bfd_vma value = bfd_asymbol_value (sorted_syms[first]);
+      long start = first;
+      long lo = 0;
+
+      /* Find where the run of symbols with this value starts, and
+	 the group's symbols in it.  */
+      while (lo < start)
+	{
+	  long mid = lo + (start - lo) / 2;
+
+	  if (bfd_asymbol_value (sorted_syms[mid]) < value)
+	    lo = mid + 1;
+	  else
+	    start = mid;
+	}
+      for (j = i + 1;
+	   (j < group->count
+	    && bfd_asymbol_value (sorted_syms[group->places[j]]) == value);
+	   j++)
+	;
+
+      if (group->places[j - 1] - start != j - i - 1)
+	{
+	  long end = group->places[j - 1] + 1;
+	  long nothers = 0;
+	  long place;
+
+	  k = i;
+	  for (place = start; place < end; place++)
+	    if (k < j && group->places[k] == place)
+	      sorted_syms[start + k++ - i] = sorted_syms[place];
+	    else
+	      others[nothers++] = sorted_syms[place];
+	  memcpy (sorted_syms + start + j - i, others,
+		  nothers * sizeof (asymbol *));
+	  sorted_syms_changed = true;
+	}
+
+      for (k = i; k < j; k++)
+	sorted_section_syms.places[k] = start + k - i;
+    }
+  sorted_section_syms.count = group->count;
+}
+
+/* Return the index in GROUP->places of the first symbol at or after
+   PLACE in `sorted_syms'.  */
+
+static long
+section_syms_lower_bound (const struct section_syms *group, long place)
+{
+  long lo = 0;
+  long hi = group->count;
+
+  while (lo < hi)
+    {
+      long mid = lo + (hi - lo) / 2;
+
+      if (group->places[mid] < place)
+	lo = mid + 1;
+      else
+	hi = mid;
+    }
+  return lo;
+}
+
 static inline bool
 sym_ok (bool want_section,
 	bfd *abfd ATTRIBUTE_UNUSED,
@@ -1381,6 +1630,9 @@ find_symbol_for_address (bfd_vma vma,
   long min = 0;
   long max_count = sorted_symcount;
   long thisplace;
+  long lo, hi, i;
+  bfd_vma value;
+  struct section_syms *group;
   struct objdump_disasm_info *aux;
   bfd *abfd;
   asection *sec;
@@ -1418,32 +1670,53 @@ find_symbol_for_address (bfd_vma vma,
 
   /* The symbol we want is now in min, the low end of the range we
      were searching.  If there are several symbols with the same
-     value, we want the first one.  */
-  thisplace = min;
-  while (thisplace > 0
-	 && (bfd_asymbol_value (sorted_syms[thisplace])
-	     == bfd_asymbol_value (sorted_syms[thisplace - 1])))
-    --thisplace;
+     value, we want the first one.  There can be a great many of them
+     in a relocatable file where each section starts at zero, so look
+     for both ends of the run of equal values with binary searches.  */
+  value = bfd_asymbol_value (sorted_syms[min]);
+  lo = 0;
+  hi = min;
+  while (lo < hi)
+    {
+      long mid = lo + (hi - lo) / 2;
+
+      if (bfd_asymbol_value (sorted_syms[mid]) < value)
+	lo = mid + 1;
+      else
+	hi = mid;
+    }
+  thisplace = lo;
+
+  lo = min + 1;
+  hi = max_count;
+  while (lo < hi)
+    {
+      long mid = lo + (hi - lo) / 2;
+
+      if (bfd_asymbol_value (sorted_syms[mid]) > value)
+	hi = mid;
+      else
+	lo = mid + 1;
+    }
+  min = lo;
 
   /* Prefer a symbol in the current section if we have multple symbols
      with the same value, as can occur with overlays or zero size
-     sections.  */
-  min = thisplace;
-  while (min < max_count
-	 && (bfd_asymbol_value (sorted_syms[min])
-	     == bfd_asymbol_value (sorted_syms[thisplace])))
-    {
-      if (sym_ok (true, abfd, min, sec, inf))
-	{
-	  thisplace = min;
+     sections.  SEC is the section being disassembled, so only the
+     symbols in `sorted_section_syms' can be in it.  */
+  group = &sorted_section_syms;
+  for (i = section_syms_lower_bound (group, thisplace);
+       i < group->count && group->places[i] < min;
+       i++)
+    if (sym_ok (true, abfd, group->places[i], sec, inf))
+      {
+	thisplace = group->places[i];
 
-	  if (place != NULL)
-	    *place = thisplace;
+	if (place != NULL)
+	  *place = thisplace;
 
-	  return sorted_syms[thisplace];
-	}
-      ++min;
-    }
+	return sorted_syms[thisplace];
+      }
 
   /* If the file is relocatable, and the symbol could be from this
      section, prefer a symbol from this section over symbols from
@@ -1463,45 +1736,69 @@ find_symbol_for_address (bfd_vma vma,
 
   if (! sym_ok (want_section, abfd, thisplace, sec, inf))
     {
-      long i;
       long newplace = sorted_symcount;
 
-      for (i = min - 1; i >= 0; i--)
+      if (want_section)
 	{
-	  if (sym_ok (want_section, abfd, i, sec, inf))
+	  /* None of the symbols with the same value were suitable, so
+	     look through those in the section for the closest one
+	     before them, or failing that after them.  */
+	  long first = section_syms_lower_bound (group, min);
+
+	  for (i = first - 1; i >= 0; i--)
 	    {
-	      if (newplace == sorted_symcount)
-		newplace = i;
+	      long p = group->places[i];
 
-	      if (bfd_asymbol_value (sorted_syms[i])
-		  != bfd_asymbol_value (sorted_syms[newplace]))
+	      if (newplace != sorted_symcount
+		  && (bfd_asymbol_value (sorted_syms[p])
+		      != bfd_asymbol_value (sorted_syms[newplace])))
 		break;
 
 	      /* Remember this symbol and keep searching until we reach
 		 an earlier address.  */
-	      newplace = i;
+	      if (sym_ok (true, abfd, p, sec, inf))
+		newplace = p;
 	    }
-	}
 
-      if (newplace != sorted_symcount)
-	thisplace = newplace;
+	  if (newplace == sorted_symcount)
+	    for (i = first; i < group->count; i++)
+	      if (sym_ok (true, abfd, group->places[i], sec, inf))
+		{
+		  newplace = group->places[i];
+		  break;
+		}
+	}
       else
 	{
+	  for (i = min - 1; i >= 0; i--)
+	    {
+	      if (newplace != sorted_symcount
+		  && (bfd_asymbol_value (sorted_syms[i])
+		      != bfd_asymbol_value (sorted_syms[newplace])))
+		break;
+
+	      /* Remember this symbol and keep searching until we reach
+		 an earlier address.  */
+	      if (sym_ok (false, abfd, i, sec, inf))
+		newplace = i;
+	    }
+
 	  /* We didn't find a good symbol with a smaller value.
 	     Look for one with a larger value.  */
-	  for (i = thisplace + 1; i < sorted_symcount; i++)
-	    {
-	      if (sym_ok (want_section, abfd, i, sec, inf))
+	  if (newplace == sorted_symcount)
+	    for (i = thisplace + 1; i < sorted_symcount; i++)
+	      if (sym_ok (false, abfd, i, sec, inf))
 		{
-		  thisplace = i;
+		  newplace = i;
 		  break;
 		}
-	    }
 	}
 
-      if (! sym_ok (want_section, abfd, thisplace, sec, inf))
+      if (newplace == sorted_symcount)
 	/* There is no suitable symbol.  */
 	return NULL;
+
+      thisplace = newplace;
     }
 
   /* If we have not found an exact match for the specified address
@@ -3667,25 +3964,55 @@ disassemble_bytes (struct disassemble_info *inf,
   free (color_buffer);
 }
 
-static void
-disassemble_section (bfd *abfd, asection *section, void *inf)
+/* The least number of bytes of a section to give to each --threads
+   job.  */
+#define MIN_PARALLEL_DISASSEMBLY 0x10000
+
+/* The state of disassemble_section when it starts walking the blocks
+   of code between symbols in a section.  */
+
+struct disassemble_blocks_info
 {
-  const struct elf_backend_data *bed;
-  bfd_vma sign_adjust = 0;
-  struct disassemble_info *pinfo = (struct disassemble_info *) inf;
-  struct objdump_disasm_info *paux;
-  unsigned int opb = pinfo->octets_per_byte;
-  bfd_byte *data = NULL;
-  bfd_size_type datasize = 0;
-  arelent **rel_pp = NULL;
-  arelent **rel_ppstart = NULL;
-  arelent **rel_ppend;
+  bfd *abfd;
+  asection *section;
+  struct disassemble_info *pinfo;
+  bfd_byte *data;
+  bfd_vma addr_offset;
   bfd_vma stop_offset;
-  asymbol *sym = NULL;
-  long place = 0;
-  long rel_count;
+  asymbol *sym;
+  long place;
   bfd_vma rel_offset;
-  unsigned long addr_offset;
+  arelent **rel_pp;
+  arelent **rel_ppend;
+  bfd_vma sign_adjust;
+
+  /* For --threads, the offsets at which the section is split between
+     jobs.  */
+  bfd_vma *splits;
+};
+
+/* Disassemble the blocks of code described by BLOCKS, printing those
+   that start at an offset in [PRINT_START, PRINT_END).  The blocks
+   outside that range are still walked, to find the symbols.  */
+
+static void
+disassemble_blocks (struct disassemble_blocks_info *blocks,
+		    bfd_vma print_start, bfd_vma print_end)
+{
+  bfd *abfd = blocks->abfd;
+  asection *section = blocks->section;
+  struct disassemble_info *pinfo = blocks->pinfo;
+  struct objdump_disasm_info *paux
+    = (struct objdump_disasm_info *) pinfo->application_data;
+  bfd_byte *data = blocks->data;
+  bfd_vma addr_offset = blocks->addr_offset;
+  bfd_vma stop_offset = blocks->stop_offset;
+  asymbol *sym = blocks->sym;
+  long place = blocks->place;
+  bfd_vma rel_offset = blocks->rel_offset;
+  arelent **rel_pp = blocks->rel_pp;
+  arelent **rel_ppend = blocks->rel_ppend;
+  bfd_vma sign_adjust = blocks->sign_adjust;
   bool do_print;
   enum loop_control
   {
@@ -3694,131 +4021,6 @@ disassemble_section (bfd *abfd, asection *section, void *inf)
    next_sym
   } loop_until;
 
-  if (only_list == NULL)
-    {
-      /* Sections that do not contain machine
-	 code are not normally disassembled.  */
-      if ((section->flags & SEC_HAS_CONTENTS) == 0)
-	return;
-
-      if (! disassemble_all
-	  && (section->flags & SEC_CODE) == 0)
-	return;
-    }
-  else if (!process_section_p (section))
-    return;
-
-  datasize = bfd_section_size (section);
-  if (datasize == 0)
-    return;
-
-  if (start_address == (bfd_vma) -1
-      || start_address < section->vma)
-    addr_offset = 0;
-  else
-    addr_offset = start_address - section->vma;
-
-  if (stop_address == (bfd_vma) -1)
-    stop_offset = datasize / opb;
-  else
-    {
-      if (stop_address < section->vma)
-	stop_offset = 0;
-      else
-	stop_offset = stop_address - section->vma;
-      if (stop_offset > datasize / opb)
-	stop_offset = datasize / opb;
-    }
-
-  if (addr_offset >= stop_offset)
-    return;
-
-  /* Decide which set of relocs to use.  Load them if necessary.  */
-  paux = (struct objdump_disasm_info *) pinfo->application_data;
-  if (pinfo->dynrelbuf && dump_dynamic_reloc_info)
-    {
-      rel_pp = pinfo->dynrelbuf;
-      rel_count = pinfo->dynrelcount;
-      /* Dynamic reloc addresses are absolute, non-dynamic are section
-	 relative.  REL_OFFSET specifies the reloc address corresponding
-	 to the start of this section.  */
-      rel_offset = section->vma;
-    }
-  else
-    {
-      rel_count = 0;
-      rel_pp = NULL;
-      rel_offset = 0;
-
-      if ((section->flags & SEC_RELOC) != 0
-	  && (dump_reloc_info || pinfo->disassembler_needs_relocs))
-	{
-	  long relsize;
-
-	  relsize = bfd_get_reloc_upper_bound (abfd, section);
-	  if (relsize < 0)
-	    my_bfd_nonfatal (bfd_get_filename (abfd));
-
-	  if (relsize > 0)
-	    {
-	      rel_pp = (arelent **) xmalloc (relsize);
-	      rel_count = bfd_canonicalize_reloc (abfd, section, rel_pp, syms);
-	      if (rel_count < 0)
-		{
-		  my_bfd_nonfatal (bfd_get_filename (abfd));
-		  free (rel_pp);
-		  rel_pp = NULL;
-		  rel_count = 0;
-		}
-	      else if (rel_count > 1)
-		/* Sort the relocs by address.  */
-		qsort (rel_pp, rel_count, sizeof (arelent *), compare_relocs);
-	      rel_ppstart = rel_pp;
-	    }
-	}
-    }
-  rel_ppend = PTR_ADD (rel_pp, rel_count);
-
-  if (!bfd_malloc_and_get_section (abfd, section, &data))
-    {
-      non_fatal (_("Reading section %s failed because: %s"),
-		 section->name, bfd_errmsg (bfd_get_error ()));
-      return;
-    }
-
-  pinfo->buffer = data;
-  pinfo->buffer_vma = section->vma;
-  pinfo->buffer_length = datasize;
-  pinfo->section = section;
-
-  /* Sort the symbols into value and section order.  */
-  compare_section = section;
-  if (sorted_symcount > 1)
-    qsort (sorted_syms, sorted_symcount, sizeof (asymbol *), compare_symbols);
-
-  /* Skip over the relocs belonging to addresses below the
-     start address.  */
-  while (rel_pp < rel_ppend
-	 && (*rel_pp)->address < rel_offset + addr_offset)
-    ++rel_pp;
-
-  printf (_("\nDisassembly of section %s:\n"), sanitize_string (section->name));
-
-  /* Find the nearest symbol forwards from our current position.  */
-  paux->require_sec = true;
-  sym = (asymbol *) find_symbol_for_address (section->vma + addr_offset,
-					     (struct disassemble_info *) inf,
-					     &place);
-  paux->require_sec = false;
-
-  /* PR 9774: If the target used signed addresses then we must make
-     sure that we sign extend the value that we calculate for 'addr'
-     in the loop below.  */
-  if (bfd_get_flavour (abfd) == bfd_target_elf_flavour
-      && (bed = get_elf_backend_data (abfd)) != NULL
-      && bed->sign_extend_vma)
-    sign_adjust = (bfd_vma) 1 << (bed->s->arch_size - 1);
-
   /* Disassemble a block of instructions up to the address associated with
      the symbol we have just found.  Then print the symbol and find the
      next symbol on.  Repeat until we have disassembled the entire section
@@ -3832,7 +4034,9 @@ disassemble_section (bfd *abfd, asection *section, void *inf)
       asymbol *nextsym;
       bfd_vma nextstop_offset;
       bool insns;
+      bool in_range;
 
+      in_range = addr_offset >= print_start && addr_offset < print_end;
       addr = section->vma + addr_offset;
       addr = ((addr & ((sign_adjust << 1) - 1)) ^ sign_adjust) - sign_adjust;
 
@@ -3940,7 +4144,7 @@ disassemble_section (bfd *abfd, asection *section, void *inf)
 	    }
 	}
 
-      if (! prefix_addresses && do_print)
+      if (! prefix_addresses && do_print && in_range)
 	{
 	  pinfo->fprintf_func (pinfo->stream, "\n");
 	  objdump_print_addr_with_sym (abfd, section, sym, addr,
@@ -4019,7 +4223,7 @@ disassemble_section (bfd *abfd, asection *section, void *inf)
       else
 	insns = false;
 
-      if (do_print)
+      if (do_print && in_range)
 	{
 	  /* Resolve symbol name.  */
 	  if (visualize_jumps && abfd && sym && sym->name)
@@ -4061,6 +4265,215 @@ disassemble_section (bfd *abfd, asection *section, void *inf)
       addr_offset = nextstop_offset;
       sym = nextsym;
     }
+}
+
+/* Disassemble the part of a section that is given to job I by
+   run_parallel_output.  */
+
+static int
+disassemble_blocks_job (void *data, unsigned int i)
+{
+  struct disassemble_blocks_info *blocks
+    = (struct disassemble_blocks_info *) data;
+
+  disassemble_blocks (blocks, blocks->splits[i], blocks->splits[i + 1]);
+  return exit_status;
+}
+
+static void
+disassemble_section (bfd *abfd, asection *section, void *inf)
+{
+  const struct elf_backend_data *bed;
+  bfd_vma sign_adjust = 0;
+  struct disassemble_info *pinfo = (struct disassemble_info *) inf;
+  struct objdump_disasm_info *paux;
+  unsigned int opb = pinfo->octets_per_byte;
+  bfd_byte *data = NULL;
+  bfd_size_type datasize = 0;
+  arelent **rel_pp = NULL;
+  arelent **rel_ppstart = NULL;
+  arelent **rel_ppend;
+  bfd_vma stop_offset;
+  asymbol *sym = NULL;
+  long place = 0;
+  long rel_count;
+  bfd_vma rel_offset;
+  unsigned long addr_offset;
+  struct disassemble_blocks_info blocks;
+  bool done = false;
+
+  if (only_list == NULL)
+    {
+      /* Sections that do not contain machine
+	 code are not normally disassembled.  */
+      if ((section->flags & SEC_HAS_CONTENTS) == 0)
+	return;
+
+      if (! disassemble_all
+	  && (section->flags & SEC_CODE) == 0)
+	return;
+    }
+  else if (!process_section_p (section))
+    return;
+
+  datasize = bfd_section_size (section);
+  if (datasize == 0)
+    return;
+
+  if (start_address == (bfd_vma) -1
+      || start_address < section->vma)
+    addr_offset = 0;
+  else
+    addr_offset = start_address - section->vma;
+
+  if (stop_address == (bfd_vma) -1)
+    stop_offset = datasize / opb;
+  else
+    {
+      if (stop_address < section->vma)
+	stop_offset = 0;
+      else
+	stop_offset = stop_address - section->vma;
+      if (stop_offset > datasize / opb)
+	stop_offset = datasize / opb;
+    }
+
+  if (addr_offset >= stop_offset)
+    return;
+
+  /* Decide which set of relocs to use.  Load them if necessary.  */
+  paux = (struct objdump_disasm_info *) pinfo->application_data;
+  if (pinfo->dynrelbuf && dump_dynamic_reloc_info)
+    {
+      rel_pp = pinfo->dynrelbuf;
+      rel_count = pinfo->dynrelcount;
+      /* Dynamic reloc addresses are absolute, non-dynamic are section
+	 relative.  REL_OFFSET specifies the reloc address corresponding
+	 to the start of this section.  */
+      rel_offset = section->vma;
+    }
+  else
+    {
+      rel_count = 0;
+      rel_pp = NULL;
+      rel_offset = 0;
+
+      if ((section->flags & SEC_RELOC) != 0
+	  && (dump_reloc_info || pinfo->disassembler_needs_relocs))
+	{
+	  long relsize;
+
+	  relsize = bfd_get_reloc_upper_bound (abfd, section);
+	  if (relsize < 0)
+	    my_bfd_nonfatal (bfd_get_filename (abfd));
+
+	  if (relsize > 0)
+	    {
+	      rel_pp = (arelent **) xmalloc (relsize);
+	      rel_count = bfd_canonicalize_reloc (abfd, section, rel_pp, syms);
+	      if (rel_count < 0)
+		{
+		  my_bfd_nonfatal (bfd_get_filename (abfd));
+		  free (rel_pp);
+		  rel_pp = NULL;
+		  rel_count = 0;
+		}
+	      else if (rel_count > 1)
+		/* Sort the relocs by address.  */
+		qsort (rel_pp, rel_count, sizeof (arelent *), compare_relocs);
+	      rel_ppstart = rel_pp;
+	    }
+	}
+    }
+  rel_ppend = PTR_ADD (rel_pp, rel_count);
+
+  if (!bfd_malloc_and_get_section (abfd, section, &data))
+    {
+      non_fatal (_("Reading section %s failed because: %s"),
+		 section->name, bfd_errmsg (bfd_get_error ()));
+      return;
+    }
+
+  pinfo->buffer = data;
+  pinfo->buffer_vma = section->vma;
+  pinfo->buffer_length = datasize;
+  pinfo->section = section;
+
+  /* Sort the symbols into value and section order.  */
+  sort_symbols_for_section (section);
+
+  /* Skip over the relocs belonging to addresses below the
+     start address.  */
+  while (rel_pp < rel_ppend
+	 && (*rel_pp)->address < rel_offset + addr_offset)
+    ++rel_pp;
+
+  printf (_("\nDisassembly of section %s:\n"), sanitize_string (section->name));
+
+  /* Find the nearest symbol forwards from our current position.  */
+  paux->require_sec = true;
+  sym = (asymbol *) find_symbol_for_address (section->vma + addr_offset,
+					     (struct disassemble_info *) inf,
+					     &place);
+  paux->require_sec = false;
+
+  /* PR 9774: If the target used signed addresses then we must make
+     sure that we sign extend the value that we calculate for 'addr'
+     in the loop below.  */
+  if (bfd_get_flavour (abfd) == bfd_target_elf_flavour
+      && (bed = get_elf_backend_data (abfd)) != NULL
+      && bed->sign_extend_vma)
+    sign_adjust = (bfd_vma) 1 << (bed->s->arch_size - 1);
+
+  blocks.abfd = abfd;
+  blocks.section = section;
+  blocks.pinfo = pinfo;
+  blocks.data = data;
+  blocks.addr_offset = addr_offset;
+  blocks.stop_offset = stop_offset;
+  blocks.sym = sym;
+  blocks.place = place;
+  blocks.rel_offset = rel_offset;
+  blocks.rel_pp = rel_pp;
+  blocks.rel_ppend = rel_ppend;
+  blocks.sign_adjust = sign_adjust;
+  blocks.splits = NULL;
+
+  /* With --threads, split a large section between several jobs that
+     each disassemble the blocks of code starting in their part of it.
+     This is only done when the output of a block does not depend on
+     the blocks before it, which it does if relocs or line numbers are
+     printed, or with --disassemble=SYMBOL or --show-all-symbols.  */
+  if (thread_count > 1
+      && stop_offset - addr_offset >= 2 * MIN_PARALLEL_DISASSEMBLY
+      && rel_pp == rel_ppend
+      && paux->symbol == NULL
+      && !with_line_numbers
+      && !with_source_code
+      && !show_all_symbols)
+    {
+      bfd_vma size = stop_offset - addr_offset;
+      unsigned int njobs = thread_count * 4;
+      unsigned int i;
+      int status;
+
+      if (njobs > size / MIN_PARALLEL_DISASSEMBLY)
+	njobs = size / MIN_PARALLEL_DISASSEMBLY;
+      blocks.splits = (bfd_vma *) xmalloc ((njobs + 1) * sizeof (bfd_vma));
+      blocks.splits[0] = 0;
+      for (i = 1; i < njobs; i++)
+	blocks.splits[i] = addr_offset + size / njobs * i;
+      blocks.splits[njobs] = stop_offset;
+
+      done = run_parallel_output (njobs, thread_count,
+				  disassemble_blocks_job, &blocks, &status);
+      if (done && status != 0)
+	exit_status = 1;
+      free (blocks.splits);
+    }
+
+  if (!done)
+    disassemble_blocks (&blocks, 0, (bfd_vma) -1);
 
   free (data);
 
@@ -4193,6 +4606,8 @@ disassemble_data (bfd *abfd)
 	       sizeof (arelent *), compare_relocs);
     }
 
+  build_section_syms ();
+
   disasm_info.symtab = sorted_syms;
   disasm_info.symtab_size = sorted_symcount;
 
@@ -4200,6 +4615,7 @@ disassemble_data (bfd *abfd)
 
   free (disasm_info.dynrelbuf);
   disasm_info.dynrelbuf = NULL;
+  free_section_syms ();
   free (sorted_syms);
   disassemble_free_target (&disasm_info);
 }
@@ -5984,6 +6400,11 @@ main (int argc, char **argv)
 	case OPTION_INLINES:
 	  unwind_inlines = true;
 	  break;
+	case OPTION_THREADS:
+	  thread_count = parse_thread_count (optarg);
+	  if (thread_count == 0)
+	    fatal (_("%s: invalid thread count: %s"), "--threads", optarg);
+	  break;
 	case OPTION_VISUALIZE_JUMPS:
 	  visualize_jumps = true;
 	  color_output = false;
@@ -0,0 +1,190 @@
+/* parallel.c -- run jobs of the binutils in parallel.
+   Copyright (C) 2023 Free Software Foundation, Inc.
+
+   This file is part of GNU Binutils.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street - Fifth Floor, Boston, MA
+   02110-1301, USA.  */
+
+#include "sysdep.h"
+#include "libiberty.h"
+#include "bfd.h"
+#include "parallel.h"
+#ifdef HAVE_SYS_WAIT_H
+#include <sys/wait.h>
+#endif
+
+/* Parse the argument ARG of a --threads option.  A missing argument or
+   zero means one thread per online processor.  Return zero if ARG is
+   not a valid thread count.  */
+
+unsigned int
+parse_thread_count (const char *arg)
+{
+  unsigned long count = 0;
+
+  if (arg != NULL)
+    {
+      char *end;
+
+      count = strtoul (arg, &end, 0);
+      if (*end != '\0' || end == arg || count > 1024)
+	return 0;
+    }
+
+  if (count == 0)
+    {
+#if defined (HAVE_SYSCONF) && defined (_SC_NPROCESSORS_ONLN)
+      long ncpus = sysconf (_SC_NPROCESSORS_ONLN);
+
+      count = ncpus > 0 ? ncpus : 1;
+#else
+      count = 1;
+#endif
+    }
+  return count;
+}
+
+/* Call JOB (DATA, I) for each I from zero to COUNT - 1, each in its
+   own child process with at most WORKERS of them running at once, and
+   copy what each job writes to standard output to our standard output
+   in order of I, so that the output is the same as that of calling
+   the jobs one after the other.  Since every job runs in a copy of
+   this process, it can freely use global state, but nothing it
+   changes other than its output is seen by the caller.
+
+   JOB returns an exit status, and *STATUS is set to one if any job
+   failed and zero otherwise.  A job that returns a negative value
+   stops the ones after it, as a loop calling the jobs would: their
+   output is thrown away.  Return FALSE, without having run any of the
+   jobs, if this is not possible on this host; the caller should then
+   run them itself.  */
+
+bool
+run_parallel_output (unsigned int count, unsigned int workers,
+		     int (*job) (void *, unsigned int), void *data,
+		     int *status)
+{
+#if defined (HAVE_FORK) && defined (HAVE_SYS_WAIT_H)
+  FILE **outputs;
+  pid_t *pids;
+  unsigned int started, done;
+  bool stopped = false;
+  bool ret = true;
+
+  if (workers < 2 || count < 2)
+    return false;
+
+  outputs = (FILE **) xmalloc (count * sizeof (*outputs));
+  pids = (pid_t *) xmalloc (count * sizeof (*pids));
+  *status = 0;
+
+  started = done = 0;
+  while (done < count)
+    {
+      /* Keep WORKERS jobs running, and wait for the jobs in order,
+	 copying out the output of each as soon as it is complete.  */
+      while (!stopped && started < count && started - done < workers)
+	{
+	  pid_t pid = -1;
+
+	  outputs[started] = tmpfile ();
+	  if (outputs[started] != NULL)
+	    {
+	      /* Buffered output would otherwise be written by the child
+		 too.  */
+	      fflush (stdout);
+	      fflush (stderr);
+	      pid = fork ();
+	      if (pid == 0)
+		{
+		  int exit_code;
+
+		  if (dup2 (fileno (outputs[started]), fileno (stdout)) < 0)
+		    _exit (1);
+		  exit_code = job (data, started);
+		  fflush (stdout);
+		  fflush (stderr);
+		  _exit (exit_code < 0 ? 2 : exit_code != 0);
+		}
+	      if (pid < 0)
+		fclose (outputs[started]);
+	    }
+	  if (pid < 0)
+	    {
+	      if (started == 0)
+		{
+		  /* Nothing has been run yet, so let the caller do it.  */
+		  ret = false;
+		  goto out;
+		}
+	      /* Run the job here instead, once the earlier ones are
+		 complete.  */
+	      break;
+	    }
+	  pids[started++] = pid;
+	}
+
+      if (done < started)
+	{
+	  int wstatus;
+	  int exit_code = 1;
+	  char buf[8192];
+	  size_t len;
+
+	  /* A job that could not be waited for has failed.  */
+	  if (waitpid (pids[done], &wstatus, 0) == pids[done]
+	      && WIFEXITED (wstatus))
+	    exit_code = WEXITSTATUS (wstatus);
+	  if (exit_code != 0)
+	    *status = 1;
+
+	  if (!stopped)
+	    {
+	      rewind (outputs[done]);
+	      while ((len = fread (buf, 1, sizeof (buf), outputs[done])) != 0)
+		fwrite (buf, 1, len, stdout);
+	      if (exit_code == 2)
+		stopped = true;
+	    }
+	  fclose (outputs[done]);
+	  done++;
+	}
+      else if (stopped)
+	break;
+      else
+	{
+	  /* A child could not be started.  */
+	  int exit_code;
+
+	  fflush (stdout);
+	  exit_code = job (data, done);
+	  if (exit_code != 0)
+	    *status = 1;
+	  if (exit_code < 0)
+	    stopped = true;
+	  fflush (stdout);
+	  started = ++done;
+	}
+    }
+
+ out:
+  free (outputs);
+  free (pids);
+  return ret;
+#else
+  return false;
+#endif
+}
@@ -0,0 +1,33 @@
+/* parallel.h -- run jobs of the binutils in parallel.
+   Copyright (C) 2023 Free Software Foundation, Inc.
+
+   This file is part of GNU Binutils.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street - Fifth Floor, Boston, MA
+   02110-1301, USA.  */
+
+#ifndef _PARALLEL_H
+#define _PARALLEL_H
+
+/* Parse the argument of a --threads option.  */
+extern unsigned int parse_thread_count (const char *);
+
+/* Run jobs in parallel child processes, copying out their output in
+   order.  */
+extern bool run_parallel_output (unsigned int, unsigned int,
+				 int (*) (void *, unsigned int), void *,
+				 int *);
+
+#endif /* _PARALLEL_H */
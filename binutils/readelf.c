@@ -49,6 +49,10 @@
 #endif
 #include <wchar.h>
 
+#ifdef HAVE_MMAP
+#include <sys/mman.h>
+#endif
+
 #if defined HAVE_MSGPACK
 #include <msgpack.h>
 #endif
@@ -60,6 +64,7 @@
 #include "bfd.h"
 #include "bucomm.h"
 #include "elfcomm.h"
+#include "parallel.h"
 #include "demanguse.h"
 #include "dwarf.h"
 #include "ctf-api.h"
@@ -274,6 +279,8 @@ typedef struct filedata
   Elf_Internal_Ehdr    file_header;
   uint64_t             archive_file_offset;
   uint64_t             archive_file_size;
+  /* A read-only mapping of the whole file, or NULL.  */
+  unsigned char *      map;
   /* Everything below this point is cleared out by free_filedata.  */
   Elf_Internal_Shdr *  section_headers;
   Elf_Internal_Phdr *  program_headers;
@@ -462,28 +469,20 @@ get_dynamic_name (const Filedata *filedata, size_t offset)
 #define GNU_HASH_SECTION_NAME(filedata)		\
   filedata->dynamic_info_DT_MIPS_XHASH ? ".MIPS.xhash" : ".gnu.hash"
 
-/* Retrieve NMEMB structures, each SIZE bytes long from FILEDATA starting at
-   OFFSET + the offset of the current archive member, if we are examining an
-   archive.  Put the retrieved data into VAR, if it is not NULL.  Otherwise
-   allocate a buffer using malloc and fill that.  In either case return the
-   pointer to the start of the retrieved data or NULL if something went wrong.
-   If something does go wrong and REASON is not NULL then emit an error
-   message using REASON as part of the context.  */
+/* Check that NMEMB structures, each SIZE bytes long, can be read from
+   FILEDATA starting at OFFSET + the offset of the current archive member.
+   If they cannot and REASON is not NULL then emit an error message using
+   REASON as part of the context.  */
 
-static void *
-get_data (void *var,
-	  Filedata *filedata,
-	  uint64_t offset,
-	  uint64_t size,
-	  uint64_t nmemb,
-	  const char *reason)
+static bool
+check_data_range (Filedata *filedata,
+		  uint64_t offset,
+		  uint64_t size,
+		  uint64_t nmemb,
+		  const char *reason)
 {
-  void * mvar;
   uint64_t amt = size * nmemb;
 
-  if (size == 0 || nmemb == 0)
-    return NULL;
-
   /* If size_t is smaller than uint64_t, eg because you are building
      on a 32-bit host, then make sure that when the sizes are cast to
      size_t no information is lost.  */
@@ -497,7 +496,7 @@ get_data (void *var,
 	error (_("Size overflow prevents reading %" PRIu64
 		 " elements of size %" PRIu64 " for %s\n"),
 	       nmemb, size, reason);
-      return NULL;
+      return false;
     }
 
   /* Be kind to memory checkers (eg valgrind, address sanitizer) by not
@@ -509,11 +508,40 @@ get_data (void *var,
       if (reason)
 	error (_("Reading %" PRIu64 " bytes extends past end of file for %s\n"),
 	       amt, reason);
-      return NULL;
+      return false;
     }
 
-  if (fseek64 (filedata->handle, filedata->archive_file_offset + offset,
-	       SEEK_SET))
+  return true;
+}
+
+/* Retrieve NMEMB structures, each SIZE bytes long from FILEDATA starting at
+   OFFSET + the offset of the current archive member, if we are examining an
+   archive.  Put the retrieved data into VAR, if it is not NULL.  Otherwise
+   allocate a buffer using malloc and fill that.  In either case return the
+   pointer to the start of the retrieved data or NULL if something went wrong.
+   If something does go wrong and REASON is not NULL then emit an error
+   message using REASON as part of the context.  */
+
+static void *
+get_data (void *var,
+	  Filedata *filedata,
+	  uint64_t offset,
+	  uint64_t size,
+	  uint64_t nmemb,
+	  const char *reason)
+{
+  void * mvar;
+  uint64_t amt = size * nmemb;
+
+  if (size == 0 || nmemb == 0)
+    return NULL;
+
+  if (!check_data_range (filedata, offset, size, nmemb, reason))
+    return NULL;
+
+  if (filedata->map == NULL
+      && fseek64 (filedata->handle, filedata->archive_file_offset + offset,
+		  SEEK_SET))
     {
       if (reason)
 	error (_("Unable to seek to %#" PRIx64 " for %s\n"),
@@ -538,7 +566,11 @@ get_data (void *var,
       ((char *) mvar)[amt] = '\0';
     }
 
-  if (fread (mvar, (size_t) size, (size_t) nmemb, filedata->handle) != nmemb)
+  if (filedata->map != NULL)
+    memcpy (mvar, filedata->map + filedata->archive_file_offset + offset,
+	    (size_t) amt);
+  else if (fread (mvar, (size_t) size, (size_t) nmemb, filedata->handle)
+	   != nmemb)
     {
       if (reason)
 	error (_("Unable to read in %" PRIu64 " bytes of %s\n"),
@@ -551,6 +583,39 @@ get_data (void *var,
   return mvar;
 }
 
+/* Like get_data with a NULL VAR, except that if FILEDATA is mapped into
+   memory the data is not copied: a pointer into the mapping is returned.
+   The data must not be modified, and must be released by calling
+   release_data_view rather than free.  */
+
+static void *
+get_data_view (Filedata *filedata,
+	       uint64_t offset,
+	       uint64_t size,
+	       uint64_t nmemb,
+	       const char *reason)
+{
+  if (filedata->map == NULL)
+    return get_data (NULL, filedata, offset, size, nmemb, reason);
+
+  if (size == 0 || nmemb == 0)
+    return NULL;
+
+  if (!check_data_range (filedata, offset, size, nmemb, reason))
+    return NULL;
+
+  return filedata->map + filedata->archive_file_offset + offset;
+}
+
+/* Release DATA, returned by get_data_view for FILEDATA.  */
+
+static void
+release_data_view (Filedata *filedata, void *data)
+{
+  if (filedata->map == NULL)
+    free (data);
+}
+
 /* Print a VMA value in the MODE specified.
    Returns the number of characters displayed.  */
 
@@ -1176,8 +1241,9 @@ slurp_rela_relocs (Filedata *filedata,
     {
       Elf32_External_Rela * erelas;
 
-      erelas = (Elf32_External_Rela *) get_data (NULL, filedata, rel_offset, 1,
-                                                 rel_size, _("32-bit relocation data"));
+      erelas = (Elf32_External_Rela *)
+	get_data_view (filedata, rel_offset, 1, rel_size,
+		       _("32-bit relocation data"));
       if (!erelas)
 	return false;
 
@@ -1188,7 +1254,7 @@ slurp_rela_relocs (Filedata *filedata,
 
       if (relas == NULL)
 	{
-	  free (erelas);
+	  release_data_view (filedata, erelas);
 	  error (_("out of memory parsing relocs\n"));
 	  return false;
 	}
@@ -1200,14 +1266,15 @@ slurp_rela_relocs (Filedata *filedata,
 	  relas[i].r_addend = BYTE_GET_SIGNED (erelas[i].r_addend);
 	}
 
-      free (erelas);
+      release_data_view (filedata, erelas);
     }
   else
     {
       Elf64_External_Rela * erelas;
 
-      erelas = (Elf64_External_Rela *) get_data (NULL, filedata, rel_offset, 1,
-                                                 rel_size, _("64-bit relocation data"));
+      erelas = (Elf64_External_Rela *)
+	get_data_view (filedata, rel_offset, 1, rel_size,
+		       _("64-bit relocation data"));
       if (!erelas)
 	return false;
 
@@ -1218,7 +1285,7 @@ slurp_rela_relocs (Filedata *filedata,
 
       if (relas == NULL)
 	{
-	  free (erelas);
+	  release_data_view (filedata, erelas);
 	  error (_("out of memory parsing relocs\n"));
 	  return false;
 	}
@@ -1247,7 +1314,7 @@ slurp_rela_relocs (Filedata *filedata,
 	    }
 	}
 
-      free (erelas);
+      release_data_view (filedata, erelas);
     }
 
   *relasp = relas;
@@ -1276,8 +1343,9 @@ slurp_rel_relocs (Filedata *filedata,
     {
       Elf32_External_Rel * erels;
 
-      erels = (Elf32_External_Rel *) get_data (NULL, filedata, rel_offset, 1,
-                                               rel_size, _("32-bit relocation data"));
+      erels = (Elf32_External_Rel *)
+	get_data_view (filedata, rel_offset, 1, rel_size,
+		       _("32-bit relocation data"));
       if (!erels)
 	return false;
 
@@ -1287,7 +1355,7 @@ slurp_rel_relocs (Filedata *filedata,
 
       if (rels == NULL)
 	{
-	  free (erels);
+	  release_data_view (filedata, erels);
 	  error (_("out of memory parsing relocs\n"));
 	  return false;
 	}
@@ -1299,14 +1367,15 @@ slurp_rel_relocs (Filedata *filedata,
 	  rels[i].r_addend = 0;
 	}
 
-      free (erels);
+      release_data_view (filedata, erels);
     }
   else
     {
       Elf64_External_Rel * erels;
 
-      erels = (Elf64_External_Rel *) get_data (NULL, filedata, rel_offset, 1,
-                                               rel_size, _("64-bit relocation data"));
+      erels = (Elf64_External_Rel *)
+	get_data_view (filedata, rel_offset, 1, rel_size,
+		       _("64-bit relocation data"));
       if (!erels)
 	return false;
 
@@ -1316,7 +1385,7 @@ slurp_rel_relocs (Filedata *filedata,
 
       if (rels == NULL)
 	{
-	  free (erels);
+	  release_data_view (filedata, erels);
 	  error (_("out of memory parsing relocs\n"));
 	  return false;
 	}
@@ -1345,7 +1414,7 @@ slurp_rel_relocs (Filedata *filedata,
 	    }
 	}
 
-      free (erels);
+      release_data_view (filedata, erels);
     }
 
   *relsp = rels;
@@ -1364,8 +1433,8 @@ slurp_relr_relocs (Filedata *filedata,
   size_t size = 0, nentries, i;
   uint64_t base = 0, addr, entry;
 
-  relrs = get_data (NULL, filedata, relr_offset, 1, relr_size,
-		    _("RELR relocation data"));
+  relrs = get_data_view (filedata, relr_offset, 1, relr_size,
+			 _("RELR relocation data"));
   if (!relrs)
     return false;
 
@@ -1390,7 +1459,7 @@ slurp_relr_relocs (Filedata *filedata,
   *relrsp = malloc (size * sizeof (**relrsp));
   if (*relrsp == NULL)
     {
-      free (relrs);
+      release_data_view (filedata, relrs);
       error (_("out of memory parsing relocs\n"));
       return false;
     }
@@ -1419,7 +1488,7 @@ slurp_relr_relocs (Filedata *filedata,
     }
 
   *nrelrsp = size;
-  free (relrs);
+  release_data_view (filedata, relrs);
   return true;
 }
 
@@ -5111,7 +5180,8 @@ enum long_option_values
   OPTION_RECURSE_LIMIT,
   OPTION_NO_RECURSE_LIMIT,
   OPTION_NO_DEMANGLING,
-  OPTION_SYM_BASE
+  OPTION_SYM_BASE,
+  OPTION_THREADS
 };
 
 static struct option options[] =
@@ -5171,6 +5241,7 @@ static struct option options[] =
 #endif
   {"sframe",	       optional_argument, 0, OPTION_SFRAME_DUMP},
   {"sym-base",	       optional_argument, 0, OPTION_SYM_BASE},
+  {"threads",	       optional_argument, 0, OPTION_THREADS},
 
   {0,		       no_argument, 0, 0}
 };
@@ -5298,6 +5369,8 @@ usage (FILE * stream)
   --dwarf-depth=N        Do not display DIEs at depth N or greater\n"));
   fprintf (stream, _("\
   --dwarf-start=N        Display DIEs starting at offset N\n"));
+  fprintf (stream, _("\
+  --threads[=N]          Display large DWARF sections using N processes\n"));
 #ifdef ENABLE_LIBCTF
   fprintf (stream, _("\
   --ctf=<number|name>    Display CTF info from section <number|name>\n"));
@@ -5569,6 +5642,14 @@ parse_args (struct dump_data *dumpdata, int argc, char ** argv)
 	case OPTION_DWARF_CHECK:
 	  dwarf_check = true;
 	  break;
+	case OPTION_THREADS:
+	  dwarf_thread_count = parse_thread_count (optarg);
+	  if (dwarf_thread_count == 0)
+	    {
+	      error (_("Invalid thread count: %s\n"), optarg);
+	      usage (stderr);
+	    }
+	  break;
 	case OPTION_CTF_DUMP:
 	  do_ctf = true;
 	  request_dump (dumpdata, CTF_DUMP);
@@ -5946,8 +6027,9 @@ get_32bit_program_headers (Filedata * filedata, Elf_Internal_Phdr * pheaders)
   if (size > sizeof * phdrs)
     warn (_("The e_phentsize field in the ELF header is larger than the size of an ELF program header\n"));
 
-  phdrs = (Elf32_External_Phdr *) get_data (NULL, filedata, filedata->file_header.e_phoff,
-                                            size, num, _("program headers"));
+  phdrs = (Elf32_External_Phdr *)
+    get_data_view (filedata, filedata->file_header.e_phoff, size, num,
+		   _("program headers"));
   if (phdrs == NULL)
     return false;
 
@@ -5965,7 +6047,7 @@ get_32bit_program_headers (Filedata * filedata, Elf_Internal_Phdr * pheaders)
       internal->p_align  = BYTE_GET (external->p_align);
     }
 
-  free (phdrs);
+  release_data_view (filedata, phdrs);
   return true;
 }
 
@@ -5993,8 +6075,9 @@ get_64bit_program_headers (Filedata * filedata, Elf_Internal_Phdr * pheaders)
   if (size > sizeof * phdrs)
     warn (_("The e_phentsize field in the ELF header is larger than the size of an ELF program header\n"));
 
-  phdrs = (Elf64_External_Phdr *) get_data (NULL, filedata, filedata->file_header.e_phoff,
-                                            size, num, _("program headers"));
+  phdrs = (Elf64_External_Phdr *)
+    get_data_view (filedata, filedata->file_header.e_phoff, size, num,
+		   _("program headers"));
   if (!phdrs)
     return false;
 
@@ -6012,7 +6095,7 @@ get_64bit_program_headers (Filedata * filedata, Elf_Internal_Phdr * pheaders)
       internal->p_align  = BYTE_GET (external->p_align);
     }
 
-  free (phdrs);
+  release_data_view (filedata, phdrs);
   return true;
 }
 
@@ -6437,9 +6520,9 @@ get_32bit_section_headers (Filedata * filedata, bool probe)
   if (!probe && size > sizeof * shdrs)
     warn (_("The e_shentsize field in the ELF header is larger than the size of an ELF section header\n"));
 
-  shdrs = (Elf32_External_Shdr *) get_data (NULL, filedata, filedata->file_header.e_shoff,
-                                            size, num,
-					    probe ? NULL : _("section headers"));
+  shdrs = (Elf32_External_Shdr *)
+    get_data_view (filedata, filedata->file_header.e_shoff, size, num,
+		   probe ? NULL : _("section headers"));
   if (shdrs == NULL)
     return false;
 
@@ -6449,7 +6532,7 @@ get_32bit_section_headers (Filedata * filedata, bool probe)
     {
       if (!probe)
 	error (_("Out of memory reading %u section headers\n"), num);
-      free (shdrs);
+      release_data_view (filedata, shdrs);
       return false;
     }
 
@@ -6473,7 +6556,7 @@ get_32bit_section_headers (Filedata * filedata, bool probe)
 	warn (_("Section %u has an out of range sh_info value of %u\n"), i, internal->sh_info);
     }
 
-  free (shdrs);
+  release_data_view (filedata, shdrs);
   return true;
 }
 
@@ -6508,10 +6591,9 @@ get_64bit_section_headers (Filedata * filedata, bool probe)
   if (! probe && size > sizeof * shdrs)
     warn (_("The e_shentsize field in the ELF header is larger than the size of an ELF section header\n"));
 
-  shdrs = (Elf64_External_Shdr *) get_data (NULL, filedata,
-					    filedata->file_header.e_shoff,
-                                            size, num,
-					    probe ? NULL : _("section headers"));
+  shdrs = (Elf64_External_Shdr *)
+    get_data_view (filedata, filedata->file_header.e_shoff, size, num,
+		   probe ? NULL : _("section headers"));
   if (shdrs == NULL)
     return false;
 
@@ -6521,7 +6603,7 @@ get_64bit_section_headers (Filedata * filedata, bool probe)
     {
       if (! probe)
 	error (_("Out of memory reading %u section headers\n"), num);
-      free (shdrs);
+      release_data_view (filedata, shdrs);
       return false;
     }
 
@@ -6545,7 +6627,7 @@ get_64bit_section_headers (Filedata * filedata, bool probe)
 	warn (_("Section %u has an out of range sh_info value of %u\n"), i, internal->sh_info);
     }
 
-  free (shdrs);
+  release_data_view (filedata, shdrs);
   return true;
 }
 
@@ -6610,8 +6692,9 @@ get_32bit_elf_symbols (Filedata *filedata,
       goto exit_point;
     }
 
-  esyms = (Elf32_External_Sym *) get_data (NULL, filedata, section->sh_offset, 1,
-                                           section->sh_size, _("symbols"));
+  esyms = (Elf32_External_Sym *)
+    get_data_view (filedata, section->sh_offset, 1, section->sh_size,
+		   _("symbols"));
   if (esyms == NULL)
     goto exit_point;
 
@@ -6624,13 +6707,13 @@ get_32bit_elf_symbols (Filedata *filedata,
       if (shndx != NULL)
 	{
 	  error (_("Multiple symbol table index sections associated with the same symbol section\n"));
-	  free (shndx);
+	  release_data_view (filedata, shndx);
 	}
 
-      shndx = (Elf_External_Sym_Shndx *) get_data (NULL, filedata,
-						   entry->hdr->sh_offset,
-						   1, entry->hdr->sh_size,
-						   _("symbol table section indices"));
+      shndx = (Elf_External_Sym_Shndx *)
+	get_data_view (filedata, entry->hdr->sh_offset, 1,
+		       entry->hdr->sh_size,
+		       _("symbol table section indices"));
       if (shndx == NULL)
 	goto exit_point;
 
@@ -6669,8 +6752,8 @@ get_32bit_elf_symbols (Filedata *filedata,
     }
 
  exit_point:
-  free (shndx);
-  free (esyms);
+  release_data_view (filedata, shndx);
+  release_data_view (filedata, esyms);
 
   if (num_syms_return != NULL)
     * num_syms_return = isyms == NULL ? 0 : number;
@@ -6727,8 +6810,9 @@ get_64bit_elf_symbols (Filedata *filedata,
       goto exit_point;
     }
 
-  esyms = (Elf64_External_Sym *) get_data (NULL, filedata, section->sh_offset, 1,
-                                           section->sh_size, _("symbols"));
+  esyms = (Elf64_External_Sym *)
+    get_data_view (filedata, section->sh_offset, 1, section->sh_size,
+		   _("symbols"));
   if (!esyms)
     goto exit_point;
 
@@ -6741,13 +6825,13 @@ get_64bit_elf_symbols (Filedata *filedata,
       if (shndx != NULL)
 	{
 	  error (_("Multiple symbol table index sections associated with the same symbol section\n"));
-	  free (shndx);
+	  release_data_view (filedata, shndx);
 	}
 
-      shndx = (Elf_External_Sym_Shndx *) get_data (NULL, filedata,
-						   entry->hdr->sh_offset,
-						   1, entry->hdr->sh_size,
-						   _("symbol table section indices"));
+      shndx = (Elf_External_Sym_Shndx *)
+	get_data_view (filedata, entry->hdr->sh_offset, 1,
+		       entry->hdr->sh_size,
+		       _("symbol table section indices"));
       if (shndx == NULL)
 	goto exit_point;
 
@@ -6788,8 +6872,8 @@ get_64bit_elf_symbols (Filedata *filedata,
     }
 
  exit_point:
-  free (shndx);
-  free (esyms);
+  release_data_view (filedata, shndx);
+  release_data_view (filedata, esyms);
 
   if (num_syms_return != NULL)
     * num_syms_return = isyms == NULL ? 0 : number;
@@ -15973,6 +16057,17 @@ dump_section_as_sframe (Elf_Internal_Shdr * section, Filedata * filedata)
   return ret;
 }
 
+/* Free the contents of SECTION, unless they are a view into the
+   mapping of the file.  */
+
+static void
+release_debug_section_data (struct dwarf_section *section)
+{
+  if (!section->mapped)
+    free (section->start);
+  section->mapped = false;
+}
+
 static bool
 load_specific_debug_section (enum dwarf_section_display_enum  debug,
 			     const Elf_Internal_Shdr *        sec,
@@ -15987,15 +16082,34 @@ load_specific_debug_section (enum dwarf_section_display_enum  debug,
       /* If it is already loaded, do nothing.  */
       if (streq (section->filename, filedata->file_name))
 	return true;
-      free (section->start);
+      release_debug_section_data (section);
     }
 
   snprintf (buf, sizeof (buf), _("%s section data"), section->name);
   section->address = sec->sh_addr;
   section->filename = filedata->file_name;
-  section->start = (unsigned char *) get_data (NULL, filedata,
-                                               sec->sh_offset, 1,
-                                               sec->sh_size, buf);
+
+  /* The units in .debug_info and .debug_types sections are decoded one
+     after another, so rather than reading in what can be gigabytes of
+     data, use the mapping of the file if they do not need to be
+     decompressed or relocated.  */
+  section->mapped = false;
+  if ((debug == info || debug == info_dwo
+       || debug == types || debug == types_dwo)
+      && section->name == section->uncompressed_name
+      && (sec->sh_flags & SHF_COMPRESSED) == 0
+      && !(debug_displays [debug].relocate
+	   && filedata->file_header.e_type == ET_REL))
+    {
+      section->start = (unsigned char *) get_data_view (filedata,
+							sec->sh_offset, 1,
+							sec->sh_size, buf);
+      section->mapped = filedata->map != NULL && section->start != NULL;
+    }
+  else
+    section->start = (unsigned char *) get_data (NULL, filedata,
+						 sec->sh_offset, 1,
+						 sec->sh_size, buf);
   if (section->start == NULL)
     section->size = 0;
   else
@@ -16065,7 +16179,8 @@ load_specific_debug_section (enum dwarf_section_display_enum  debug,
 	    {
 	      /* Free the compressed buffer, update the section buffer
 		 and the section size if uncompress is successful.  */
-	      free (section->start);
+	      section->size = sec->sh_size;
+	      release_debug_section_data (section);
 	      section->start = start;
 	    }
 	  else
@@ -16303,7 +16418,7 @@ free_debug_section (enum dwarf_section_display_enum debug)
   if (section->start == NULL)
     return;
 
-  free ((char *) section->start);
+  release_debug_section_data (section);
   section->start = NULL;
   section->address = 0;
   section->size = 0;
@@ -22376,11 +22491,44 @@ free_filedata (Filedata *filedata)
 	  sizeof (Filedata) - offsetof (Filedata, section_headers));
 }
 
+/* Map the whole of the file described by FILEDATA read-only into
+   memory, so that get_data can copy from it and get_data_view need not
+   copy at all.  If that cannot be done the file is read instead.  */
+
+static void
+map_file (Filedata *filedata)
+{
+#ifdef HAVE_MMAP
+  void *map;
+
+  filedata->map = NULL;
+  if (filedata->file_size == 0
+      || (size_t) filedata->file_size != filedata->file_size)
+    return;
+
+  map = mmap (NULL, filedata->file_size, PROT_READ, MAP_PRIVATE,
+	      fileno (filedata->handle), 0);
+  if (map != MAP_FAILED)
+    filedata->map = map;
+#endif
+}
+
+static void
+unmap_file (Filedata *filedata)
+{
+#ifdef HAVE_MMAP
+  if (filedata->map != NULL)
+    munmap (filedata->map, filedata->file_size);
+#endif
+  filedata->map = NULL;
+}
+
 static void
 close_file (Filedata * filedata)
 {
   if (filedata)
     {
+      unmap_file (filedata);
       if (filedata->handle)
 	fclose (filedata->handle);
       free (filedata);
@@ -22415,6 +22563,7 @@ open_file (const char * pathname, bool is_separate)
   filedata->file_size = statbuf.st_size;
   filedata->file_name = pathname;
   filedata->is_separate = is_separate;
+  map_file (filedata);
 
   if (! get_file_header (filedata))
     goto fail;
@@ -22427,6 +22576,7 @@ open_file (const char * pathname, bool is_separate)
  fail:
   if (filedata)
     {
+      unmap_file (filedata);
       if (filedata->handle)
         fclose (filedata->handle);
       free (filedata);
@@ -22974,6 +23124,7 @@ process_file (char * file_name)
 
   filedata->file_size = statbuf.st_size;
   filedata->is_separate = false;
+  map_file (filedata);
 
   if (memcmp (armag, ARMAG, SARMAG) == 0)
     {
@@ -22998,6 +23149,7 @@ process_file (char * file_name)
 	ret = false;
     }
 
+  unmap_file (filedata);
   fclose (filedata->handle);
   free (filedata->section_headers);
   free (filedata->program_headers);
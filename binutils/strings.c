@@ -89,6 +89,9 @@
 #include "libiberty.h"
 #include "safe-ctype.h"
 #include "bucomm.h"
+#ifdef HAVE_MMAP
+#include <sys/mman.h>
+#endif
 
 #ifndef streq
 #define streq(a,b) (strcmp ((a),(b)) == 0)
@@ -148,6 +151,14 @@ static int encoding_bytes;
 /* Output string used to separate parsed strings  */
 static char *output_separator;
 
+/* For the single-byte encodings, whether each byte is a graphic
+   character.  */
+static bool graphic_char[256];
+
+/* The size of the blocks in which a stream that cannot be mapped is
+   read, when the encoding is a single-byte one.  */
+#define SCAN_BLOCK_SIZE (64 * 1024)
+
 static struct option long_options[] =
 {
   {"all", no_argument, NULL, 'a'},
@@ -336,6 +347,14 @@ main (int argc, char **argv)
       usage (stderr, 1);
     }
 
+  if (encoding_bytes == 1)
+    {
+      int c;
+
+      for (c = 0; c < 256; c++)
+	graphic_char[c] = STRING_ISGRAPHIC (c);
+    }
+
   if (bfd_init () != BFD_INIT_MAGIC)
     fatal (_("fatal error: libbfd ABI mismatch"));
   set_default_bfd_target ();
@@ -1223,6 +1242,242 @@ print_unicode_stream (const char * filename,
   free (print_buf);
 }
 
+/* The state of a search for strings in single-byte characters, which
+   is carried from one block of input to the next.  */
+
+struct string_scan
+{
+  const char *filename;
+  /* The address of the start of the current block.  */
+  file_ptr address;
+  /* The address of the current run of graphic characters.  */
+  file_ptr start;
+  /* The length of that run so far, or STRING_MIN once it is known to
+     be long enough and is being printed.  */
+  unsigned int len;
+  /* The characters of the run while it is too short to print.  */
+  char *buf;
+};
+
+static void
+print_separator (void)
+{
+  if (output_separator)
+    fputs (output_separator, stdout);
+  else
+    putchar ('\n');
+}
+
+/* Return the first character from P up to END that is not graphic, or
+   END.  For the default encoding, eight characters at a time are
+   checked to be between ' ' and '~' where possible.  */
+
+static const unsigned char *
+skip_graphic (const unsigned char *p, const unsigned char *end)
+{
+  const uint64_t ones = 0x0101010101010101ull;
+  const uint64_t highs = ones * 0x80;
+  bool by_word = encoding == 's' && !include_all_whitespace;
+
+  while (p < end)
+    {
+      if (by_word && end - p >= 8)
+	{
+	  uint64_t word;
+
+	  /* Each byte is below 0x80, so adding to it cannot carry into
+	     the next one.  It is at least ' ' if adding 0x60 sets its
+	     top bit, and at most '~' if adding 1 does not.  */
+	  memcpy (&word, p, 8);
+	  if ((word & highs) == 0
+	      && ((word + ones * 0x60) & highs) == highs
+	      && ((word + ones) & highs) == 0)
+	    {
+	      p += 8;
+	      continue;
+	    }
+	}
+      if (!graphic_char[*p])
+	break;
+      p++;
+    }
+  return p;
+}
+
+/* Return the first graphic character from P up to END, or END.  Runs
+   of zero bytes are skipped eight at a time.  */
+
+static const unsigned char *
+skip_nongraphic (const unsigned char *p, const unsigned char *end)
+{
+  while (p < end)
+    {
+      if (end - p >= 8)
+	{
+	  uint64_t word;
+
+	  memcpy (&word, p, 8);
+	  if (word == 0)
+	    {
+	      p += 8;
+	      continue;
+	    }
+	}
+      if (graphic_char[*p])
+	break;
+      p++;
+    }
+  return p;
+}
+
+/* Print the strings in the SIZE bytes at DATA, the next block of the
+   input being scanned by SCAN.  This has the same output as the loop
+   in print_strings, but finds each run of graphic characters in one
+   go and writes it out in one go.  */
+
+static void
+scan_block (struct string_scan *scan, const unsigned char *data,
+	    size_t size)
+{
+  const unsigned char *p = data;
+  const unsigned char *end = data + size;
+  const unsigned char *q;
+
+  while (p < end)
+    {
+      if (scan->len == string_min)
+	{
+	  /* Carry on printing the current string.  */
+	  q = skip_graphic (p, end);
+	  fwrite (p, 1, q - p, stdout);
+	}
+      else
+	{
+	  if (scan->len == 0)
+	    {
+	      p = skip_nongraphic (p, end);
+	      if (p == end)
+		break;
+	      scan->start = scan->address + (p - data);
+	    }
+
+	  q = skip_graphic (p, end);
+	  if ((size_t) (q - p) >= string_min - scan->len)
+	    {
+	      print_filename_and_address (scan->filename, scan->start);
+	      fwrite (scan->buf, 1, scan->len, stdout);
+	      fwrite (p, 1, q - p, stdout);
+	      scan->len = string_min;
+	    }
+	  else if (q == end)
+	    {
+	      /* The run may go on in the next block.  */
+	      memcpy (scan->buf + scan->len, p, q - p);
+	      scan->len += q - p;
+	    }
+	  else
+	    scan->len = 0;
+	}
+
+      if (q == end)
+	break;
+
+      /* Skip the character that ended the run.  */
+      if (scan->len == string_min)
+	print_separator ();
+      scan->len = 0;
+      p = q + 1;
+    }
+
+  scan->address += size;
+}
+
+/* Map the regular file open on STREAM into memory, setting *MAP and
+   *MAP_SIZE to the mapping.  Return the address of the data from the
+   current position of STREAM on, and set *SIZE to its size.  Return
+   NULL if the file cannot be mapped.  */
+
+static void *
+map_stream (FILE *stream, size_t *size, void **map, size_t *map_size)
+{
+#ifdef HAVE_MMAP
+  struct stat st;
+  off_t pos;
+  void *addr;
+
+  if (fstat (fileno (stream), &st) != 0
+      || !S_ISREG (st.st_mode)
+      || st.st_size <= 0
+      || (size_t) st.st_size != (uintmax_t) st.st_size)
+    return NULL;
+
+  pos = ftello (stream);
+  if (pos < 0 || pos >= st.st_size)
+    return NULL;
+
+  addr = mmap (NULL, st.st_size, PROT_READ, MAP_PRIVATE,
+	       fileno (stream), 0);
+  if (addr == MAP_FAILED)
+    return NULL;
+#ifdef MADV_SEQUENTIAL
+  madvise (addr, st.st_size, MADV_SEQUENTIAL);
+#endif
+
+  *map = addr;
+  *map_size = st.st_size;
+  *size = st.st_size - pos;
+  return (char *) addr + pos;
+#else
+  return NULL;
+#endif
+}
+
+/* print_strings for the single-byte encodings.  A regular file is
+   mapped into memory where possible, and scanned as a single block.  */
+
+static void
+print_strings_by_block (const char *filename, FILE *stream,
+			file_ptr address, int magiccount, char *magic)
+{
+  struct string_scan scan;
+
+  scan.filename = filename;
+  scan.address = address;
+  scan.start = address;
+  scan.len = 0;
+  scan.buf = (char *) xmalloc (string_min);
+
+  if (magic != NULL)
+    scan_block (&scan, (const unsigned char *) magic, magiccount);
+
+  if (stream != NULL)
+    {
+      void *data, *map = NULL;
+      size_t size, map_size = 0;
+
+      data = map_stream (stream, &size, &map, &map_size);
+      if (data != NULL)
+	{
+	  scan_block (&scan, (const unsigned char *) data, size);
+#ifdef HAVE_MMAP
+	  munmap (map, map_size);
+#endif
+	}
+      else
+	{
+	  unsigned char *block = (unsigned char *) xmalloc (SCAN_BLOCK_SIZE);
+
+	  while ((size = fread (block, 1, SCAN_BLOCK_SIZE, stream)) != 0)
+	    scan_block (&scan, block, size);
+	  free (block);
+	}
+    }
+
+  if (scan.len == string_min)
+    print_separator ();
+  free (scan.buf);
+}
+
 /* Find the strings in file FILENAME, read from STREAM.
    Assume that STREAM is positioned so that the next byte read
    is at address ADDRESS in the file.
@@ -1249,6 +1504,12 @@ print_strings (const char *filename, FILE *stream, file_ptr address,
       return;
     }
 
+  if (encoding_bytes == 1)
+    {
+      print_strings_by_block (filename, stream, address, magiccount, magic);
+      return;
+    }
+
   char *buf = (char *) xmalloc (sizeof (char) * (string_min + 1));
 
   while (1)
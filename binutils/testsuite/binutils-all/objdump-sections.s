@@ -0,0 +1,14 @@
+	.irp	i,0,1,2,3,4,5,6,7,8,9,a,b,c,d,e,f
+	.irp	j,0,1,2,3,4,5,6,7,8,9,a,b,c,d,e,f
+	.irp	k,0,1,2,3,4,5,6,7,8,9,a,b,c,d,e,f
+	.section .text.f\i\j\k,"ax",@progbits
+	.globl	f\i\j\k
+f\i\j\k:
+	.rept	4
+	jmp	1f
+1:
+	.endr
+	ret
+	.endr
+	.endr
+	.endr
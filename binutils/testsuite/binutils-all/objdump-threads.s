@@ -0,0 +1,13 @@
+	.text
+	.irp	i,0,1,2,3,4,5,6,7,8,9,a,b,c,d,e,f
+	.irp	j,0,1,2,3,4,5,6,7,8,9,a,b,c,d,e,f
+	.globl	func_\i\j
+	.type	func_\i\j, %function
+func_\i\j:
+	.rept	110
+	addl	$0x1\i\j, %eax
+	.endr
+	ret
+	.size	func_\i\j, . - func_\i\j
+	.endr
+	.endr
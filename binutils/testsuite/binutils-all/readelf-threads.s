@@ -0,0 +1,70 @@
+# Large .debug_info and .debug_line sections, with enough compilation
+# units and line number programs that readelf --threads splits them.
+
+	.section .debug_abbrev,"",%progbits
+	.uleb128 1		# Abbrev 1: DW_TAG_compile_unit
+	.uleb128 0x11
+	.byte 1
+	.uleb128 0x3		# DW_AT_name
+	.uleb128 0x8		# DW_FORM_string
+	.uleb128 0x13		# DW_AT_language
+	.uleb128 0xb		# DW_FORM_data1
+	.byte 0, 0
+	.uleb128 2		# Abbrev 2: DW_TAG_variable
+	.uleb128 0x34
+	.byte 0
+	.uleb128 0x3		# DW_AT_name
+	.uleb128 0x8		# DW_FORM_string
+	.uleb128 0x1c		# DW_AT_const_value
+	.uleb128 0x6		# DW_FORM_data4
+	.byte 0, 0
+	.byte 0
+
+	.section .debug_info,"",%progbits
+	.irp	i,0,1,2,3,4,5,6,7,8,9,a,b,c,d,e,f
+	.irp	j,0,1,2,3,4,5,6,7,8,9,a,b,c,d,e,f
+	.4byte	2f - 1f		# Length
+1:	.2byte	4		# Version
+	.4byte	0		# Abbrev offset
+	.byte	4		# Pointer size
+	.uleb128 1		# DW_TAG_compile_unit
+	.asciz	"unit_\i\j.c"
+	.byte	0xc		# DW_LANG_C99
+	.uleb128 2		# DW_TAG_variable
+	.rept	1100
+	.ascii	"v"
+	.endr
+	.byte	0
+	.4byte	0x\i\j
+	.byte	0		# End of children
+2:
+	.endr
+	.endr
+
+	.section .debug_line,"",%progbits
+	.irp	i,0,1,2,3,4,5,6,7,8,9,a,b,c,d,e,f
+	.irp	j,0,1,2,3,4,5,6,7,8,9,a,b,c,d,e,f
+	.4byte	4f - 3f		# Length
+3:	.2byte	3		# Version
+	.4byte	6f - 5f		# Header length
+5:	.byte	1		# Minimum instruction length
+	.byte	1		# Default is_stmt
+	.byte	-5		# Line base
+	.byte	14		# Line range
+	.byte	13		# Opcode base
+	.byte	0, 1, 1, 1, 1, 0, 0, 0, 1, 0, 0, 1
+	.rept	1100		# Include directory
+	.ascii	"d"
+	.endr
+	.byte	0
+	.byte	0
+	.asciz	"unit_\i\j.c"	# File name
+	.uleb128 1
+	.uleb128 0
+	.uleb128 0
+	.byte	0
+6:	.byte	0x20, 0x21	# Special opcodes
+	.byte	0, 1, 1		# DW_LNE_end_sequence
+4:
+	.endr
+	.endr
@@ -25,6 +25,7 @@
    .linefile.  This needs better error-handling.  */
 
 #include "as.h"
+#include "input-file.h"
 
 #if (__STDC__ != 1)
 #ifndef const
@@ -545,7 +546,7 @@ do_scrub_chars (size_t (*get) (char *, size_t), char *tostart, size_t tolen)
 
 		  if (ch == EOF)
 		    {
-		      as_warn (_("end of file in comment"));
+		      input_file_warn (_("end of file in comment"));
 		      goto fromeof;
 		    }
 
@@ -559,7 +560,7 @@ do_scrub_chars (size_t (*get) (char *, size_t), char *tostart, size_t tolen)
 
 	      if (ch == EOF)
 		{
-		  as_warn (_("end of file in comment"));
+		  input_file_warn (_("end of file in comment"));
 		  goto fromeof;
 		}
 
@@ -637,7 +638,8 @@ do_scrub_chars (size_t (*get) (char *, size_t), char *tostart, size_t tolen)
 		 that the UNGET below will work.  */
 	      static char one_char_buf[1];
 
-	      as_warn (_("end of file in string; '%c' inserted"), quotechar);
+	      input_file_warn (_("end of file in string; '%c' inserted"),
+			       quotechar);
 	      state = old_state;
 	      from = fromend = one_char_buf + 1;
 	      fromlen = 1;
@@ -682,7 +684,8 @@ do_scrub_chars (size_t (*get) (char *, size_t), char *tostart, size_t tolen)
 	      continue;
 
 	    case EOF:
-	      as_warn (_("end of file in string; '%c' inserted"), quotechar);
+	      input_file_warn (_("end of file in string; '%c' inserted"),
+			       quotechar);
 	      PUT (quotechar);
 	      continue;
 
@@ -708,7 +711,8 @@ do_scrub_chars (size_t (*get) (char *, size_t), char *tostart, size_t tolen)
 
 	    default:
 #ifdef ONLY_STANDARD_ESCAPES
-	      as_warn (_("unknown escape '\\%c' in string; ignored"), ch);
+	      input_file_warn (_("unknown escape '\\%c' in string; ignored"),
+			       ch);
 #endif
 	      break;
 	    }
@@ -884,7 +888,8 @@ do_scrub_chars (size_t (*get) (char *, size_t), char *tostart, size_t tolen)
 	{
 	  if (state != 0)
 	    {
-	      as_warn (_("end of file not at end of a line; newline inserted"));
+	      input_file_warn
+		(_("end of file not at end of a line; newline inserted"));
 	      state = 0;
 	      PUT ('\n');
 	    }
@@ -1046,7 +1051,7 @@ do_scrub_chars (size_t (*get) (char *, size_t), char *tostart, size_t tolen)
 		}
 
 	      if (ch2 == EOF)
-		as_warn (_("end of file in multiline comment"));
+		input_file_warn (_("end of file in multiline comment"));
 
 	      ch = ' ';
 	      goto recycle;
@@ -1060,7 +1065,7 @@ do_scrub_chars (size_t (*get) (char *, size_t), char *tostart, size_t tolen)
 		}
 	      while (ch != EOF && !IS_NEWLINE (ch));
 	      if (ch == EOF)
-		as_warn ("end of file in comment; newline inserted");
+		input_file_warn ("end of file in comment; newline inserted");
 	      state = 0;
 	      PUT ('\n');
 	      break;
@@ -1105,7 +1110,7 @@ do_scrub_chars (size_t (*get) (char *, size_t), char *tostart, size_t tolen)
 	      char c;
 
 	      c = GET ();
-	      as_warn ("'%c found after symbol", c);
+	      input_file_warn ("'%c found after symbol", c);
 	      UNGET (c);
 	    }
 #endif
@@ -1120,7 +1125,8 @@ do_scrub_chars (size_t (*get) (char *, size_t), char *tostart, size_t tolen)
 	  ch = GET ();
 	  if (ch == EOF)
 	    {
-	      as_warn (_("end of file after a one-character quote; \\0 inserted"));
+	      input_file_warn
+		(_("end of file after a one-character quote; \\0 inserted"));
 	      ch = 0;
 	    }
 	  if (ch == '\\')
@@ -1128,7 +1134,7 @@ do_scrub_chars (size_t (*get) (char *, size_t), char *tostart, size_t tolen)
 	      ch = GET ();
 	      if (ch == EOF)
 		{
-		  as_warn (_("end of file in escape character"));
+		  input_file_warn (_("end of file in escape character"));
 		  ch = '\\';
 		}
 	      else
@@ -1140,7 +1146,7 @@ do_scrub_chars (size_t (*get) (char *, size_t), char *tostart, size_t tolen)
 	  if ((ch = GET ()) != '\'')
 	    {
 #ifdef REQUIRE_CHAR_CLOSE_QUOTE
-	      as_warn (_("missing close quote; (assumed)"));
+	      input_file_warn (_("missing close quote; (assumed)"));
 #else
 	      if (ch != EOF)
 		UNGET (ch);
@@ -1208,7 +1214,7 @@ do_scrub_chars (size_t (*get) (char *, size_t), char *tostart, size_t tolen)
 	  while (ch != EOF && ch != '\n');
 
 	  if (ch == EOF)
-	    as_warn (_("end of file in comment; newline inserted"));
+	    input_file_warn (_("end of file in comment; newline inserted"));
 
 	  state = 0;
 	  PUT ('\n');
@@ -1263,7 +1269,8 @@ do_scrub_chars (size_t (*get) (char *, size_t), char *tostart, size_t tolen)
 
 	      if (ch == EOF)
 		{
-		  as_warn (_("end of file in comment; newline inserted"));
+		  input_file_warn
+		    (_("end of file in comment; newline inserted"));
 		  PUT ('\n');
 		  break;
 		}
@@ -1275,7 +1282,8 @@ do_scrub_chars (size_t (*get) (char *, size_t), char *tostart, size_t tolen)
 		    ch = GET ();
 		  if (ch == EOF)
 		    {
-		      as_warn (_("end of file in comment; newline inserted"));
+		      input_file_warn
+			(_("end of file in comment; newline inserted"));
 		      PUT ('\n');
 		    }
 		  else /* IS_NEWLINE (ch) */
@@ -1353,7 +1361,7 @@ do_scrub_chars (size_t (*get) (char *, size_t), char *tostart, size_t tolen)
 	    }
 	  while (ch != EOF && !IS_NEWLINE (ch));
 	  if (ch == EOF)
-	    as_warn (_("end of file in comment; newline inserted"));
+	    input_file_warn (_("end of file in comment; newline inserted"));
 	  state = 0;
 	  PUT ('\n');
 	  break;
@@ -377,6 +377,9 @@ Options:\n\
   fprintf (stream, _("\
   --strip-local-absolute  strip local absolute symbols\n"));
   fprintf (stream, _("\
+  --threads[=N]           use up to N threads to compress debug sections\n\
+                          and to read and preprocess input\n"));
+  fprintf (stream, _("\
   --traditional-format    Use same format as native assembler when possible\n"));
   fprintf (stream, _("\
   --version               print assembler version number and exit\n"));
@@ -511,7 +514,8 @@ parse_args (int * pargc, char *** pargv)
       OPTION_NOCOMPRESS_DEBUG,
       OPTION_NO_PAD_SECTIONS,
       OPTION_MULTIBYTE_HANDLING,  /* = STD_BASE + 40 */
-      OPTION_SFRAME
+      OPTION_SFRAME,
+      OPTION_THREADS
     /* When you add options here, check that they do
        not collide with OPTION_MD_BASE.  See as.h.  */
     };
@@ -588,6 +592,7 @@ parse_args (int * pargc, char *** pargv)
     ,{"reduce-memory-overheads", no_argument, NULL, OPTION_REDUCE_MEMORY_OVERHEADS}
     ,{"statistics", no_argument, NULL, OPTION_STATISTICS}
     ,{"strip-local-absolute", no_argument, NULL, OPTION_STRIP_LOCAL_ABSOLUTE}
+    ,{"threads", optional_argument, NULL, OPTION_THREADS}
     ,{"version", no_argument, NULL, OPTION_VERSION}
     ,{"verbose", no_argument, NULL, OPTION_VERBOSE}
     ,{"target-help", no_argument, NULL, OPTION_TARGET_HELP}
@@ -692,6 +697,23 @@ parse_args (int * pargc, char *** pargv)
 	  flag_strip_local_absolute = 1;
 	  break;
 
+	case OPTION_THREADS:
+	  {
+	    unsigned long count = 0;
+
+	    if (optarg != NULL)
+	      {
+		char *end;
+
+		count = strtoul (optarg, &end, 0);
+		if (*end != '\0' || count == 0
+		    || (unsigned int) count != count)
+		  as_fatal (_("Invalid --threads= option: `%s'"), optarg);
+	      }
+	    bfd_set_thread_count (count);
+	  }
+	  break;
+
 	case OPTION_TRADITIONAL_FORMAT:
 	  flag_traditional_format = 1;
 	  break;
@@ -20,6 +20,7 @@
 
 #include "config.h"
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 #include <zlib.h>
 #if HAVE_ZSTD
@@ -28,7 +29,9 @@
 #include "ansidecl.h"
 #include "compress-debug.h"
 
-/* Initialize the compression engine.  */
+/* Initialize the compression engine.  Returns NULL on failure.  Each
+   call returns a separate context, so several sections can be
+   compressed at once.  */
 
 void *
 compress_init (bool use_zstd)
@@ -39,10 +42,16 @@ compress_init (bool use_zstd)
 #endif
   }
 
-  static struct z_stream_s strm;
-  memset (&strm, 0, sizeof (strm));
-  deflateInit (&strm, Z_DEFAULT_COMPRESSION);
-  return &strm;
+  struct z_stream_s *strm = malloc (sizeof (*strm));
+  if (strm == NULL)
+    return NULL;
+  memset (strm, 0, sizeof (*strm));
+  if (deflateInit (strm, Z_DEFAULT_COMPRESSION) != Z_OK)
+    {
+      free (strm);
+      return NULL;
+    }
+  return strm;
 }
 
 /* Stream the contents of a frag to the compression engine.  Output
@@ -129,9 +138,29 @@ compress_finish (bool use_zstd, void *ctx, char **next_out,
   if (x == Z_STREAM_END)
     {
       deflateEnd (strm);
+      free (strm);
       return 0;
     }
   if (strm->avail_out != 0)
     return -1;
   return 1;
 }
+
+/* Abandon a compression that has not been finished, releasing CTX.  */
+
+void
+compress_abort (bool use_zstd, void *ctx)
+{
+  if (use_zstd)
+    {
+#if HAVE_ZSTD
+      ZSTD_freeCCtx (ctx);
+      return;
+#endif
+    }
+
+  struct z_stream_s *strm = ctx;
+
+  deflateEnd (strm);
+  free (strm);
+}
@@ -36,4 +36,7 @@ extern int compress_data (bool, void *, const char **, int *, char **, int *);
 extern int
 compress_finish (bool, void *, char **, int *, int *);
 
+/* Abandon a compression that has not been finished.  */
+extern void compress_abort (bool, void *);
+
 #endif /* COMPRESS_DEBUG_H */
@@ -62,14 +62,26 @@ htab_insert (htab_t htab, void *element, int replace)
   return NULL;
 }
 
+/* Print statistics about a hash table, given its counters.  */
+
+void
+hash_print_statistics (FILE *f, const char *name, unsigned long searches,
+		       unsigned long collisions, unsigned long elements,
+		       unsigned long size)
+{
+  fprintf (f, "%s hash statistics:\n", name);
+  fprintf (f, "\t%lu searches\n", searches);
+  fprintf (f, "\t%lu collisions\n", collisions);
+  fprintf (f, "\t%lu elements\n", elements);
+  fprintf (f, "\t%lu table size\n", size);
+}
+
 /* Print statistics about a hash table.  */
 
 void
 htab_print_statistics (FILE *f, const char *name, htab_t table)
 {
-  fprintf (f, "%s hash statistics:\n", name);
-  fprintf (f, "\t%u searches\n", table->searches);
-  fprintf (f, "\t%u collisions\n", table->collisions);
-  fprintf (f, "\t%lu elements\n", (unsigned long) htab_elements (table));
-  fprintf (f, "\t%lu table size\n", (unsigned long) htab_size (table));
+  hash_print_statistics (f, name, table->searches, table->collisions,
+			 (unsigned long) htab_elements (table),
+			 (unsigned long) htab_size (table));
 }
@@ -47,6 +47,13 @@ extern void **htab_insert (htab_t, void * /* element */, int /* replace */);
 
 extern void htab_print_statistics (FILE *f, const char *name, htab_t table);
 
+/* Print statistics about a hash table, given its counters.  */
+
+extern void hash_print_statistics (FILE *f, const char *name,
+				   unsigned long searches,
+				   unsigned long collisions,
+				   unsigned long elements, unsigned long size);
+
 /* Inline string hash table functions.  */
 
 static inline string_tuple_t *
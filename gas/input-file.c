@@ -26,6 +26,16 @@
 #include "as.h"
 #include "input-file.h"
 #include "safe-ctype.h"
+#ifdef HAVE_SYS_STAT_H
+#include <sys/stat.h>
+#endif
+#if defined (HAVE_MMAP) && defined (HAVE_SYS_MMAN_H)
+#include <sys/mman.h>
+#define USE_MMAP_INPUT 1
+#endif
+#ifdef HAVE_PTHREAD
+#include <pthread.h>
+#endif
 
 /* This variable is non-zero if the file currently being read should be
    preprocessed by app.  It is zero if the file can be read straight in.  */
@@ -44,6 +54,87 @@ int preprocess = 0;
 static FILE *f_in;
 static const char *file_name;
 
+/* A regular input file is mapped into memory rather than read through
+   F_IN.  MAP_PENDING is a character to be delivered before the rest of
+   the mapping, from MAP_POS on; it is needed because input_file_open
+   can push a character back that is not the one in the file.  */
+
+struct input_map
+  {
+    const char *data;
+    size_t size;
+    size_t pos;
+    int pending;
+  };
+
+static struct input_map *input_map;
+
+#ifdef HAVE_PTHREAD
+/* When threads are allowed, a file that needs preprocessing is read
+   and run through do_scrub_chars on a thread of its own, which keeps
+   up to INPUT_PIPE_BUFFERS buffers ahead of the parser.  Each buffer
+   is exactly what input_file_give_next_buffer would have produced at
+   that point, together with any diagnostics issued while producing
+   it, which are issued when the buffer is handed over, just as they
+   would have been without the thread.
+
+   Only one thread scrubs at a time: input_file_push stops the thread
+   of the current file, so that the scrubber's state can be saved and
+   used for something else, and input_file_pop lets it continue.  */
+
+#define INPUT_PIPE_BUFFERS 8
+
+struct input_buffer
+  {
+    char *data;
+    size_t size;
+    /* Diagnostics to issue with this buffer, and whether each is an
+       error rather than a warning.  */
+    char **diags;
+    bool *diag_is_error;
+    unsigned int num_diags;
+  };
+
+struct input_pipe
+  {
+    pthread_t thread;
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+    struct input_buffer buffers[INPUT_PIPE_BUFFERS];
+    /* The buffers from FIRST on, COUNT of them, are ready.  */
+    unsigned int first;
+    unsigned int count;
+    /* Set while the thread is producing a buffer.  */
+    bool busy;
+    /* Set to ask the thread to wait, or to exit.  */
+    bool paused;
+    bool stop;
+    /* Set once the thread has produced the empty buffer that marks the
+       end of the file, after which it exits.  */
+    bool eof;
+    /* The buffer the thread is producing, while it is producing one,
+       for input_file_diag.  Only the thread uses it.  */
+    struct input_buffer *current;
+  };
+
+static struct input_pipe *input_pipe;
+
+/* Whether the scrubber can run ahead of the parser on a thread.  It
+   cannot if it looks at anything the parser changes as it goes: the
+   current line, when warning about multibyte characters or comments,
+   or whether a label needs a colon, for MMIX.  On the m68k the same
+   goes for flag_m68k_mri, which the .mri pseudo-op changes when the
+   parser reaches it, and which may come from a macro or an included
+   file at any point; no m68k input is scrubbed ahead.  Elsewhere .mri
+   does not affect the scrubber.  MULTIBYTE_HANDLING is only set on
+   the command line, so it cannot change once a file is started.  */
+#if defined (TC_MMIX) || defined (TC_M68K) || defined (WARN_COMMENTS)
+#define SCRUB_AHEAD_OK 0
+#else
+#define SCRUB_AHEAD_OK (multibyte_handling != multibyte_warn)
+#endif
+#endif /* HAVE_PTHREAD */
+
 /* Struct for saving the state of this module for file includes.  */
 struct saved_file
   {
@@ -51,7 +142,15 @@ struct saved_file
     const char * file_name;
     int    preprocess;
     char * app_save;
+    struct input_map *input_map;
+#ifdef HAVE_PTHREAD
+    struct input_pipe *input_pipe;
+#endif
   };
+
+static void input_pipe_pause (void);
+static void input_pipe_resume (void);
+static void input_pipe_close (void);
 
 /* These hooks accommodate most operating systems.  */
 
@@ -59,6 +158,10 @@ void
 input_file_begin (void)
 {
   f_in = (FILE *) 0;
+  input_map = NULL;
+#ifdef HAVE_PTHREAD
+  input_pipe = NULL;
+#endif
 }
 
 void
@@ -83,9 +186,17 @@ input_file_push (void)
 
   saved = XNEW (struct saved_file);
 
+  /* The scrubber is about to be used for something else, so stop the
+     thread using it.  */
+  input_pipe_pause ();
+
   saved->f_in = f_in;
   saved->file_name = file_name;
   saved->preprocess = preprocess;
+  saved->input_map = input_map;
+#ifdef HAVE_PTHREAD
+  saved->input_pipe = input_pipe;
+#endif
   if (preprocess)
     saved->app_save = app_push ();
 
@@ -105,10 +216,75 @@ input_file_pop (char *arg)
   f_in = saved->f_in;
   file_name = saved->file_name;
   preprocess = saved->preprocess;
+  input_map = saved->input_map;
+#ifdef HAVE_PTHREAD
+  input_pipe = saved->input_pipe;
+#endif
   if (preprocess)
     app_pop (saved->app_save);
 
   free (arg);
+
+  input_pipe_resume ();
+}
+
+/* Map the rest of the regular file F_IN, just opened, into memory.
+   If that cannot be done it is read through F_IN instead.  */
+
+static void
+input_file_map (void)
+{
+#ifdef USE_MMAP_INPUT
+  struct stat st;
+  off_t pos;
+  void *data;
+  int c;
+
+  if (fstat (fileno (f_in), &st) != 0
+      || !S_ISREG (st.st_mode)
+      || st.st_size <= 0
+      || (size_t) st.st_size != (uintmax_t) st.st_size)
+    return;
+
+  /* Take the character input_file_open pushed back.  */
+  c = getc (f_in);
+  pos = ftello (f_in);
+  if (c == EOF || pos < 0 || pos > st.st_size)
+    {
+      if (c != EOF)
+	ungetc (c, f_in);
+      return;
+    }
+
+  data = mmap (NULL, st.st_size, PROT_READ, MAP_PRIVATE, fileno (f_in), 0);
+  if (data == MAP_FAILED)
+    {
+      ungetc (c, f_in);
+      return;
+    }
+#ifdef MADV_SEQUENTIAL
+  madvise (data, st.st_size, MADV_SEQUENTIAL);
+#endif
+
+  input_map = XNEW (struct input_map);
+  input_map->data = data;
+  input_map->size = st.st_size;
+  input_map->pos = pos;
+  input_map->pending = c;
+#endif
+}
+
+static void
+input_file_unmap (void)
+{
+#ifdef USE_MMAP_INPUT
+  if (input_map != NULL)
+    {
+      munmap ((void *) input_map->data, input_map->size);
+      free (input_map);
+      input_map = NULL;
+    }
+#endif
 }
 
 /* Open the specified file, "" means stdin.  Filename must not be null.  */
@@ -195,6 +371,8 @@ input_file_open (const char *filename,
     }
   else
     ungetc (c, f_in);
+
+  input_file_map ();
 }
 
 /* Close input file.  */
@@ -202,6 +380,9 @@ input_file_open (const char *filename,
 void
 input_file_close (void)
 {
+  input_pipe_close ();
+  input_file_unmap ();
+
   /* Don't close a null file pointer.  */
   if (f_in != NULL)
     fclose (f_in);
@@ -209,6 +390,61 @@ input_file_close (void)
   f_in = 0;
 }
 
+/* Issue a warning, or if ERROR an error, about the input while it is
+   being read or preprocessed.  On the thread of an input pipe it is
+   saved until the buffer being produced is handed to the parser.  */
+
+static void
+input_file_diag (bool error, const char *format, va_list args)
+{
+  char buffer[2000];
+
+  vsnprintf (buffer, sizeof (buffer), format, args);
+#ifdef HAVE_PTHREAD
+  /* While the current file has an input pipe, only its thread runs the
+     scrubber, and INPUT_PIPE does not change while the thread is busy:
+     input_file_push waits for it to finish its buffer first.  */
+  if (input_pipe != NULL && input_pipe->current != NULL)
+    {
+      struct input_buffer *buf = input_pipe->current;
+
+      buf->diags = XRESIZEVEC (char *, buf->diags, buf->num_diags + 1);
+      buf->diag_is_error = XRESIZEVEC (bool, buf->diag_is_error,
+				       buf->num_diags + 1);
+      buf->diags[buf->num_diags] = xstrdup (buffer);
+      buf->diag_is_error[buf->num_diags] = error;
+      buf->num_diags++;
+      return;
+    }
+#endif
+  if (error)
+    as_bad ("%s", buffer);
+  else
+    as_warn ("%s", buffer);
+}
+
+/* Issue a warning from the preprocessor.  See input_file_diag.  */
+
+void
+input_file_warn (const char *format, ...)
+{
+  va_list args;
+
+  va_start (args, format);
+  input_file_diag (false, format, args);
+  va_end (args);
+}
+
+static void
+input_file_bad (const char *format, ...)
+{
+  va_list args;
+
+  va_start (args, format);
+  input_file_diag (true, format, args);
+  va_end (args);
+}
+
 /* This function is passed to do_scrub_chars.  */
 
 static size_t
@@ -216,14 +452,205 @@ input_file_get (char *buf, size_t buflen)
 {
   size_t size;
 
+  if (input_map != NULL)
+    {
+      size = 0;
+      if (input_map->pending != EOF && buflen > 0)
+	{
+	  buf[size++] = input_map->pending;
+	  input_map->pending = EOF;
+	}
+      if (buflen - size > input_map->size - input_map->pos)
+	buflen = input_map->size - input_map->pos + size;
+      memcpy (buf + size, input_map->data + input_map->pos, buflen - size);
+      input_map->pos += buflen - size;
+      return buflen;
+    }
+
   if (feof (f_in))
     return 0;
 
   size = fread (buf, sizeof (char), buflen, f_in);
   if (ferror (f_in))
-    as_bad (_("can't read from %s: %s"), file_name, xstrerror (errno));
+    input_file_bad (_("can't read from %s: %s"), file_name, xstrerror (errno));
+  return size;
+}
+
+#ifdef HAVE_PTHREAD
+/* The body of the thread of an input pipe.  */
+
+static void *
+input_pipe_run (void *arg)
+{
+  struct input_pipe *pipe = (struct input_pipe *) arg;
+
+  pthread_mutex_lock (&pipe->lock);
+  for (;;)
+    {
+      struct input_buffer *buf;
+
+      while (!pipe->stop
+	     && (pipe->paused || pipe->count == INPUT_PIPE_BUFFERS))
+	pthread_cond_wait (&pipe->cond, &pipe->lock);
+      if (pipe->stop)
+	break;
+
+      buf = &pipe->buffers[(pipe->first + pipe->count) % INPUT_PIPE_BUFFERS];
+      pipe->busy = true;
+      pthread_mutex_unlock (&pipe->lock);
+
+      pipe->current = buf;
+      buf->size = do_scrub_chars (input_file_get, buf->data, BUFFER_SIZE);
+      pipe->current = NULL;
+
+      pthread_mutex_lock (&pipe->lock);
+      pipe->busy = false;
+      pipe->count++;
+      if (buf->size == 0)
+	pipe->eof = true;
+      pthread_cond_broadcast (&pipe->cond);
+      if (pipe->eof)
+	break;
+    }
+  pthread_mutex_unlock (&pipe->lock);
+  return NULL;
+}
+
+/* Start a thread to read and preprocess the current file, if that is
+   allowed and worthwhile.  */
+
+static void
+input_pipe_start (void)
+{
+  struct input_pipe *pipe;
+  unsigned int i;
+
+  if (bfd_get_thread_count () <= 1 || !SCRUB_AHEAD_OK)
+    return;
+
+  pipe = XCNEW (struct input_pipe);
+  for (i = 0; i < INPUT_PIPE_BUFFERS; i++)
+    pipe->buffers[i].data = XNEWVEC (char, BUFFER_SIZE);
+  pthread_mutex_init (&pipe->lock, NULL);
+  pthread_cond_init (&pipe->cond, NULL);
+  input_pipe = pipe;
+  if (pthread_create (&pipe->thread, NULL, input_pipe_run, pipe) != 0)
+    {
+      input_pipe = NULL;
+      pthread_mutex_destroy (&pipe->lock);
+      pthread_cond_destroy (&pipe->cond);
+      for (i = 0; i < INPUT_PIPE_BUFFERS; i++)
+	free (pipe->buffers[i].data);
+      free (pipe);
+    }
+}
+
+/* Copy the next buffer from the input pipe to WHERE, issue the
+   diagnostics that go with it, and return its size.  */
+
+static size_t
+input_pipe_next (char *where)
+{
+  struct input_pipe *pipe = input_pipe;
+  struct input_buffer *buf;
+  unsigned int i;
+  size_t size;
+
+  pthread_mutex_lock (&pipe->lock);
+  while (pipe->count == 0)
+    pthread_cond_wait (&pipe->cond, &pipe->lock);
+  buf = &pipe->buffers[pipe->first];
+  pthread_mutex_unlock (&pipe->lock);
+
+  size = buf->size;
+  memcpy (where, buf->data, size);
+  for (i = 0; i < buf->num_diags; i++)
+    {
+      if (buf->diag_is_error[i])
+	as_bad ("%s", buf->diags[i]);
+      else
+	as_warn ("%s", buf->diags[i]);
+      free (buf->diags[i]);
+    }
+  buf->num_diags = 0;
+
+  pthread_mutex_lock (&pipe->lock);
+  pipe->first = (pipe->first + 1) % INPUT_PIPE_BUFFERS;
+  pipe->count--;
+  pthread_cond_broadcast (&pipe->cond);
+  pthread_mutex_unlock (&pipe->lock);
+
   return size;
 }
+#endif /* HAVE_PTHREAD */
+
+/* Stop the thread of the current file's input pipe, if there is one,
+   once it has finished the buffer it is working on.  */
+
+static void
+input_pipe_pause (void)
+{
+#ifdef HAVE_PTHREAD
+  struct input_pipe *pipe = input_pipe;
+
+  if (pipe == NULL)
+    return;
+  pthread_mutex_lock (&pipe->lock);
+  pipe->paused = true;
+  while (pipe->busy)
+    pthread_cond_wait (&pipe->cond, &pipe->lock);
+  pthread_mutex_unlock (&pipe->lock);
+#endif
+}
+
+/* Let the thread of the current file's input pipe continue.  */
+
+static void
+input_pipe_resume (void)
+{
+#ifdef HAVE_PTHREAD
+  struct input_pipe *pipe = input_pipe;
+
+  if (pipe == NULL)
+    return;
+  pthread_mutex_lock (&pipe->lock);
+  pipe->paused = false;
+  pthread_cond_broadcast (&pipe->cond);
+  pthread_mutex_unlock (&pipe->lock);
+#endif
+}
+
+/* Stop the thread of the current file's input pipe and free it.  */
+
+static void
+input_pipe_close (void)
+{
+#ifdef HAVE_PTHREAD
+  struct input_pipe *pipe = input_pipe;
+  unsigned int i, j;
+
+  if (pipe == NULL)
+    return;
+  pthread_mutex_lock (&pipe->lock);
+  pipe->stop = true;
+  pthread_cond_broadcast (&pipe->cond);
+  pthread_mutex_unlock (&pipe->lock);
+  pthread_join (pipe->thread, NULL);
+
+  pthread_mutex_destroy (&pipe->lock);
+  pthread_cond_destroy (&pipe->cond);
+  for (i = 0; i < INPUT_PIPE_BUFFERS; i++)
+    {
+      for (j = 0; j < pipe->buffers[i].num_diags; j++)
+	free (pipe->buffers[i].diags[j]);
+      free (pipe->buffers[i].diags);
+      free (pipe->buffers[i].diag_is_error);
+      free (pipe->buffers[i].data);
+    }
+  free (pipe);
+  input_pipe = NULL;
+#endif
+}
 
 /* Read a buffer from the input file.  */
 
@@ -239,6 +666,13 @@ input_file_give_next_buffer (char *where /* Where to place 1st character of new
      stdin and stdout, for the case where our input file is stdin.
      Since the assembler shouldn't do any output to stdout, we
      don't bother to synch output and input.  */
+#ifdef HAVE_PTHREAD
+  if (preprocess && input_pipe == NULL)
+    input_pipe_start ();
+  if (input_pipe != NULL)
+    size = input_pipe_next (where);
+  else
+#endif
   if (preprocess)
     size = do_scrub_chars (input_file_get, where, BUFFER_SIZE);
   else
@@ -248,6 +682,8 @@ input_file_give_next_buffer (char *where /* Where to place 1st character of new
     return_value = where + size;
   else
     {
+      input_pipe_close ();
+      input_file_unmap ();
       if (fclose (f_in))
 	as_warn (_("can't close %s: %s"), file_name, xstrerror (errno));
 
@@ -51,6 +51,8 @@
  *
  * input_file_close ()			Closes opened file.
  *
+ * input_file_warn (format, ...)	Issue a warning while preprocessing.
+ *
  * All errors are reported so caller doesn't have to think
  * about I/O errors.
  */
@@ -63,3 +65,4 @@ void input_file_close (void);
 void input_file_end (void);
 void input_file_open (const char *filename, int pre);
 void input_file_pop (char *arg);
+void input_file_warn (const char *format, ...) ATTRIBUTE_PRINTF_1;
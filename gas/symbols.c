@@ -176,39 +176,187 @@ typedef union symbol_entry
   struct symbol sy;
 } symbol_entry_t;
 
-/* Hash function for a symbol_entry.  */
+/* The symbol table.  Looking up symbols is one of the most frequent
+   things the assembler does, so rather than a libiberty hash table,
+   whose slots point at the symbols and so need them to be examined on
+   every probe, this is an open-addressing table whose slots also hold
+   the hash value of the name and, if it is short enough, a copy of
+   the name.  Symbols are never removed from the table.  */
 
-static hashval_t
-hash_symbol_entry (const void *e)
+#define SYMBOL_SLOT_NAME_SIZE 11
+
+struct symbol_slot
 {
-  symbol_entry_t *entry = (symbol_entry_t *) e;
-  if (entry->sy.hash == 0)
-    entry->sy.hash = htab_hash_string (entry->sy.name);
+  /* The symbol, or NULL if the slot is empty.  */
+  symbol_entry_t *sym;
+
+  /* Hash value calculated from the name the symbol was entered with.  */
+  hashval_t hash;
+
+  /* A copy of the symbol's name, if SHORT_NAME is set.  */
+  char name[SYMBOL_SLOT_NAME_SIZE];
+  bool short_name;
+};
+
+struct symbol_table
+{
+  /* The slots.  The number of them is a power of two.  */
+  struct symbol_slot *slots;
+  size_t size;
+  size_t elements;
+
+  /* 32 less the log base 2 of SIZE.  */
+  unsigned int shift;
 
-  return entry->sy.hash;
+  /* Statistics: the number of lookups, the number of slots they
+     examined, and the number of them that did not find what they were
+     looking for in the first slot examined.  */
+  unsigned long searches;
+  unsigned long probes;
+  unsigned long collisions;
+};
+
+/* Grow the table once it is this many quarters full.  */
+#define SYMBOL_TABLE_MAX_LOAD 3
+
+static void
+symbol_slot_set_name (struct symbol_slot *slot, const char *name)
+{
+  size_t len = strlen (name);
+
+  slot->short_name = len < SYMBOL_SLOT_NAME_SIZE;
+  if (slot->short_name)
+    memcpy (slot->name, name, len + 1);
 }
 
-/* Equality function for a symbol_entry.  */
+/* Return the first slot of TABLE to probe for a name hashing to HASH.
+   Successive names often have similar hashes, so mix the bits so that
+   they do not end up in runs of adjacent slots.  */
 
-static int
-eq_symbol_entry (const void *a, const void *b)
+static inline size_t
+symbol_table_index (const struct symbol_table *table, hashval_t hash)
+{
+  return (uint32_t) (hash * 0x9e3779b1u) >> table->shift;
+}
+
+/* Return the slot of TABLE holding the symbol called NAME, whose hash
+   is HASH, or the empty slot where it should go.  */
+
+static struct symbol_slot *
+symbol_table_lookup (struct symbol_table *table, const char *name,
+		     hashval_t hash)
 {
-  const symbol_entry_t *ea = (const symbol_entry_t *) a;
-  const symbol_entry_t *eb = (const symbol_entry_t *) b;
+  size_t mask = table->size - 1;
+  size_t first = symbol_table_index (table, hash);
+  size_t i = first;
+  struct symbol_slot *slot;
 
-  return (ea->sy.hash == eb->sy.hash
-	  && strcmp (ea->sy.name, eb->sy.name) == 0);
+  table->searches++;
+  for (;; i = (i + 1) & mask)
+    {
+      slot = &table->slots[i];
+      table->probes++;
+      if (slot->sym == NULL)
+	return slot;
+      if (slot->hash == hash
+	  && strcmp (slot->short_name ? slot->name : slot->sym->sy.name,
+		     name) == 0)
+	return slot;
+      if (i == first)
+	table->collisions++;
+    }
 }
 
+/* Allocate 1 << LOG2_SIZE empty slots for TABLE.  */
+
+static void
+symbol_table_init (struct symbol_table *table, unsigned int log2_size)
+{
+  table->size = (size_t) 1 << log2_size;
+  table->slots = XCNEWVEC (struct symbol_slot, table->size);
+  table->elements = 0;
+  table->shift = 32 - log2_size;
+}
+
+/* Double the size of TABLE.  */
+
+static void
+symbol_table_expand (struct symbol_table *table)
+{
+  struct symbol_slot *old_slots = table->slots;
+  size_t old_size = table->size;
+  size_t i;
+
+  gas_assert (table->shift > 0);
+  symbol_table_init (table, 32 - table->shift + 1);
+  for (i = 0; i < old_size; i++)
+    if (old_slots[i].sym != NULL)
+      {
+	size_t mask = table->size - 1;
+	size_t j = symbol_table_index (table, old_slots[i].hash);
+
+	while (table->slots[j].sym != NULL)
+	  j = (j + 1) & mask;
+	table->slots[j] = old_slots[i];
+	table->elements++;
+      }
+  free (old_slots);
+}
+
+/* Enter SYM into TABLE, replacing any symbol of the same name.  */
+
+static void
+symbol_table_insert_entry (struct symbol_table *table, symbol_entry_t *sym)
+{
+  struct symbol_slot *slot;
+
+  if (sym->sy.hash == 0)
+    sym->sy.hash = htab_hash_string (sym->sy.name);
+
+  if ((table->elements + 1) * 4 > table->size * SYMBOL_TABLE_MAX_LOAD)
+    symbol_table_expand (table);
+
+  slot = symbol_table_lookup (table, sym->sy.name, sym->sy.hash);
+  if (slot->sym == NULL)
+    {
+      table->elements++;
+      slot->hash = sym->sy.hash;
+      symbol_slot_set_name (slot, sym->sy.name);
+    }
+  slot->sym = sym;
+}
+
+/* Return the symbol called NAME in TABLE, or NULL.  */
+
 static void *
-symbol_entry_find (htab_t table, const char *name)
+symbol_table_find (struct symbol_table *table, const char *name)
 {
-  hashval_t hash = htab_hash_string (name);
-  symbol_entry_t needle = { { { 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 },
-			      hash, name, 0, 0, 0 } };
-  return htab_find_with_hash (table, &needle, hash);
+  struct symbol_slot *slot;
+
+  slot = symbol_table_lookup (table, name, htab_hash_string (name));
+  return slot->sym;
 }
 
+/* SYM, which may be in TABLE, is about to be renamed NAME.  It stays
+   in the slot for its old name, where it is found by neither name,
+   but the copy of the name in that slot must match the symbol.  */
+
+static void
+symbol_table_rename (struct symbol_table *table, symbol_entry_t *sym,
+		     const char *name)
+{
+  size_t mask = table->size - 1;
+  size_t i;
+
+  for (i = symbol_table_index (table, sym->sy.hash);
+       table->slots[i].sym != NULL;
+       i = (i + 1) & mask)
+    if (table->slots[i].sym == sym)
+      {
+	symbol_slot_set_name (&table->slots[i], name);
+	return;
+      }
+}
 
 /* This is non-zero if symbols are case sensitive, which is the
    default.  */
@@ -218,7 +366,7 @@ int symbols_case_sensitive = 1;
 extern int new_broken_words;
 #endif
 
-static htab_t sy_hash;
+static struct symbol_table sy_hash;
 
 /* Below are commented in "symbols.h".  */
 symbolS *symbol_rootP;
@@ -451,7 +599,7 @@ local_symbol_make (const char *name, segT section, fragS *frag, valueT val)
   ret->section = section;
   ret->value = val;
 
-  htab_insert (sy_hash, ret, 1);
+  symbol_table_insert_entry (&sy_hash, (symbol_entry_t *) ret);
 
   return ret;
 }
@@ -718,7 +866,7 @@ symbol_table_insert (symbolS *symbolP)
 {
   know (symbolP);
 
-  htab_insert (sy_hash, symbolP, 1);
+  symbol_table_insert_entry (&sy_hash, (symbol_entry_t *) symbolP);
 }
 
 /* If a symbol name does not exist, create it as undefined, and insert
@@ -943,7 +1091,7 @@ symbol_find_exact (const char *name)
 symbolS *
 symbol_find_exact_noref (const char *name, int noref)
 {
-  symbolS *sym = symbol_entry_find (sy_hash, name);
+  symbolS *sym = symbol_table_find (&sy_hash, name);
 
   /* Any references to the symbol, except for the reference in
      .weakref, must clear this flag, such that the symbol does not
@@ -1808,24 +1956,20 @@ resolve_symbol_value (symbolS *symp)
   return final_val;
 }
 
-/* A static function passed to hash_traverse.  */
-
-static int
-resolve_local_symbol (void **slot, void *arg ATTRIBUTE_UNUSED)
-{
-  symbol_entry_t *entry = *((symbol_entry_t **) slot);
-  if (entry->sy.flags.local_symbol)
-    resolve_symbol_value (&entry->sy);
-
-  return 1;
-}
-
 /* Resolve all local symbols.  */
 
 void
 resolve_local_symbol_values (void)
 {
-  htab_traverse_noresize (sy_hash, resolve_local_symbol, NULL);
+  size_t i;
+
+  for (i = 0; i < sy_hash.size; i++)
+    {
+      symbol_entry_t *entry = sy_hash.slots[i].sym;
+
+      if (entry != NULL && entry->sy.flags.local_symbol)
+	resolve_symbol_value (&entry->sy);
+    }
 }
 
 /* Obtain the current value of a symbol without changing any
@@ -2667,6 +2811,7 @@ S_SET_THREAD_LOCAL (symbolS *s)
 void
 S_SET_NAME (symbolS *s, const char *name)
 {
+  symbol_table_rename (&sy_hash, (symbol_entry_t *) s, name);
   s->name = name;
   if (s->flags.local_symbol)
     return;
@@ -3101,8 +3246,7 @@ symbol_begin (void)
 {
   symbol_lastP = NULL;
   symbol_rootP = NULL;		/* In case we have 0 symbols (!!)  */
-  sy_hash = htab_create_alloc (16, hash_symbol_entry, eq_symbol_entry,
-			       NULL, xcalloc, free);
+  symbol_table_init (&sy_hash, 10);
 
 #if defined (EMIT_SECTION_SYMBOLS) || !defined (RELOC_REQUIRES_SYMBOL)
   abs_symbol.bsym = bfd_abs_section_ptr->symbol;
@@ -3118,7 +3262,9 @@ symbol_begin (void)
 void
 symbol_end (void)
 {
-  htab_delete (sy_hash);
+  free (sy_hash.slots);
+  sy_hash.slots = NULL;
+  sy_hash.size = 0;
 }
 
 void
@@ -3355,7 +3501,9 @@ print_expr (expressionS *exp)
 void
 symbol_print_statistics (FILE *file)
 {
-  htab_print_statistics (file, "symbol table", sy_hash);
+  hash_print_statistics (file, "symbol table", sy_hash.searches,
+			 sy_hash.collisions, sy_hash.elements, sy_hash.size);
+  fprintf (file, "\t%lu probes\n", sy_hash.probes);
   fprintf (file, "%lu mini local symbols created, %lu converted\n",
 	   local_symbol_count, local_symbol_conversion_count);
 }
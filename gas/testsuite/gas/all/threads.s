@@ -0,0 +1,10 @@
+	.warning "line 1"
+	.macro m
+	.warning "macro"
+	.endm
+	m
+	.rept 2
+	.warning "rept"
+	.endr
+	.warning "line 9"
+	.ascii "unterminated
\ No newline at end of file
@@ -1457,37 +1457,40 @@ compress_frag (bool use_zstd, void *ctx, const char *contents, int in_size,
   return total_out_size;
 }
 
-static void
-compress_debug (bfd *abfd, asection *sec, void *xxx ATTRIBUTE_UNUSED)
+/* Return the size of the compression header for debug sections of
+   ABFD, or zero if SEC is not a debug section that should be
+   compressed.  */
+
+static unsigned int
+compress_debug_header_size (bfd *abfd, asection *sec)
 {
   segment_info_type *seginfo = seg_info (sec);
-  bfd_size_type uncompressed_size = sec->size;
   flagword flags = bfd_section_flags (sec);
 
   if (seginfo == NULL
-      || uncompressed_size < 32
+      || sec->size < 32
       || (flags & SEC_HAS_CONTENTS) == 0)
-    return;
+    return 0;
 
   const char *section_name = bfd_section_name (sec);
   if (!startswith (section_name, ".debug_")
       && !startswith (section_name, ".gnu.debuglto_.debug_")
       && !startswith (section_name, ".gnu.linkonce.wi."))
-    return;
-
-  bool use_zstd = abfd->flags & BFD_COMPRESS_ZSTD;
-  void *ctx = compress_init (use_zstd);
-  if (ctx == NULL)
-    return;
+    return 0;
 
-  unsigned int header_size;
   if ((abfd->flags & BFD_COMPRESS_GABI) == 0)
-    header_size = 12;
+    return 12;
   else
-    header_size = bfd_get_compression_header_size (stdoutput, NULL);
+    return bfd_get_compression_header_size (stdoutput, NULL);
+}
 
-  /* Create a new frag to contain the compression header.  */
-  struct obstack *ob = &seginfo->frchainP->frch_obstack;
+/* Start a new frag chain on OB for the compressed contents of a
+   section, made of one frag holding HEADER_SIZE bytes for the
+   compression header.  */
+
+static fragS *
+start_compressed_frags (struct obstack *ob, unsigned int header_size)
+{
   fragS *first_newf = frag_alloc (ob);
   if (obstack_room (ob) < header_size)
     first_newf = frag_alloc (ob);
@@ -1496,11 +1499,59 @@ compress_debug (bfd *abfd, asection *sec, void *xxx ATTRIBUTE_UNUSED)
 			"can't extend frag %lu chars",
 			(unsigned long) header_size),
 	      (unsigned long) header_size);
-  fragS *last_newf = first_newf;
   obstack_blank_fast (ob, header_size);
-  last_newf->fr_type = rs_fill;
-  last_newf->fr_fix = header_size;
-  char *header = last_newf->fr_literal;
+  first_newf->fr_type = rs_fill;
+  first_newf->fr_fix = header_size;
+  return first_newf;
+}
+
+/* Make the frag chain from FIRST_NEWF to LAST_NEWF, which holds
+   COMPRESSED_SIZE bytes starting with room for the compression
+   header, the contents of SEC.  */
+
+static void
+finish_compressed_frags (bfd *abfd, asection *sec, fragS *first_newf,
+			 fragS *last_newf, bfd_size_type compressed_size)
+{
+  segment_info_type *seginfo = seg_info (sec);
+  const char *section_name = bfd_section_name (sec);
+
+  /* Replace the uncompressed frag list with the compressed frag list.  */
+  seginfo->frchainP->frch_root = first_newf;
+  seginfo->frchainP->frch_last = last_newf;
+
+  /* Update the section size and its name.  */
+  bfd_update_compression_header (abfd, (bfd_byte *) first_newf->fr_literal,
+				 sec);
+  bool x = bfd_set_section_size (sec, compressed_size);
+  gas_assert (x);
+  if ((abfd->flags & BFD_COMPRESS_GABI) == 0
+      && section_name[1] == 'd')
+    {
+      char *compressed_name = bfd_debug_name_to_zdebug (abfd, section_name);
+      bfd_rename_section (sec, compressed_name);
+    }
+}
+
+static void
+compress_debug (bfd *abfd, asection *sec, void *xxx ATTRIBUTE_UNUSED)
+{
+  segment_info_type *seginfo = seg_info (sec);
+  bfd_size_type uncompressed_size = sec->size;
+  unsigned int header_size = compress_debug_header_size (abfd, sec);
+
+  if (header_size == 0)
+    return;
+
+  bool use_zstd = abfd->flags & BFD_COMPRESS_ZSTD;
+  void *ctx = compress_init (use_zstd);
+  if (ctx == NULL)
+    return;
+
+  /* Create a new frag to contain the compression header.  */
+  struct obstack *ob = &seginfo->frchainP->frch_obstack;
+  fragS *first_newf = start_compressed_frags (ob, header_size);
+  fragS *last_newf = first_newf;
   bfd_size_type compressed_size = header_size;
 
   /* Stream the frags through the compression engine, adding new frags
@@ -1585,20 +1636,229 @@ compress_debug (bfd *abfd, asection *sec, void *xxx ATTRIBUTE_UNUSED)
   if (compressed_size >= uncompressed_size)
     return;
 
-  /* Replace the uncompressed frag list with the compressed frag list.  */
-  seginfo->frchainP->frch_root = first_newf;
-  seginfo->frchainP->frch_last = last_newf;
+  finish_compressed_frags (abfd, sec, first_newf, last_newf, compressed_size);
+}
 
-  /* Update the section size and its name.  */
-  bfd_update_compression_header (abfd, (bfd_byte *) header, sec);
-  bool x = bfd_set_section_size (sec, compressed_size);
-  gas_assert (x);
-  if ((abfd->flags & BFD_COMPRESS_GABI) == 0
-      && section_name[1] == 'd')
+/* A debug section being compressed by compress_debug_sections.  */
+
+struct compress_debug_job
+{
+  asection *sec;
+  unsigned int header_size;
+
+  /* The uncompressed contents of the section.  */
+  char *contents;
+  bfd_size_type size;
+
+  /* The compressed contents, without the header, and whether they are
+     complete and smaller than the uncompressed contents.  */
+  char *out;
+  bfd_size_type out_size;
+  bool ok;
+};
+
+/* Largest amount of data passed to the compression engine at once.  */
+#define COMPRESS_DEBUG_CHUNK 0x40000000
+
+/* Compress the contents of the Ith section in DATA, an array of
+   compress_debug_job.  This can run on any thread, so it must not
+   allocate on an obstack or issue diagnostics.  Since a section that
+   does not get smaller is kept uncompressed, the output buffer is
+   only as big as a useful result can be.  */
+
+static void
+run_compress_debug_job (void *data, unsigned int i)
+{
+  struct compress_debug_job *job = (struct compress_debug_job *) data + i;
+  bool use_zstd = (stdoutput->flags & BFD_COMPRESS_ZSTD) != 0;
+  bfd_size_type out_max = job->size - job->header_size - 1;
+  const char *next_in = job->contents;
+  bfd_size_type in_left = job->size;
+  void *ctx;
+
+  job->ok = false;
+  job->out_size = 0;
+  job->out = malloc (out_max);
+  if (job->out == NULL)
+    return;
+  ctx = compress_init (use_zstd);
+  if (ctx == NULL)
+    return;
+
+  while (in_left > 0)
     {
-      char *compressed_name = bfd_debug_name_to_zdebug (abfd, section_name);
-      bfd_rename_section (sec, compressed_name);
+      int in_size = (in_left < COMPRESS_DEBUG_CHUNK
+		     ? in_left : COMPRESS_DEBUG_CHUNK);
+      int avail_out = (out_max - job->out_size < COMPRESS_DEBUG_CHUNK
+		       ? out_max - job->out_size : COMPRESS_DEBUG_CHUNK);
+      char *next_out = job->out + job->out_size;
+      const char *start = next_in;
+      int out_size;
+
+      if (avail_out == 0)
+	{
+	  compress_abort (use_zstd, ctx);
+	  return;
+	}
+      out_size = compress_data (use_zstd, ctx, &next_in, &in_size,
+				&next_out, &avail_out);
+      if (out_size < 0)
+	{
+	  compress_abort (use_zstd, ctx);
+	  return;
+	}
+      job->out_size += out_size;
+      in_left -= next_in - start;
     }
+
+  /* Flush the compression state.  */
+  for (;;)
+    {
+      int avail_out = (out_max - job->out_size < COMPRESS_DEBUG_CHUNK
+		       ? out_max - job->out_size : COMPRESS_DEBUG_CHUNK);
+      char *next_out = job->out + job->out_size;
+      int out_size;
+      int x;
+
+      if (avail_out == 0)
+	{
+	  compress_abort (use_zstd, ctx);
+	  return;
+	}
+      x = compress_finish (use_zstd, ctx, &next_out, &avail_out, &out_size);
+      if (x < 0)
+	{
+	  compress_abort (use_zstd, ctx);
+	  return;
+	}
+      job->out_size += out_size;
+      if (x == 0)
+	break;
+    }
+
+  job->ok = true;
+}
+
+/* Copy the contents of the frags of SEC into a single buffer.  */
+
+static char *
+flatten_frags (asection *sec)
+{
+  segment_info_type *seginfo = seg_info (sec);
+  char *contents = XNEWVEC (char, sec->size);
+  char *p = contents;
+
+  for (fragS *f = seginfo->frchainP->frch_root; f; f = f->fr_next)
+    {
+      offsetT count;
+
+      gas_assert (f->fr_type == rs_fill);
+      memcpy (p, f->fr_literal, f->fr_fix);
+      p += f->fr_fix;
+      count = f->fr_offset;
+      gas_assert (count >= 0);
+      if (f->fr_var)
+	while (count--)
+	  {
+	    memcpy (p, f->fr_literal + f->fr_fix, f->fr_var);
+	    p += f->fr_var;
+	  }
+    }
+  gas_assert ((bfd_size_type) (p - contents) == sec->size);
+  return contents;
+}
+
+/* Append SIZE bytes from DATA to the frag chain ending in *LAST_NEWF,
+   adding new frags to OB as necessary.  */
+
+static void
+append_to_frags (const char *data, bfd_size_type size, fragS **last_newf,
+		 struct obstack *ob)
+{
+  while (size > 0)
+    {
+      size_t avail_out = obstack_room (ob);
+
+      if (avail_out == 0)
+	{
+	  fragS *newf;
+
+	  obstack_finish (ob);
+	  newf = frag_alloc (ob);
+	  newf->fr_type = rs_fill;
+	  (*last_newf)->fr_next = newf;
+	  *last_newf = newf;
+	  avail_out = obstack_room (ob);
+	}
+      if (avail_out == 0)
+	as_fatal (_("can't extend frag"));
+      if (avail_out > size)
+	avail_out = size;
+      memcpy (obstack_next_free (ob), data, avail_out);
+      obstack_blank_fast (ob, avail_out);
+      (*last_newf)->fr_fix += avail_out;
+      data += avail_out;
+      size -= avail_out;
+    }
+}
+
+/* Compress the debug sections of ABFD, with the same result as calling
+   compress_debug on each, but doing the compression itself for all
+   the sections at once on several threads.  The frags of each section
+   are copied to a buffer first, and the compressed output is made
+   into frags afterwards, since neither can be done off the main
+   thread.  */
+
+static void
+compress_debug_sections (bfd *abfd)
+{
+  struct compress_debug_job *jobs;
+  unsigned int njobs = 0;
+  unsigned int i;
+  asection *sec;
+
+  for (sec = abfd->sections; sec != NULL; sec = sec->next)
+    if (compress_debug_header_size (abfd, sec) != 0)
+      njobs++;
+  if (njobs == 0)
+    return;
+
+  jobs = XCNEWVEC (struct compress_debug_job, njobs);
+  i = 0;
+  for (sec = abfd->sections; sec != NULL; sec = sec->next)
+    {
+      unsigned int header_size = compress_debug_header_size (abfd, sec);
+
+      if (header_size == 0)
+	continue;
+      jobs[i].sec = sec;
+      jobs[i].header_size = header_size;
+      jobs[i].contents = flatten_frags (sec);
+      jobs[i].size = sec->size;
+      i++;
+    }
+
+  bfd_run_parallel (njobs, run_compress_debug_job, jobs);
+
+  for (i = 0; i < njobs; i++)
+    {
+      struct compress_debug_job *job = &jobs[i];
+
+      if (job->ok)
+	{
+	  segment_info_type *seginfo = seg_info (job->sec);
+	  struct obstack *ob = &seginfo->frchainP->frch_obstack;
+	  fragS *first_newf = start_compressed_frags (ob, job->header_size);
+	  fragS *last_newf = first_newf;
+
+	  append_to_frags (job->out, job->out_size, &last_newf, ob);
+	  finish_compressed_frags (abfd, job->sec, first_newf, last_newf,
+				   job->header_size + job->out_size);
+	}
+      free (job->contents);
+      free (job->out);
+    }
+  free (jobs);
 }
 
 #ifndef md_generate_nops
@@ -2527,7 +2787,11 @@ write_object_file (void)
       else if (flag_compress_debug == COMPRESS_DEBUG_ZSTD)
 	flags = BFD_COMPRESS | BFD_COMPRESS_GABI | BFD_COMPRESS_ZSTD;
       stdoutput->flags |= flags & bfd_applicable_file_flags (stdoutput);
-      if ((stdoutput->flags & BFD_COMPRESS) != 0)
+      if ((stdoutput->flags & BFD_COMPRESS) == 0)
+	;
+      else if (bfd_get_thread_count () > 1)
+	compress_debug_sections (stdoutput);
+      else
 	bfd_map_over_sections (stdoutput, compress_debug, (char *) 0);
     }
 
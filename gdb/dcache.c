@@ -83,6 +83,12 @@ static unsigned dcache_size = DCACHE_DEFAULT_SIZE;
 #define DCACHE_DEFAULT_LINE_SIZE 64
 static unsigned dcache_line_size = DCACHE_DEFAULT_LINE_SIZE;
 
+/* The maximum number of lines read from the target at once when
+   consecutive misses suggest sequential access, such as when
+   unwinding the stack.  Zero or one disables read-ahead.  */
+#define DCACHE_DEFAULT_READ_AHEAD 16
+static unsigned dcache_read_ahead_lines = DCACHE_DEFAULT_READ_AHEAD;
+
 /* Each cache block holds LINE_SIZE bytes of data
    starting at a multiple-of-LINE_SIZE address.  */
 
@@ -98,6 +104,7 @@ struct dcache_block
 
   CORE_ADDR addr;		/* address of data */
   int refs;			/* # hits */
+  bool read_ahead;		/* read ahead and not used yet */
   gdb_byte data[1];		/* line_size bytes at given address */
 };
 
@@ -120,6 +127,22 @@ struct dcache_struct
   /* The process target of last inferior to use the cache or
      nullptr.  */
   process_stratum_target *proc_target;
+
+  /* The number of lines read by the last miss, or zero if no line
+     has been read since the cache was invalidated.  */
+  unsigned ahead;
+
+  /* The line addresses that the next miss would have if the access
+     pattern continued upwards or downwards, respectively.  */
+  CORE_ADDR next_up;
+  CORE_ADDR next_down;
+
+  /* Statistics: the number of lines read because of a miss, the
+     number of lines read ahead of such a miss, and how many of those
+     were used later.  */
+  ULONGEST miss_count;
+  ULONGEST read_ahead_count;
+  ULONGEST read_ahead_hit_count;
 };
 
 typedef void (block_func) (struct dcache_block *block, void *param);
@@ -128,6 +151,8 @@ static struct dcache_block *dcache_hit (DCACHE *dcache, CORE_ADDR addr);
 
 static int dcache_read_line (DCACHE *dcache, struct dcache_block *db);
 
+static int dcache_read_ahead (DCACHE *dcache, struct dcache_block *db);
+
 static struct dcache_block *dcache_alloc (DCACHE *dcache, CORE_ADDR addr);
 
 static bool dcache_enabled_p = false; /* OBSOLETE */
@@ -254,6 +279,7 @@ dcache_invalidate (DCACHE *dcache)
   dcache->size = 0;
   dcache->ptid = null_ptid;
   dcache->proc_target = nullptr;
+  dcache->ahead = 0;
 
   if (dcache->line_size != dcache_line_size)
     {
@@ -266,6 +292,14 @@ dcache_invalidate (DCACHE *dcache)
     }
 }
 
+/* See dcache.h.  */
+
+unsigned
+dcache_get_line_size (void)
+{
+  return dcache_line_size;
+}
+
 /* Invalidate the line associated with ADDR.  */
 
 static void
@@ -301,6 +335,21 @@ dcache_hit (DCACHE *dcache, CORE_ADDR addr)
   return db;
 }
 
+/* See dcache.h.  */
+
+bool
+dcache_contains (DCACHE *dcache, CORE_ADDR addr)
+{
+  /* The next read invalidates a cache left by another thread, as in
+     dcache_read_memory_partial, so nothing in it counts.  */
+  if (current_inferior ()->process_target () != dcache->proc_target
+      || inferior_ptid != dcache->ptid)
+    return false;
+
+  return splay_tree_lookup (dcache->tree,
+			    (splay_tree_key) MASK (dcache, addr)) != NULL;
+}
+
 /* Fill a cache line from target memory.
    The result is 1 for success, 0 if the (entire) cache line
    wasn't readable.  */
@@ -350,6 +399,107 @@ dcache_read_line (DCACHE *dcache, struct dcache_block *db)
   return 1;
 }
 
+/* Fill DB, a line that was just allocated because of a miss, along
+   with the lines following or preceding it, if the last misses
+   suggest that memory is being read sequentially in that direction.
+   The number of lines read at once doubles with each such miss, up to
+   the "set dcache read-ahead" limit, so that walking a deep stack
+   takes few round trips to the target.
+
+   The result is 1 if DB was filled, 0 if it should be filled with
+   dcache_read_line instead.  */
+
+static int
+dcache_read_ahead (DCACHE *dcache, struct dcache_block *db)
+{
+  CORE_ADDR line_size = dcache->line_size;
+  CORE_ADDR addr = db->addr;
+  bool up;
+
+  if (dcache->ahead > 0 && addr == dcache->next_up)
+    up = true;
+  else if (dcache->ahead > 0 && addr == dcache->next_down)
+    up = false;
+  else
+    {
+      /* Not a sequential access; start over.  */
+      dcache->ahead = 1;
+      dcache->next_up = addr + line_size;
+      dcache->next_down = addr - line_size;
+      return 0;
+    }
+
+  /* Don't read more than fits in the cache alongside DB, nor more
+     than the target can transfer at once.  */
+  ULONGEST max_lines = std::min<ULONGEST> (dcache_read_ahead_lines,
+					   dcache_size - 1);
+  ULONGEST xfer_limit
+    = current_inferior ()->top_target ()->get_memory_xfer_limit ();
+  max_lines = std::min<ULONGEST> (max_lines, xfer_limit / line_size);
+
+  ULONGEST lines = std::min<ULONGEST> (2 * dcache->ahead, max_lines);
+  CORE_ADDR start = up ? addr : addr - (lines - 1) * line_size;
+  CORE_ADDR end = start + lines * line_size;
+
+  /* The whole block must be readable, and in a single memory
+     region.  */
+  struct mem_region *region = lookup_mem_region (start);
+  if (lines < 2
+      || (up ? end < start : start > addr)
+      || region->attrib.mode == MEM_WO
+      || (region->hi != 0 && end > region->hi))
+    {
+      dcache->ahead = 1;
+      dcache->next_up = addr + line_size;
+      dcache->next_down = addr - line_size;
+      return 0;
+    }
+
+  gdb::byte_vector buf (lines * line_size);
+  if (target_read_raw_memory (start, buf.data (), buf.size ()) != 0)
+    {
+      /* Perhaps we ran off the end of the mapped memory.  Fall back
+	 to reading just DB.  */
+      dcache->ahead = 1;
+      dcache->next_up = addr + line_size;
+      dcache->next_down = addr - line_size;
+      return 0;
+    }
+
+  for (ULONGEST i = 0; i < lines; i++)
+    {
+      CORE_ADDR line = start + i * line_size;
+      struct dcache_block *b = db;
+
+      if (line != addr)
+	{
+	  /* Keep the lines we already have.  */
+	  if (splay_tree_lookup (dcache->tree, (splay_tree_key) line) != NULL)
+	    continue;
+
+	  b = dcache_alloc (dcache, line);
+	  b->read_ahead = true;
+	  dcache->read_ahead_count++;
+	}
+
+      memcpy (b->data, buf.data () + i * line_size, line_size);
+    }
+
+  dcache->ahead = lines;
+  if (up)
+    {
+      dcache->next_up = end;
+      dcache->next_down = addr - line_size;
+    }
+  else
+    {
+      dcache->next_up = addr + line_size;
+      dcache->next_down = start - line_size;
+    }
+
+  return 1;
+}
+
 /* Get a free cache block, put or keep it on the valid list,
    and return its address.  */
 
@@ -381,6 +531,7 @@ dcache_alloc (DCACHE *dcache, CORE_ADDR addr)
 
   db->addr = MASK (dcache, addr);
   db->refs = 0;
+  db->read_ahead = false;
 
   /* Put DB at the end of the list, it's the newest.  */
   append_block (&dcache->oldest, db);
@@ -404,10 +555,17 @@ dcache_peek_byte (DCACHE *dcache, CORE_ADDR addr, gdb_byte *ptr)
   if (!db)
     {
       db = dcache_alloc (dcache, addr);
+      dcache->miss_count++;
 
-      if (!dcache_read_line (dcache, db))
+      if (!dcache_read_ahead (dcache, db)
+	  && !dcache_read_line (dcache, db))
 	 return 0;
     }
+  else if (db->read_ahead)
+    {
+      db->read_ahead = false;
+      dcache->read_ahead_hit_count++;
+    }
 
   *ptr = db->data[XFORM (dcache, addr)];
   return 1;
@@ -459,6 +617,10 @@ dcache_init (void)
   dcache->line_size = dcache_line_size;
   dcache->ptid = null_ptid;
   dcache->proc_target = nullptr;
+  dcache->ahead = 0;
+  dcache->miss_count = 0;
+  dcache->read_ahead_count = 0;
+  dcache->read_ahead_hit_count = 0;
 
   return dcache;
 }
@@ -643,6 +805,11 @@ dcache_info_1 (DCACHE *dcache, const char *exp)
       n = splay_tree_successor (dcache->tree, n->key);
     }
 
+  gdb_printf (_("Read-ahead: %s misses, %s lines read ahead, "
+		"%s of them used\n"),
+	      pulongest (dcache->miss_count),
+	      pulongest (dcache->read_ahead_count),
+	      pulongest (dcache->read_ahead_hit_count));
   gdb_printf (_("Cache state: %d active lines, %d hits\n"), i, refcount);
 }
 
@@ -725,4 +892,14 @@ Show number of dcache lines."),
 			     set_dcache_size,
 			     NULL,
 			     &dcache_set_list, &dcache_show_list);
+  add_setshow_zuinteger_cmd ("read-ahead", class_obscure,
+			     &dcache_read_ahead_lines, _("\
+Set the maximum number of dcache lines read at once."), _("\
+Show the maximum number of dcache lines read at once."), _("\
+When consecutive misses show that memory is being read sequentially,\n\
+as when unwinding the stack, the dcache reads up to this many lines\n\
+from the target at once.  Zero or one disables read-ahead."),
+			     NULL,
+			     NULL,
+			     &dcache_set_list, &dcache_show_list);
 }
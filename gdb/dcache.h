@@ -52,4 +52,11 @@ void dcache_update (DCACHE *dcache, enum target_xfer_status status,
 		    CORE_ADDR memaddr, const gdb_byte *myaddr,
 		    ULONGEST len);
 
+/* Return the size of the lines the dcache reads from the target.  */
+unsigned dcache_get_line_size (void);
+
+/* Return true if DCACHE holds the line containing ADDR, for the
+   current thread.  */
+bool dcache_contains (DCACHE *dcache, CORE_ADDR addr);
+
 #endif /* DCACHE_H */
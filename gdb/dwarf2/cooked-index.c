@@ -442,8 +442,10 @@ cooked_index_shard::wait (bool allow_quit) const
     m_future.wait ();
 }
 
-cooked_index::cooked_index (vec_type &&vec, dwarf2_per_bfd *per_bfd)
-  : m_vector (std::move (vec))
+cooked_index::cooked_index (vec_type &&vec, dwarf2_per_bfd *per_bfd,
+			    bool from_cache)
+  : m_vector (std::move (vec)),
+    m_from_cache (from_cache)
 {
   for (auto &idx : m_vector)
     idx->finalize ();
@@ -627,8 +629,10 @@ cooked_index::maybe_write_index (dwarf2_per_bfd *per_bfd)
   /* Wait for finalization.  */
   wait ();
 
-  /* (maybe) store an index in the cache.  */
-  global_index_cache.store (per_bfd);
+  /* (maybe) store an index in the cache.  There is no point in doing
+     this if the index was just read from there.  */
+  if (!m_from_cache)
+    global_index_cache.store (per_bfd);
 }
 
 /* Wait for all the index cache entries to be written before gdb
@@ -366,7 +366,11 @@ class cooked_index : public dwarf_scanner_base
      object.  */
   using vec_type = std::vector<std::unique_ptr<cooked_index_shard>>;
 
-  cooked_index (vec_type &&vec, dwarf2_per_bfd *per_bfd);
+  /* Take ownership of the shards in VEC.  FROM_CACHE is true if the
+     shards were read back from the index cache, in which case the
+     index is not written to the cache again.  */
+  cooked_index (vec_type &&vec, dwarf2_per_bfd *per_bfd,
+		bool from_cache = false);
   ~cooked_index () override;
   DISABLE_COPY_AND_ASSIGN (cooked_index);
 
@@ -440,6 +444,9 @@ class cooked_index : public dwarf_scanner_base
 
   /* A future that tracks when the 'index_write' method is done.  */
   std::future<void> m_write_future;
+
+  /* True if this index was loaded from the index cache.  */
+  bool m_from_cache;
 };
 
 #endif /* GDB_DWARF2_COOKED_INDEX_H */
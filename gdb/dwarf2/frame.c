@@ -1104,6 +1104,23 @@ incomplete CFI data; unspecified registers (e.g., %s) at %s"),
       && fs.regs.reg[fs.retaddr_column].how == DWARF2_FRAME_REG_UNDEFINED)
     cache->undefined_retaddr = 1;
 
+  /* The registers this frame saved on the stack are about to be read
+     to unwind the caller; let the target fetch them all at once.  */
+  {
+    std::vector<mem_range> slots;
+    int regnum;
+
+    for (regnum = 0; regnum < num_regs; regnum++)
+      if (cache->reg[regnum].how == DWARF2_FRAME_REG_SAVED_OFFSET)
+	slots.emplace_back (cache->cfa + cache->reg[regnum].loc.offset,
+			    register_size (gdbarch, regnum));
+    if (cache->retaddr_reg.how == DWARF2_FRAME_REG_SAVED_OFFSET)
+      slots.emplace_back (cache->cfa + cache->retaddr_reg.loc.offset,
+			  cache->addr_size);
+
+    target_prefetch_memory (slots);
+  }
+
   dwarf2_tailcall_sniffer_first (this_frame, &cache->tailcall_cache,
 				 (entry_cfa_sp_offset_p
 				  ? &entry_cfa_sp_offset : NULL));
@@ -149,6 +149,17 @@ index_cache::store (dwarf2_per_bfd *per_bfd)
       write_dwarf_index (per_bfd, m_dir.c_str (),
 			 build_id_str.c_str (), dwz_build_id_ptr,
 			 dw_index_kind::GDB_INDEX);
+
+      /* Also write the serialized cooked index.  This is not done
+	 when a dwz, DWO or DWP file is involved, because the set of
+	 units then depends on files that the build id does not
+	 cover.  */
+      if (dwz == nullptr
+	  && per_bfd->dwo_files == nullptr
+	  && per_bfd->dwp_file == nullptr)
+	write_dwarf_index (per_bfd, m_dir.c_str (),
+			   build_id_str.c_str (), nullptr,
+			   dw_index_kind::COOKED_INDEX);
     }
   catch (const gdb_exception_error &except)
     {
@@ -175,8 +186,9 @@ struct index_cache_resource_mmap final : public index_cache_resource
 /* See dwarf-index-cache.h.  */
 
 gdb::array_view<const gdb_byte>
-index_cache::lookup_gdb_index (const bfd_build_id *build_id,
-			       std::unique_ptr<index_cache_resource> *resource)
+index_cache::lookup_index_file (const bfd_build_id *build_id,
+				const char *suffix,
+				std::unique_ptr<index_cache_resource> *resource)
 {
   if (!enabled ())
     return {};
@@ -188,8 +200,8 @@ index_cache::lookup_gdb_index (const bfd_build_id *build_id,
       return {};
     }
 
-  /* Compute where we would expect a gdb index file for this build id to be.  */
-  std::string filename = make_index_filename (build_id, INDEX4_SUFFIX);
+  /* Compute where we would expect an index file for this build id to be.  */
+  std::string filename = make_index_filename (build_id, suffix);
 
   try
     {
@@ -221,8 +233,9 @@ index_cache::lookup_gdb_index (const bfd_build_id *build_id,
 /* See dwarf-index-cache.h.  This is a no-op on unsupported systems.  */
 
 gdb::array_view<const gdb_byte>
-index_cache::lookup_gdb_index (const bfd_build_id *build_id,
-			       std::unique_ptr<index_cache_resource> *resource)
+index_cache::lookup_index_file (const bfd_build_id *build_id,
+				const char *suffix,
+				std::unique_ptr<index_cache_resource> *resource)
 {
   return {};
 }
@@ -231,6 +244,24 @@ index_cache::lookup_gdb_index (const bfd_build_id *build_id,
 
 /* See dwarf-index-cache.h.  */
 
+gdb::array_view<const gdb_byte>
+index_cache::lookup_gdb_index (const bfd_build_id *build_id,
+			       std::unique_ptr<index_cache_resource> *resource)
+{
+  return lookup_index_file (build_id, INDEX4_SUFFIX, resource);
+}
+
+/* See dwarf-index-cache.h.  */
+
+gdb::array_view<const gdb_byte>
+index_cache::lookup_cooked_index (const bfd_build_id *build_id,
+				  std::unique_ptr<index_cache_resource> *resource)
+{
+  return lookup_index_file (build_id, COOKED_INDEX_SUFFIX, resource);
+}
+
+/* See dwarf-index-cache.h.  */
+
 std::string
 index_cache::make_index_filename (const bfd_build_id *build_id,
 				  const char *suffix) const
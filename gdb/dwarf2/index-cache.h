@@ -67,6 +67,13 @@ class index_cache
   lookup_gdb_index (const bfd_build_id *build_id,
 		    std::unique_ptr<index_cache_resource> *resource);
 
+  /* Like lookup_gdb_index, but look for a serialized cooked index.
+     This is preferred over the .gdb_index file, because it can be
+     turned back into a cooked index without reading the DWARF.  */
+  gdb::array_view<const gdb_byte>
+  lookup_cooked_index (const bfd_build_id *build_id,
+		       std::unique_ptr<index_cache_resource> *resource);
+
   /* Return the number of cache hits.  */
   unsigned int n_hits () const
   { return m_n_hits; }
@@ -91,6 +98,13 @@ class index_cache
 
 private:
 
+  /* Look for the file with build id BUILD_ID and suffix SUFFIX in the
+     cache directory.  See lookup_gdb_index for the meaning of the
+     return value and RESOURCE.  */
+  gdb::array_view<const gdb_byte>
+  lookup_index_file (const bfd_build_id *build_id, const char *suffix,
+		     std::unique_ptr<index_cache_resource> *resource);
+
   /* Compute the absolute filename where the index of the objfile with build
      id BUILD_ID will be stored.  SUFFIX is appended at the end of the
      filename.  */
@@ -24,6 +24,12 @@
 #define INDEX4_SUFFIX ".gdb-index"
 #define INDEX5_SUFFIX ".debug_names"
 #define DEBUG_STR_SUFFIX ".debug_str"
+#define COOKED_INDEX_SUFFIX ".gdb-cooked"
+
+/* The version of the serialized cooked index written to the index
+   cache.  Bump this whenever the layout written by index-write.c
+   changes.  */
+#define COOKED_INDEX_CACHE_VERSION 1
 
 /* All offsets in the index are of this type.  It must be
    architecture-independent.  */
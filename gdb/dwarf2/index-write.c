@@ -28,6 +28,7 @@
 #include "gdbsupport/gdb_unlinker.h"
 #include "gdbsupport/pathstuff.h"
 #include "gdbsupport/scoped_fd.h"
+#include "gdbsupport/version.h"
 #include "complaints.h"
 #include "dwarf2/index-common.h"
 #include "dwarf2.h"
@@ -1394,6 +1395,132 @@ write_debug_names (dwarf2_per_bfd *per_bfd, cooked_index *table,
   assert_file_size (out_file, expected_bytes);
 }
 
+/* Write TABLE to OUT_FILE in the serialized cooked index format used
+   by the index cache.  Unlike .gdb_index and .debug_names, this keeps
+   everything the cooked index needs -- tags, flags, parent links and
+   the address map -- so that read_cooked_index_cache can rebuild the
+   index without scanning the DWARF.  The layout, all little-endian, is:
+
+   header:   offset_type version, number of units, number of entries,
+	     number of address entries, size of the constant pool and
+	     the constant pool offset of the GDB version string
+   units:    8-byte section offset and length, then offset_type flags
+	     (bit 0: dwz, bit 1: type unit), unit type and language
+   entries:  8-byte DIE offset, then offset_type tag, flags, unit index,
+	     constant pool offset of the name and index of the parent
+	     entry (or ~0 for none)
+   address:  the same entries as the .gdb_index address area
+   constant pool: NUL-terminated strings.
+
+   Entries are written so that a parent always precedes its children,
+   which lets the reader resolve parent links in a single pass.  */
+
+static void
+write_cooked_index_cache (dwarf2_per_bfd *per_bfd, cooked_index *table,
+			  FILE *out_file)
+{
+  cu_index_map cu_index_htab;
+  cu_index_htab.reserve (per_bfd->all_units.size ());
+
+  data_buf unit_list;
+  for (int i = 0; i < per_bfd->all_units.size (); ++i)
+    {
+      dwarf2_per_cu_data *per_cu = per_bfd->all_units[i].get ();
+
+      const auto insertpair = cu_index_htab.emplace (per_cu, i);
+      gdb_assert (insertpair.second);
+
+      unit_list.append_uint (8, BFD_ENDIAN_LITTLE,
+			     to_underlying (per_cu->sect_off));
+      unit_list.append_uint (8, BFD_ENDIAN_LITTLE, per_cu->length ());
+      unit_list.append_offset ((per_cu->is_dwz ? 1 : 0)
+			       | (per_cu->is_debug_types ? 2 : 0));
+      unit_list.append_offset (per_cu->unit_type (false));
+      unit_list.append_offset (per_cu->lang (false));
+    }
+
+  data_buf constant_pool;
+  std::unordered_map<const char *, offset_type> name_offsets;
+  auto add_string = [&] (const char *str)
+    {
+      const auto insertpair = name_offsets.emplace (str,
+						    constant_pool.size ());
+      if (insertpair.second)
+	constant_pool.append_cstr0 (str);
+      return insertpair.first->second;
+    };
+
+  const offset_type version_offset = add_string (version);
+
+  /* Entries created during finalization (e.g., the synthesized Ada
+     package entries) are not part of ALL_ENTRIES; links to them are
+     dropped and recreated when the index is finalized again.  */
+  std::unordered_set<const cooked_index_entry *> members;
+  for (const cooked_index_entry *entry : table->all_entries ())
+    members.insert (entry);
+
+  std::unordered_map<const cooked_index_entry *, offset_type> entry_index;
+  std::vector<const cooked_index_entry *> chain;
+  data_buf entry_list;
+  for (const cooked_index_entry *entry : table->all_entries ())
+    {
+      chain.clear ();
+      for (; (entry != nullptr
+	      && members.count (entry) != 0
+	      && entry_index.count (entry) == 0);
+	   entry = entry->parent_entry)
+	chain.push_back (entry);
+
+      for (auto iter = chain.rbegin (); iter != chain.rend (); ++iter)
+	{
+	  const cooked_index_entry *item = *iter;
+
+	  const auto it = cu_index_htab.find (item->per_cu);
+	  gdb_assert (it != cu_index_htab.cend ());
+
+	  offset_type parent = (offset_type) -1;
+	  if (item->parent_entry != nullptr)
+	    {
+	      const auto parent_it = entry_index.find (item->parent_entry);
+	      if (parent_it != entry_index.cend ())
+		parent = parent_it->second;
+	    }
+
+	  entry_list.append_uint (8, BFD_ENDIAN_LITTLE,
+				  to_underlying (item->die_offset));
+	  entry_list.append_offset (item->tag);
+	  entry_list.append_offset (item->flags);
+	  entry_list.append_offset (it->second);
+	  entry_list.append_offset (add_string (item->name));
+	  entry_list.append_offset (parent);
+
+	  entry_index.emplace (item, entry_index.size ());
+	}
+    }
+
+  data_buf addr_vec;
+  for (auto map : table->get_addrmaps ())
+    write_address_map (map, addr_vec, cu_index_htab);
+
+  data_buf header;
+  header.append_offset (COOKED_INDEX_CACHE_VERSION);
+  header.append_offset (per_bfd->all_units.size ());
+  header.append_offset (entry_index.size ());
+  header.append_offset (addr_vec.size () / (2 * 8 + sizeof (offset_type)));
+  header.append_offset (constant_pool.size ());
+  header.append_offset (version_offset);
+
+  header.file_write (out_file);
+  unit_list.file_write (out_file);
+  entry_list.file_write (out_file);
+  addr_vec.file_write (out_file);
+  constant_pool.file_write (out_file);
+
+  assert_file_size (out_file, (header.size () + unit_list.size ()
+			       + entry_list.size () + addr_vec.size ()
+			       + constant_pool.size ()));
+}
+
 /* This represents an index file being written (work-in-progress).
 
    The data is initially written to a temporary file.  When the finalize method
@@ -1463,7 +1590,9 @@ write_dwarf_index (dwarf2_per_bfd *per_bfd, const char *dir,
     error (_("Cannot make an index when the file has multiple .debug_types sections"));
 
   const char *index_suffix = (index_kind == dw_index_kind::DEBUG_NAMES
-			      ? INDEX5_SUFFIX : INDEX4_SUFFIX);
+			      ? INDEX5_SUFFIX
+			      : index_kind == dw_index_kind::COOKED_INDEX
+			      ? COOKED_INDEX_SUFFIX : INDEX4_SUFFIX);
 
   index_wip_file objfile_index_wip (dir, basename, index_suffix);
   gdb::optional<index_wip_file> dwz_index_wip;
@@ -1480,6 +1609,12 @@ write_dwarf_index (dwarf2_per_bfd *per_bfd, const char *dir,
 
       str_wip_file.finalize ();
     }
+  else if (index_kind == dw_index_kind::COOKED_INDEX)
+    {
+      gdb_assert (!dwz_index_wip.has_value ());
+      write_cooked_index_cache (per_bfd, table,
+				objfile_index_wip.out_file.get ());
+    }
   else
     write_gdbindex (per_bfd, table, objfile_index_wip.out_file.get (),
 		    (dwz_index_wip.has_value ()
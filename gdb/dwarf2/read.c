@@ -86,6 +86,7 @@
 #include <algorithm>
 #include <unordered_map>
 #include "gdbsupport/selftest.h"
+#include "gdbsupport/version.h"
 #include "rust-lang.h"
 #include "gdbsupport/pathstuff.h"
 #include "count-one-bits.h"
@@ -608,6 +609,15 @@ class cutu_reader : public die_reader_specs
     return std::move (m_abbrev_table_holder);
   }
 
+  /* Release the new CU, transferring ownership to the caller instead
+     of putting it on the chain.  This cannot be done for dummy
+     CUs.  */
+  std::unique_ptr<dwarf2_cu> release_cu ()
+  {
+    gdb_assert (!dummy_p);
+    return std::move (m_new_cu);
+  }
+
 private:
   void init_tu_and_read_dwo_dies (dwarf2_per_cu_data *this_cu,
 				  dwarf2_per_objfile *per_objfile,
@@ -736,6 +746,18 @@ show_dwarf_max_cache_age (struct ui_file *file, int from_tty,
 		      "DWARF compilation units is %s.\n"),
 	      value);
 }
+
+/* When true, the DIEs of units that are expanded as a batch are read
+   on the worker threads.  See dw2_expand_units.  */
+static bool dwarf_parallel_expansion = true;
+static void
+show_dwarf_parallel_expansion (struct ui_file *file, int from_tty,
+			       struct cmd_list_element *c, const char *value)
+{
+  gdb_printf (file, _("Reading DWARF units on worker threads when "
+		      "expanding several of them is %s.\n"),
+	      value);
+}
 
 /* local function prototypes */
 
@@ -1054,6 +1076,10 @@ static void load_full_comp_unit (dwarf2_per_cu_data *per_cu,
 				 bool skip_partial,
 				 enum language pretend_language);
 
+static std::unique_ptr<dwarf2_cu> preload_full_comp_unit
+  (dwarf2_per_cu_data *this_cu, dwarf2_per_objfile *per_objfile,
+   bool skip_partial, abbrev_cache *cache);
+
 static void process_full_comp_unit (dwarf2_cu *cu,
 				    enum language pretend_language);
 
@@ -1697,8 +1723,14 @@ load_cu (dwarf2_per_cu_data *per_cu, dwarf2_per_objfile *per_objfile,
   if (per_cu->is_debug_types)
     load_full_type_unit (per_cu, per_objfile);
   else
-    load_full_comp_unit (per_cu, per_objfile, per_objfile->get_cu (per_cu),
-			 skip_partial, language_minimal);
+    {
+      dwarf2_cu *existing_cu = per_objfile->get_cu (per_cu);
+
+      /* The DIEs may already have been read by dw2_expand_units.  */
+      if (existing_cu == nullptr || existing_cu->dies == nullptr)
+	load_full_comp_unit (per_cu, per_objfile, existing_cu,
+			     skip_partial, language_minimal);
+    }
 
   dwarf2_cu *cu = per_objfile->get_cu (per_cu);
   if (cu == nullptr)
@@ -1768,6 +1800,115 @@ dw2_instantiate_symtab (dwarf2_per_cu_data *per_cu,
   return per_objfile->get_symtab (per_cu);
 }
 
+/* Call EXPAND on each unit of PER_CUS, in order, stopping as soon as
+   it returns false.  Return false in that case, true otherwise.
+   EXPAND is expected to instantiate the symtab of the unit.
+
+   When "maint set dwarf parallel-expansion" is on, the DIEs of the
+   comp units are first read on the worker threads, a batch at a time.
+   Each unit's DIEs are put on PER_OBJFILE's chain just before EXPAND
+   is called for it, so that only building the symtab -- which is not
+   thread-safe -- is done serially on the main thread.  SKIP_PARTIAL
+   is passed to the DIE reader as for dw2_instantiate_symtab.  */
+
+static bool
+dw2_expand_units (dwarf2_per_objfile *per_objfile,
+		  const std::vector<dwarf2_per_cu_data *> &per_cus,
+		  bool skip_partial,
+		  gdb::function_view<bool (dwarf2_per_cu_data *)> expand)
+{
+  dwarf2_per_bfd *per_bfd = per_objfile->per_bfd;
+  const size_t n_threads = gdb::thread_pool::g_thread_pool->thread_count ();
+
+  /* Reading DIEs is only thread-safe once the cooked index has been
+     built -- at that point, all the sections have been read in -- and
+     when no unit refers to a DWO or DWP file, which would have to be
+     opened on the fly.  */
+  bool parallel = (dwarf_parallel_expansion
+		   && n_threads > 0
+		   && per_cus.size () > 1
+		   && (dynamic_cast<cooked_index *> (per_bfd->index_table.get ())
+		       != nullptr)
+		   && per_bfd->dwo_files == nullptr
+		   && get_dwp_file (per_objfile) == nullptr);
+
+  if (!parallel)
+    {
+      for (dwarf2_per_cu_data *per_cu : per_cus)
+	if (!expand (per_cu))
+	  return false;
+      return true;
+    }
+
+  /* Bound the number of DIE trees held in memory at once.  */
+  const size_t batch_size = 8 * n_threads;
+
+  for (size_t start = 0; start < per_cus.size (); start += batch_size)
+    {
+      const size_t end = std::min (per_cus.size (), start + batch_size);
+
+      std::vector<dwarf2_per_cu_data *> to_read;
+      for (size_t i = start; i < end; ++i)
+	{
+	  dwarf2_per_cu_data *per_cu = per_cus[i];
+	  if (!per_cu->is_debug_types
+	      && !per_objfile->symtab_set_p (per_cu)
+	      && per_objfile->get_cu (per_cu) == nullptr)
+	    to_read.push_back (per_cu);
+	}
+
+      using iter_type = decltype (to_read.begin ());
+      using result_type
+	= std::vector<std::pair<dwarf2_per_cu_data *,
+				std::unique_ptr<dwarf2_cu>>>;
+
+      auto task_size_ = [] (iter_type iter)
+	{
+	  return (size_t) (*iter)->length ();
+	};
+      auto task_size = gdb::make_function_view (task_size_);
+
+      std::vector<result_type> results
+	= gdb::parallel_for_each (1, to_read.begin (), to_read.end (),
+				  [=] (iter_type iter, iter_type last)
+	  {
+	    result_type result;
+	    abbrev_cache cache;
+	    for (; iter != last; ++iter)
+	      result.emplace_back (*iter,
+				   preload_full_comp_unit (*iter, per_objfile,
+							   skip_partial,
+							   &cache));
+	    return result;
+	  }, task_size);
+
+      std::unordered_map<dwarf2_per_cu_data *, std::unique_ptr<dwarf2_cu>>
+	preloaded;
+      for (result_type &one_result : results)
+	for (auto &item : one_result)
+	  if (item.second != nullptr)
+	    preloaded.emplace (item.first, std::move (item.second));
+
+      for (size_t i = start; i < end; ++i)
+	{
+	  dwarf2_per_cu_data *per_cu = per_cus[i];
+
+	  /* Expanding an earlier unit of the batch may have expanded or
+	     loaded this one already.  */
+	  auto iter = preloaded.find (per_cu);
+	  if (iter != preloaded.end ()
+	      && !per_objfile->symtab_set_p (per_cu)
+	      && per_objfile->get_cu (per_cu) == nullptr)
+	    per_objfile->set_cu (per_cu, std::move (iter->second));
+
+	  if (!expand (per_cu))
+	    return false;
+	}
+    }
+
+  return true;
+}
+
 /* See read.h.  */
 
 dwarf2_per_cu_data_up
@@ -2208,17 +2349,22 @@ dwarf2_base_index_functions::expand_all_symtabs (struct objfile *objfile)
   dwarf2_per_objfile *per_objfile = get_dwarf2_per_objfile (objfile);
   int total_units = per_objfile->per_bfd->all_units.size ();
 
+  std::vector<dwarf2_per_cu_data *> per_cus;
+  per_cus.reserve (total_units);
   for (int i = 0; i < total_units; ++i)
-    {
-      dwarf2_per_cu_data *per_cu = per_objfile->per_bfd->get_cu (i);
+    per_cus.push_back (per_objfile->per_bfd->get_cu (i));
 
-      /* We don't want to directly expand a partial CU, because if we
-	 read it with the wrong language, then assertion failures can
-	 be triggered later on.  See PR symtab/23010.  So, tell
-	 dw2_instantiate_symtab to skip partial CUs -- any important
-	 partial CU will be read via DW_TAG_imported_unit anyway.  */
+  /* We don't want to directly expand a partial CU, because if we
+     read it with the wrong language, then assertion failures can
+     be triggered later on.  See PR symtab/23010.  So, tell
+     dw2_instantiate_symtab to skip partial CUs -- any important
+     partial CU will be read via DW_TAG_imported_unit anyway.  */
+  dw2_expand_units (per_objfile, per_cus, true,
+		    [&] (dwarf2_per_cu_data *per_cu)
+    {
       dw2_instantiate_symtab (per_cu, per_objfile, true);
-    }
+      return true;
+    });
 }
 
 
@@ -3350,6 +3496,21 @@ get_gdb_index_contents_from_cache_dwz (objfile *obj, dwz_file *dwz)
   return global_index_cache.lookup_gdb_index (build_id, &dwz->index_cache_res);
 }
 
+/* Lookup the index cache for a serialized cooked index of the objfile
+   OBJ.  */
+
+static gdb::array_view<const gdb_byte>
+get_cooked_index_contents_from_cache (objfile *obj,
+				      dwarf2_per_bfd *dwarf2_per_bfd)
+{
+  const bfd_build_id *build_id = build_id_bfd_get (obj->obfd.get ());
+  if (build_id == nullptr)
+    return {};
+
+  return global_index_cache.lookup_cooked_index
+    (build_id, &dwarf2_per_bfd->index_cache_res);
+}
+
 static quick_symbol_functions_up make_cooked_index_funcs ();
 
 /* See dwarf2/public.h.  */
@@ -3404,7 +3565,20 @@ dwarf2_initialize_objfile (struct objfile *objfile)
       return;
     }
 
-  /* ... otherwise, try to find the index in the index cache.  */
+  /* ... otherwise, try to find the index in the index cache.  A
+     serialized cooked index is preferred, because it is turned back
+     into the same index that scanning the DWARF would produce, only
+     without the scan.  It is read, and the hit or miss counted, by
+     dwarf2_build_psymtabs_hard.  */
+  per_bfd->cooked_index_cache
+    = get_cooked_index_contents_from_cache (objfile, per_bfd);
+  if (!per_bfd->cooked_index_cache.empty ())
+    {
+      dwarf_read_debug_printf ("found cooked index from cache");
+      objfile->qf.push_front (make_cooked_index_funcs ());
+      return;
+    }
+
   if (dwarf2_read_gdb_index (per_objfile,
 			     get_gdb_index_contents_from_cache,
 			     get_gdb_index_contents_from_cache_dwz))
@@ -5059,6 +5233,186 @@ process_skeletonless_type_units (dwarf2_per_objfile *per_objfile,
     }
 }
 
+/* Rebuild a cooked index shard from CONTENTS, a serialized cooked
+   index found in the index cache.  The format is described by
+   write_cooked_index_cache.  The units of PER_OBJFILE must already
+   have been created; they are checked against the ones recorded in
+   the file.  Return nullptr if the contents do not match.  */
+
+static std::unique_ptr<cooked_index_shard>
+read_cooked_index_cache (dwarf2_per_objfile *per_objfile,
+			 gdb::array_view<const gdb_byte> contents)
+{
+  dwarf2_per_bfd *per_bfd = per_objfile->per_bfd;
+  const gdb_byte *ptr = contents.data ();
+  const gdb_byte *end = ptr + contents.size ();
+
+  const size_t header_size = 6 * sizeof (offset_type);
+  const size_t unit_size = 2 * 8 + 3 * sizeof (offset_type);
+  const size_t entry_size = 8 + 5 * sizeof (offset_type);
+  const size_t address_size = 2 * 8 + sizeof (offset_type);
+
+  if (contents.size () < header_size)
+    return nullptr;
+
+  offset_type format_version = gdb_index_unpack (ptr);
+  if (format_version != COOKED_INDEX_CACHE_VERSION)
+    {
+      dwarf_read_debug_printf ("cooked index cache has version %u, "
+			       "expected %u", format_version,
+			       COOKED_INDEX_CACHE_VERSION);
+      return nullptr;
+    }
+
+  offset_type n_units = gdb_index_unpack (ptr + 4);
+  offset_type n_entries = gdb_index_unpack (ptr + 8);
+  offset_type n_addresses = gdb_index_unpack (ptr + 12);
+  offset_type pool_size = gdb_index_unpack (ptr + 16);
+  offset_type version_offset = gdb_index_unpack (ptr + 20);
+  ptr += header_size;
+
+  if (n_units != per_bfd->all_units.size ()
+      || (end - ptr) != ((ULONGEST) n_units * unit_size
+			 + (ULONGEST) n_entries * entry_size
+			 + (ULONGEST) n_addresses * address_size
+			 + pool_size))
+    return nullptr;
+
+  const char *pool = (const char *) end - pool_size;
+  if (pool_size == 0 || pool[pool_size - 1] != '\0'
+      || version_offset >= pool_size
+      || strcmp (pool + version_offset, version) != 0)
+    return nullptr;
+
+  /* Check that the units are the ones the index was made for.  The
+     unit type and language are only installed once everything has
+     been validated.  */
+  std::vector<std::pair<dwarf_unit_type, enum language>> unit_info;
+  unit_info.reserve (n_units);
+  for (offset_type i = 0; i < n_units; ++i)
+    {
+      dwarf2_per_cu_data *per_cu = per_bfd->all_units[i].get ();
+
+      ULONGEST sect_off = extract_unsigned_integer (ptr, 8,
+						    BFD_ENDIAN_LITTLE);
+      ULONGEST length = extract_unsigned_integer (ptr + 8, 8,
+						  BFD_ENDIAN_LITTLE);
+      offset_type flags = gdb_index_unpack (ptr + 16);
+      offset_type unit_type = gdb_index_unpack (ptr + 20);
+      offset_type lang = gdb_index_unpack (ptr + 24);
+      ptr += unit_size;
+
+      if (sect_off != to_underlying (per_cu->sect_off)
+	  || length != per_cu->length ()
+	  || (flags & 1) != per_cu->is_dwz
+	  || ((flags & 2) != 0) != per_cu->is_debug_types
+	  || unit_type > 0xff
+	  || (per_cu->unit_type (false) != 0
+	      && per_cu->unit_type (false) != unit_type)
+	  || lang >= nr_languages)
+	return nullptr;
+
+      unit_info.emplace_back ((dwarf_unit_type) unit_type,
+			      (enum language) lang);
+    }
+
+  std::unique_ptr<cooked_index_shard> result (new cooked_index_shard);
+  std::vector<const cooked_index_entry *> entries;
+  entries.reserve (n_entries);
+  for (offset_type i = 0; i < n_entries; ++i)
+    {
+      ULONGEST die_offset = extract_unsigned_integer (ptr, 8,
+						      BFD_ENDIAN_LITTLE);
+      offset_type tag = gdb_index_unpack (ptr + 8);
+      offset_type flags = gdb_index_unpack (ptr + 12);
+      offset_type unit = gdb_index_unpack (ptr + 16);
+      offset_type name = gdb_index_unpack (ptr + 20);
+      offset_type parent = gdb_index_unpack (ptr + 24);
+      ptr += entry_size;
+
+      /* Parents are always written before their children.  */
+      if (tag > 0xffff || flags > 0xff || unit >= n_units
+	  || name >= pool_size
+	  || (parent != (offset_type) -1 && parent >= i))
+	return nullptr;
+
+      const cooked_index_entry *parent_entry
+	= parent == (offset_type) -1 ? nullptr : entries[parent];
+      entries.push_back (result->add ((sect_offset) die_offset,
+				      (enum dwarf_tag) tag,
+				      (cooked_index_flag_enum) flags,
+				      pool + name, parent_entry,
+				      per_bfd->all_units[unit].get ()));
+    }
+
+  addrmap_mutable mutable_map;
+  for (offset_type i = 0; i < n_addresses; ++i)
+    {
+      CORE_ADDR lo = extract_unsigned_integer (ptr, 8, BFD_ENDIAN_LITTLE);
+      CORE_ADDR hi = extract_unsigned_integer (ptr + 8, 8,
+					       BFD_ENDIAN_LITTLE);
+      offset_type unit = gdb_index_unpack (ptr + 16);
+      ptr += address_size;
+
+      if (lo > hi || unit >= n_units)
+	return nullptr;
+
+      /* The end of each range is exclusive, except for the last
+	 possible range which ends at the highest address.  */
+      if (lo == hi)
+	continue;
+      if (hi != (CORE_ADDR) -1)
+	--hi;
+      mutable_map.set_empty (lo, hi, per_bfd->all_units[unit].get ());
+    }
+  result->install_addrmap (&mutable_map);
+
+  for (offset_type i = 0; i < n_units; ++i)
+    {
+      dwarf2_per_cu_data *per_cu = per_bfd->all_units[i].get ();
+
+      if (unit_info[i].first != 0)
+	per_cu->set_unit_type (unit_info[i].first);
+      if (unit_info[i].second != language_unknown
+	  && per_cu->unit_type (false) != 0)
+	per_cu->set_lang (unit_info[i].second);
+    }
+
+  return result;
+}
+
+/* Install the cooked index made of the shards in INDEXES into the
+   per-BFD of PER_OBJFILE, and find the program's "main" in it.
+   FROM_CACHE is true if the shards were read from the index
+   cache.  */
+
+static void
+install_cooked_index (dwarf2_per_objfile *per_objfile,
+		      std::vector<std::unique_ptr<cooked_index_shard>> &&indexes,
+		      bool from_cache)
+{
+  struct objfile *objfile = per_objfile->objfile;
+  dwarf2_per_bfd *per_bfd = per_objfile->per_bfd;
+
+  cooked_index *vec = new cooked_index (std::move (indexes), per_bfd,
+					from_cache);
+  per_bfd->index_table.reset (vec);
+
+  const cooked_index_entry *main_entry = vec->get_main ();
+  if (main_entry != nullptr)
+    {
+      /* We only do this for names not requiring canonicalization.  At
+	 this point in the process names have not been canonicalized.
+	 However, currently, languages that require this step also do
+	 not use DW_AT_main_subprogram.  An assert is appropriate here
+	 because this filtering is done in get_main.  */
+      enum language lang = main_entry->per_cu->lang ();
+      gdb_assert (!language_requires_canonicalization (lang));
+      const char *full_name = main_entry->full_name (&per_bfd->obstack, true);
+      set_objfile_main_name (objfile, full_name, lang);
+    }
+}
+
 /* Build the partial symbol table by doing a quick pass through the
    .debug_info and .debug_abbrev sections.  */
 
@@ -5073,13 +5427,37 @@ dwarf2_build_psymtabs_hard (dwarf2_per_objfile *per_objfile)
 
   per_bfd->map_info_sections (objfile);
 
-  cooked_index_storage index_storage;
   create_all_units (per_objfile);
-  build_type_psymtabs (per_objfile, &index_storage);
-  std::vector<std::unique_ptr<cooked_index_shard>> indexes;
-
   per_bfd->quick_file_names_table
     = create_quick_file_names_table (per_bfd->all_units.size ());
+
+  std::vector<std::unique_ptr<cooked_index_shard>> indexes;
+
+  if (!per_bfd->cooked_index_cache.empty ())
+    {
+      std::unique_ptr<cooked_index_shard> cached
+	= read_cooked_index_cache (per_objfile, per_bfd->cooked_index_cache);
+      per_bfd->cooked_index_cache = {};
+
+      if (cached != nullptr)
+	{
+	  global_index_cache.hit ();
+	  indexes.push_back (std::move (cached));
+	  install_cooked_index (per_objfile, std::move (indexes), true);
+
+	  dwarf_read_debug_printf ("Read cooked index of %s from cache",
+				   objfile_name (objfile));
+	  return;
+	}
+
+      global_index_cache.miss ();
+      dwarf_read_debug_printf ("Cached cooked index of %s does not match, "
+			       "scanning DWARF", objfile_name (objfile));
+    }
+
+  cooked_index_storage index_storage;
+  build_type_psymtabs (per_objfile, &index_storage);
+
   if (!per_bfd->debug_aranges.empty ())
     read_addrmap_from_aranges (per_objfile, &per_bfd->debug_aranges,
 			       index_storage.get_addrmap ());
@@ -5147,22 +5525,7 @@ dwarf2_build_psymtabs_hard (dwarf2_per_objfile *per_objfile)
   indexes.push_back (index_storage.release ());
   indexes.shrink_to_fit ();
 
-  cooked_index *vec = new cooked_index (std::move (indexes), per_bfd);
-  per_bfd->index_table.reset (vec);
-
-  const cooked_index_entry *main_entry = vec->get_main ();
-  if (main_entry != nullptr)
-    {
-      /* We only do this for names not requiring canonicalization.  At
-	 this point in the process names have not been canonicalized.
-	 However, currently, languages that require this step also do
-	 not use DW_AT_main_subprogram.  An assert is appropriate here
-	 because this filtering is done in get_main.  */
-      enum language lang = main_entry->per_cu->lang ();
-      gdb_assert (!language_requires_canonicalization (lang));
-      const char *full_name = main_entry->full_name (&per_bfd->obstack, true);
-      set_objfile_main_name (objfile, full_name, lang);
-    }
+  install_cooked_index (per_objfile, std::move (indexes), false);
 
   dwarf_read_debug_printf ("Done building psymtabs of %s",
 			   objfile_name (objfile));
@@ -5673,28 +6036,15 @@ process_queue (dwarf2_per_objfile *per_objfile)
 			   objfile_name (per_objfile->objfile));
 }
 
-/* Load the DIEs associated with PER_CU into memory.
-
-   In some cases, the caller, while reading partial symbols, will need to load
-   the full symbols for the CU for some reason.  It will already have a
-   dwarf2_cu object for THIS_CU and pass it as EXISTING_CU, so it can be re-used
-   rather than creating a new one.  */
+/* Read all the DIEs of the unit being read by READER into its
+   dwarf2_cu.  This does not touch the per-objfile state, so that it
+   can also be used from a worker thread by preload_full_comp_unit.  */
 
 static void
-load_full_comp_unit (dwarf2_per_cu_data *this_cu,
-		     dwarf2_per_objfile *per_objfile,
-		     dwarf2_cu *existing_cu,
-		     bool skip_partial,
-		     enum language pretend_language)
+read_comp_unit_dies (cutu_reader *reader, enum language pretend_language)
 {
-  gdb_assert (! this_cu->is_debug_types);
-
-  cutu_reader reader (this_cu, per_objfile, NULL, existing_cu, skip_partial);
-  if (reader.dummy_p)
-    return;
-
-  struct dwarf2_cu *cu = reader.cu;
-  const gdb_byte *info_ptr = reader.info_ptr;
+  struct dwarf2_cu *cu = reader->cu;
+  const gdb_byte *info_ptr = reader->info_ptr;
 
   gdb_assert (cu->die_hash == NULL);
   cu->die_hash =
@@ -5706,11 +6056,11 @@ load_full_comp_unit (dwarf2_per_cu_data *this_cu,
 			  hashtab_obstack_allocate,
 			  dummy_obstack_deallocate);
 
-  if (reader.comp_unit_die->has_children)
-    reader.comp_unit_die->child
-      = read_die_and_siblings (&reader, reader.info_ptr,
-			       &info_ptr, reader.comp_unit_die);
-  cu->dies = reader.comp_unit_die;
+  if (reader->comp_unit_die->has_children)
+    reader->comp_unit_die->child
+      = read_die_and_siblings (reader, reader->info_ptr,
+			       &info_ptr, reader->comp_unit_die);
+  cu->dies = reader->comp_unit_die;
   /* comp_unit_die is not stored in die_hash, no need.  */
 
   /* We try not to read any attributes in this function, because not
@@ -5720,10 +6070,70 @@ load_full_comp_unit (dwarf2_per_cu_data *this_cu,
      Similarly, if we do not read the producer, we can not apply
      producer-specific interpretation.  */
   prepare_one_comp_unit (cu, cu->dies, pretend_language);
+}
+
+/* Load the DIEs associated with PER_CU into memory.
+
+   In some cases, the caller, while reading partial symbols, will need to load
+   the full symbols for the CU for some reason.  It will already have a
+   dwarf2_cu object for THIS_CU and pass it as EXISTING_CU, so it can be re-used
+   rather than creating a new one.  */
+
+static void
+load_full_comp_unit (dwarf2_per_cu_data *this_cu,
+		     dwarf2_per_objfile *per_objfile,
+		     dwarf2_cu *existing_cu,
+		     bool skip_partial,
+		     enum language pretend_language)
+{
+  gdb_assert (! this_cu->is_debug_types);
+
+  cutu_reader reader (this_cu, per_objfile, NULL, existing_cu, skip_partial);
+  if (reader.dummy_p)
+    return;
+
+  read_comp_unit_dies (&reader, pretend_language);
 
   reader.keep ();
 }
 
+/* Read the DIEs of THIS_CU into a new dwarf2_cu, like
+   load_full_comp_unit, but return it to the caller instead of
+   putting it on PER_OBJFILE's chain.  This may be called from a
+   worker thread; CACHE holds the abbrev tables already read by that
+   thread.  Return nullptr for a dummy unit, or if reading failed --
+   in the latter case, the error is reported when the unit is read
+   again by load_full_comp_unit.  */
+
+static std::unique_ptr<dwarf2_cu>
+preload_full_comp_unit (dwarf2_per_cu_data *this_cu,
+			dwarf2_per_objfile *per_objfile,
+			bool skip_partial,
+			abbrev_cache *cache)
+{
+  gdb_assert (! this_cu->is_debug_types);
+
+  try
+    {
+      cutu_reader reader (this_cu, per_objfile, nullptr, nullptr,
+			  skip_partial, cache);
+      if (reader.dummy_p)
+	return nullptr;
+
+      read_comp_unit_dies (&reader, language_minimal);
+
+      abbrev_table_up abbrev_table = reader.release_abbrev_table ();
+      if (abbrev_table != nullptr)
+	cache->add (std::move (abbrev_table));
+
+      return reader.release_cu ();
+    }
+  catch (const gdb_exception &except)
+    {
+      return nullptr;
+    }
+}
+
 /* Add a DIE to the delayed physname list.  */
 
 static void
@@ -16706,19 +17116,27 @@ cooked_index_functions::expand_symtabs_matching
 
   /* This invariant is documented in quick-functions.h.  */
   gdb_assert (lookup_name != nullptr || symbol_matcher == nullptr);
+  auto expand_one = [&] (dwarf2_per_cu_data *per_cu)
+    {
+      QUIT;
+
+      return dw2_expand_symtabs_matching_one (per_cu, per_objfile,
+					      file_matcher,
+					      expansion_notify);
+    };
+
+  /* The units to expand are collected first, so that their DIEs can
+     be read as a batch by dw2_expand_units.  */
+  std::vector<dwarf2_per_cu_data *> per_cus;
+
   if (lookup_name == nullptr)
     {
       for (dwarf2_per_cu_data *per_cu
 	     : all_units_range (per_objfile->per_bfd))
-	{
-	  QUIT;
+	if (file_matcher == nullptr || per_cu->mark)
+	  per_cus.push_back (per_cu);
 
-	  if (!dw2_expand_symtabs_matching_one (per_cu, per_objfile,
-						file_matcher,
-						expansion_notify))
-	    return false;
-	}
-      return true;
+      return dw2_expand_units (per_objfile, per_cus, false, expand_one);
     }
 
   lookup_name_info lookup_name_without_params
@@ -16737,6 +17155,8 @@ cooked_index_functions::expand_symtabs_matching
     language_ada
   };
 
+  std::unordered_set<dwarf2_per_cu_data *> seen_cus;
+
   for (enum language lang : unique_styles)
     {
       std::vector<gdb::string_view> name_vec
@@ -16748,8 +17168,10 @@ cooked_index_functions::expand_symtabs_matching
 	{
 	  QUIT;
 
-	  /* No need to consider symbols from expanded CUs.  */
-	  if (per_objfile->symtab_set_p (entry->per_cu))
+	  /* No need to consider symbols from expanded CUs, or from
+	     CUs that are already going to be expanded.  */
+	  if (per_objfile->symtab_set_p (entry->per_cu)
+	      || seen_cus.count (entry->per_cu) != 0)
 	    continue;
 
 	  /* If file-matching was done, we don't need to consider
@@ -16807,14 +17229,12 @@ cooked_index_functions::expand_symtabs_matching
 		continue;
 	    }
 
-	  if (!dw2_expand_symtabs_matching_one (entry->per_cu, per_objfile,
-						file_matcher,
-						expansion_notify))
-	    return false;
+	  seen_cus.insert (entry->per_cu);
+	  per_cus.push_back (entry->per_cu);
 	}
     }
 
-  return true;
+  return dw2_expand_units (per_objfile, per_cus, false, expand_one);
 }
 
 /* Return a new cooked_index_functions object.  */
@@ -21908,6 +22328,18 @@ caching, which can slow down startup."),
 			    &set_dwarf_cmdlist,
 			    &show_dwarf_cmdlist);
 
+  add_setshow_boolean_cmd ("parallel-expansion", class_obscure,
+			   &dwarf_parallel_expansion, _("\
+Set whether DWARF units are read on worker threads during expansion."), _("\
+Show whether DWARF units are read on worker threads during expansion."), _("\
+When on, and many compilation units must be expanded at once, their\n\
+DIEs are read in parallel on the worker threads.  The symbol tables\n\
+are still built one at a time."),
+			   NULL,
+			   show_dwarf_parallel_expansion,
+			   &set_dwarf_cmdlist,
+			   &show_dwarf_cmdlist);
+
   add_setshow_zuinteger_cmd ("dwarf-read", no_class, &dwarf_read_debug, _("\
 Set debugging of the DWARF reader."), _("\
 Show debugging of the DWARF reader."), _("\
@@ -548,6 +548,11 @@ struct dwarf2_per_bfd
      resources associated to the open file, memory mapping, etc.  */
   std::unique_ptr<index_cache_resource> index_cache_res;
 
+  /* If a serialized cooked index was found in the index cache, this
+     holds its contents, which are kept alive by INDEX_CACHE_RES.  It
+     is consumed by the first attempt to build the cooked index.  */
+  gdb::array_view<const gdb_byte> cooked_index_cache;
+
   /* Mapping from abstract origin DIE to concrete DIEs that reference it as
      DW_AT_abstract_origin.  */
   std::unordered_map<sect_offset, std::vector<sect_offset>,
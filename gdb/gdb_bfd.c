@@ -48,6 +48,9 @@ struct gdb_bfd_section_data
   void *data;
   /* If the data was mmapped, this is the map address.  */
   void *map_addr;
+  /* True if gdb_bfd_map_section_sparse could not map the section, so
+     that it does not try again on every read.  */
+  bool map_failed;
 };
 
 /* A hash table holding every BFD that gdb knows about.  This is not
@@ -815,6 +818,71 @@ gdb_bfd_map_section (asection *sectp, bfd_size_type *size)
   return (const gdb_byte *) descriptor->data;
 }
 
+/* See gdb_bfd.h.  */
+
+const gdb_byte *
+gdb_bfd_map_section_sparse (asection *sectp, bfd_size_type *size)
+{
+#ifdef HAVE_MMAP
+  bfd *abfd = sectp->owner;
+  struct gdb_bfd_section_data *descriptor = get_section_descriptor (sectp);
+
+  if (descriptor->map_failed)
+    return NULL;
+
+  if (descriptor->data != NULL)
+    {
+      /* Don't hand out a heap copy made by gdb_bfd_map_section, or a
+	 previous failure.  */
+      if (descriptor->map_addr == NULL)
+	return NULL;
+
+      *size = descriptor->size;
+      return (const gdb_byte *) descriptor->data;
+    }
+
+  /* The page size, used when mmapping.  */
+  static int pagesize;
+
+  if (pagesize == 0)
+    pagesize = getpagesize ();
+
+  /* As in gdb_bfd_map_section, small sections are not worth a
+     mapping of their own.  */
+  if ((sectp->flags & (SEC_HAS_CONTENTS | SEC_RELOC)) != SEC_HAS_CONTENTS
+      || bfd_is_section_compressed (abfd, sectp)
+      || bfd_section_size (sectp) <= 4 * pagesize)
+    {
+      descriptor->map_failed = true;
+      return NULL;
+    }
+
+  void *map_addr;
+  bfd_size_type map_len;
+  void *data = bfd_mmap (abfd, 0, bfd_section_size (sectp), PROT_READ,
+			 MAP_PRIVATE, sectp->filepos, &map_addr, &map_len);
+  if ((caddr_t) data == MAP_FAILED)
+    {
+      descriptor->map_failed = true;
+      return NULL;
+    }
+
+#if HAVE_POSIX_MADVISE
+  posix_madvise (map_addr, map_len, POSIX_MADV_RANDOM);
+#endif
+
+  descriptor->size = bfd_section_size (sectp);
+  descriptor->data = data;
+  descriptor->map_addr = map_addr;
+  descriptor->map_len = map_len;
+
+  *size = descriptor->size;
+  return (const gdb_byte *) data;
+#else
+  return NULL;
+#endif /* HAVE_MMAP */
+}
+
 /* Return 32-bit CRC for ABFD.  If successful store it to *FILE_CRC_RETURN and
    return 1.  Otherwise print a warning and return 0.  ABFD seek position is
    not preserved.  */
@@ -1068,6 +1136,75 @@ gdb_bfd_errmsg (bfd_error_type error_tag, char **matching)
   return ret;
 }
 
+#if defined (HAVE_MMAP) && defined (HAVE_MINCORE)
+
+/* Call MINCORE_FN, which is mincore, on [ADDR, ADDR + LEN), filling
+   VEC.  This hides the differences between the mincore prototypes of
+   the various hosts.  */
+
+template<typename Addr, typename Vec>
+static int
+call_mincore (int (*mincore_fn) (Addr, size_t, Vec *), void *addr,
+	      size_t len, gdb::byte_vector &vec)
+{
+  return mincore_fn ((Addr) addr, len, (Vec *) vec.data ());
+}
+
+#endif
+
+/* Return the number of bytes of ABFD's section contents that GDB has
+   mmapped, and in *RESIDENT how many of those are currently in
+   memory, or -1 if that is not known.  */
+
+static ULONGEST
+bfd_mapped_bytes (bfd *abfd, LONGEST *resident)
+{
+  ULONGEST mapped = 0;
+
+  *resident = 0;
+
+#ifdef HAVE_MMAP
+  for (asection *sect : gdb_bfd_sections (abfd))
+    {
+      struct gdb_bfd_section_data *descriptor
+	= (struct gdb_bfd_section_data *) bfd_section_userdata (sect);
+
+      if (descriptor == NULL || descriptor->map_addr == NULL)
+	continue;
+
+      mapped += descriptor->map_len;
+
+#ifdef HAVE_MINCORE
+      if (*resident < 0)
+	continue;
+
+      static int pagesize;
+
+      if (pagesize == 0)
+	pagesize = getpagesize ();
+
+      gdb::byte_vector vec ((descriptor->map_len + pagesize - 1) / pagesize);
+      if (call_mincore (mincore, descriptor->map_addr, descriptor->map_len,
+			vec) != 0)
+	{
+	  *resident = -1;
+	  continue;
+	}
+
+      for (gdb_byte page : vec)
+	if ((page & 1) != 0)
+	  *resident += pagesize;
+#endif
+    }
+#endif /* HAVE_MMAP */
+
+#ifndef HAVE_MINCORE
+  *resident = -1;
+#endif
+
+  return mapped;
+}
+
 /* A callback for htab_traverse that prints a single BFD.  */
 
 static int
@@ -1076,10 +1213,17 @@ print_one_bfd (void **slot, void *data)
   bfd *abfd = (struct bfd *) *slot;
   struct gdb_bfd_data *gdata = (struct gdb_bfd_data *) bfd_usrdata (abfd);
   struct ui_out *uiout = (struct ui_out *) data;
+  LONGEST resident;
+  ULONGEST mapped = bfd_mapped_bytes (abfd, &resident);
 
   ui_out_emit_tuple tuple_emitter (uiout, NULL);
   uiout->field_signed ("refcount", gdata->refc);
   uiout->field_string ("addr", host_address_to_string (abfd));
+  uiout->field_string ("mapped", pulongest (mapped));
+  if (resident < 0)
+    uiout->field_skip ("resident");
+  else
+    uiout->field_string ("resident", plongest (resident));
   uiout->field_string ("filename", bfd_get_filename (abfd),
 		       file_name_style.style ());
   uiout->text ("\n");
@@ -1094,13 +1238,41 @@ maintenance_info_bfds (const char *arg, int from_tty)
 {
   struct ui_out *uiout = current_uiout;
 
-  ui_out_emit_table table_emitter (uiout, 3, -1, "bfds");
-  uiout->table_header (10, ui_left, "refcount", "Refcount");
-  uiout->table_header (18, ui_left, "addr", "Address");
-  uiout->table_header (40, ui_left, "filename", "Filename");
+  {
+    ui_out_emit_table table_emitter (uiout, 5, -1, "bfds");
+    uiout->table_header (10, ui_left, "refcount", "Refcount");
+    uiout->table_header (18, ui_left, "addr", "Address");
+    uiout->table_header (12, ui_left, "mapped", "Mapped");
+    uiout->table_header (12, ui_left, "resident", "Resident");
+    uiout->table_header (40, ui_left, "filename", "Filename");
+
+    uiout->table_body ();
+    htab_traverse (all_bfds, print_one_bfd, uiout);
+  }
 
-  uiout->table_body ();
-  htab_traverse (all_bfds, print_one_bfd, uiout);
+  /* Show how well BFD's cache of open files is doing.  */
+  struct bfd_cache_stats stats;
+  bfd_cache_get_stats (&stats);
+
+  ui_out_emit_tuple tuple_emitter (uiout, "file-cache");
+  uiout->text (_("\nBFD file cache: "));
+  uiout->field_unsigned ("hits", stats.hits);
+  uiout->text (_(" hits, "));
+  uiout->field_unsigned ("misses", stats.misses);
+  uiout->text (_(" misses, "));
+  uiout->field_unsigned ("reopens", stats.reopens);
+  uiout->text (_(" reopens, "));
+  uiout->field_unsigned ("evictions", stats.evictions);
+  uiout->text (_(" evictions\n"));
+  uiout->text (_("Open files: "));
+  uiout->field_signed ("open", stats.open);
+  uiout->text (_(" (limit "));
+  uiout->field_signed ("max-open", stats.max_open);
+  uiout->text (_("), mapped files: "));
+  uiout->field_unsigned ("files-mapped", stats.mapped);
+  uiout->text (_(" ("));
+  uiout->field_unsigned ("bytes-mapped", stats.mapped_size);
+  uiout->text (_(" bytes)\n"));
 }
 
 /* BFD related per-inferior data.  */
@@ -127,6 +127,16 @@ void gdb_bfd_record_inclusion (bfd *includer, bfd *includee);
 
 const gdb_byte *gdb_bfd_map_section (asection *section, bfd_size_type *size);
 
+/* Like gdb_bfd_map_section, but for large sections whose contents are
+   accessed sparsely, such as the memory sections of a core file.  The
+   section is only ever mmapped, and the kernel is told not to read
+   ahead.  Returns NULL, without a warning, if the section is small,
+   compressed or cannot be mapped; the caller should then read what it
+   needs with bfd_get_section_contents.  */
+
+const gdb_byte *gdb_bfd_map_section_sparse (asection *section,
+					    bfd_size_type *size);
+
 /* Compute the CRC for ABFD.  The CRC is used to find and verify
    separate debug files.  When successful, this fills in *CRC_OUT and
    returns 1.  Otherwise, this issues a warning and returns 0.  */
@@ -302,6 +302,9 @@ enum {
      packets and the tag violation stop replies.  */
   PACKET_memory_tagging_feature,
 
+  /* Support for the qMemReadv packet.  */
+  PACKET_qMemReadv,
+
   PACKET_MAX
 };
 
@@ -364,6 +367,43 @@ struct readahead_cache
   ULONGEST miss_count = 0;
 };
 
+/* A cache of the memory fetched by the last qMemReadv packet sent
+   by remote_target::prefetch_memory.  Memory may only be cached while
+   the target is stopped, so this is invalidated whenever the target
+   is resumed or its memory is written to.  */
+
+struct memory_prefetch_cache
+{
+  /* Invalidate the prefetch cache.  */
+  void invalidate ();
+
+  /* Serve a memory read of process PID from the prefetch cache.
+     Returns number of bytes read, or 0 if the request can't be served
+     from the cache.  */
+  ULONGEST read (int pid, CORE_ADDR memaddr, gdb_byte *myaddr,
+		 ULONGEST len);
+
+  /* A region of memory that was read successfully.  */
+  struct region
+  {
+    /* The address of the first byte of DATA.  */
+    CORE_ADDR addr;
+
+    /* The contents of the region.  */
+    gdb::byte_vector data;
+  };
+
+  /* The process the cached memory belongs to.  */
+  int pid = 0;
+
+  /* The cached regions.  */
+  std::vector<region> regions;
+
+  /* Cache hit and miss counters.  */
+  ULONGEST hit_count = 0;
+  ULONGEST miss_count = 0;
+};
+
 /* Description of the remote protocol for a given architecture.  */
 
 struct packet_reg
@@ -534,6 +574,9 @@ class remote_state
      file descriptor at a time.  */
   struct readahead_cache readahead_cache;
 
+  /* The memory fetched ahead of time by the last qMemReadv packet.  */
+  struct memory_prefetch_cache memory_prefetch_cache;
+
   /* The list of already fetched and acknowledged stop events.  This
      queue is used for notification Stop, and other notifications
      don't need queue for their events, because the notification
@@ -805,6 +848,8 @@ class remote_target : public process_stratum_target
 
   ULONGEST get_memory_xfer_limit () override;
 
+  void prefetch_memory (gdb::array_view<const mem_range> ranges) override;
+
   void rcmd (const char *command, struct ui_file *output) override;
 
   const char *pid_to_exec_file (int pid) override;
@@ -5604,6 +5649,7 @@ static const struct protocol_feature remote_protocol_features[] = {
   { "no-resumed", PACKET_DISABLE, remote_supported_packet, PACKET_no_resumed },
   { "memory-tagging", PACKET_DISABLE, remote_supported_packet,
     PACKET_memory_tagging_feature },
+  { "qMemReadv", PACKET_DISABLE, remote_supported_packet, PACKET_qMemReadv },
 };
 
 static char *remote_support_xml;
@@ -6021,6 +6067,7 @@ remote_target::open_1 (const char *name, int from_tty, int extended_p)
   rs->use_threadextra_query = 1;
 
   rs->readahead_cache.invalidate ();
+  rs->memory_prefetch_cache.invalidate ();
 
   if (target_async_permitted)
     {
@@ -6720,6 +6767,9 @@ remote_target::resume (ptid_t scope_ptid, int step, enum gdb_signal siggnal)
 {
   struct remote_state *rs = get_remote_state ();
 
+  /* Memory may change once the target runs.  */
+  rs->memory_prefetch_cache.invalidate ();
+
   /* When connected in non-stop mode, the core resumes threads
      individually.  Resuming remote threads directly in target_resume
      would thus result in sending one packet per thread.  Instead, to
@@ -9165,6 +9215,8 @@ remote_target::remote_write_bytes_aux (const char *header, CORE_ADDR memaddr,
   if (len_units == 0)
     return TARGET_XFER_EOF;
 
+  rs->memory_prefetch_cache.invalidate ();
+
   payload_capacity_bytes = get_memory_write_packet_size ();
 
   /* The packet buffer will be large enough for the payload;
@@ -9453,6 +9505,30 @@ remote_target::remote_read_bytes (CORE_ADDR memaddr,
   if (len == 0)
     return TARGET_XFER_EOF;
 
+  if (get_traceframe_number () == -1 && unit_size == 1)
+    {
+      memory_prefetch_cache *cache = &get_remote_state ()->memory_prefetch_cache;
+
+      if (!cache->regions.empty ())
+	{
+	  *xfered_len = cache->read (inferior_ptid.pid (), memaddr, myaddr,
+				     len);
+	  if (*xfered_len > 0)
+	    {
+	      cache->hit_count++;
+
+	      remote_debug_printf ("prefetch cache hit %s",
+				   pulongest (cache->hit_count));
+	      return TARGET_XFER_OK;
+	    }
+
+	  cache->miss_count++;
+
+	  remote_debug_printf ("prefetch cache miss %s",
+			       pulongest (cache->miss_count));
+	}
+    }
+
   if (get_traceframe_number () != -1)
     {
       std::vector<mem_range> available;
@@ -9505,6 +9581,142 @@ remote_target::remote_read_bytes (CORE_ADDR memaddr,
 
 
 
+/* See declaration.  */
+
+void
+memory_prefetch_cache::invalidate ()
+{
+  this->regions.clear ();
+}
+
+/* See declaration.  */
+
+ULONGEST
+memory_prefetch_cache::read (int pid, CORE_ADDR memaddr, gdb_byte *myaddr,
+			     ULONGEST len)
+{
+  if (this->pid != pid)
+    return 0;
+
+  for (const region &r : this->regions)
+    if (memaddr >= r.addr && memaddr - r.addr < r.data.size ())
+      {
+	ULONGEST offset = memaddr - r.addr;
+
+	len = std::min (len, (ULONGEST) r.data.size () - offset);
+	memcpy (myaddr, r.data.data () + offset, len);
+	return len;
+      }
+
+  return 0;
+}
+
+/* Implementation of to_prefetch_memory.  Fetch as many of RANGES as
+   possible with qMemReadv packets, and keep the result in the prefetch
+   cache, from where remote_read_bytes serves the reads that follow.
+
+   Nothing is cached in non-stop mode, where running threads could
+   change the memory behind GDB's back, nor when looking at a
+   traceframe, whose memory is not read with 'm' packets anyway.  */
+
+void
+remote_target::prefetch_memory (gdb::array_view<const mem_range> ranges)
+{
+  struct remote_state *rs = get_remote_state ();
+  memory_prefetch_cache *cache = &rs->memory_prefetch_cache;
+
+  if (m_features.packet_support (PACKET_qMemReadv) == PACKET_DISABLE
+      || target_is_non_stop_p ()
+      || get_traceframe_number () != -1
+      || !target_has_execution ()
+      || gdbarch_addressable_memory_unit_size (target_gdbarch ()) != 1)
+    return;
+
+  set_remote_traceframe ();
+  set_general_thread (inferior_ptid);
+
+  cache->invalidate ();
+  cache->pid = inferior_ptid.pid ();
+
+  /* The reply holds two hex digits per byte, plus a separator per
+     region.  */
+  const long max_reply = get_memory_read_packet_size ();
+
+  size_t i = 0;
+  while (i < ranges.size ())
+    {
+      /* Construct "qMemReadv:"<addr>","<len>[";"<addr>","<len>]...,
+	 with as many regions as fit in both the request and the
+	 reply.  */
+      char *p = rs->buf.data ();
+      char *endbuf = p + get_remote_packet_size ();
+      std::vector<ULONGEST> lens;
+      long reply_size = 0;
+
+      p += xsnprintf (p, endbuf - p, "qMemReadv:");
+      for (; i < ranges.size (); i++)
+	{
+	  ULONGEST len = ranges[i].length;
+
+	  if (lens.empty ())
+	    len = std::min (len, (ULONGEST) max_reply / 2);
+	  else if (reply_size + 1 + 2 * len > max_reply
+		   || endbuf - p < 2 * (2 * sizeof (ULONGEST) + 1) + 1)
+	    break;
+
+	  if (!lens.empty ())
+	    *p++ = ';';
+	  p += hexnumstr (p, (ULONGEST) remote_address_masked (ranges[i].start));
+	  *p++ = ',';
+	  p += hexnumstr (p, len);
+
+	  lens.push_back (len);
+	  reply_size += 1 + 2 * len;
+	}
+      *p = '\0';
+
+      putpkt (rs->buf);
+      getpkt (&rs->buf, 0);
+
+      /* Once the stub has told us it supports the packet, an
+	 unexpected reply must not turn into a protocol error: this is
+	 only a prefetch, and the reads that follow go through 'm'
+	 packets as usual.  */
+      packet_result result
+	= (m_features.packet_support (PACKET_qMemReadv) == PACKET_ENABLE
+	   ? packet_check_result (rs->buf)
+	   : m_features.packet_ok (rs->buf, PACKET_qMemReadv));
+      if (result != PACKET_OK)
+	return;
+
+      /* The reply has one hex-encoded block of memory per region,
+	 separated by ';'.  A region that could not be read has fewer
+	 bytes than requested, possibly none.  */
+      const char *reply = rs->buf.data ();
+      size_t first = i - lens.size ();
+      for (size_t j = 0; j < lens.size (); j++)
+	{
+	  const char *sep = strchr (reply, ';');
+	  size_t nchars = sep != nullptr ? sep - reply : strlen (reply);
+	  ULONGEST nbytes = std::min ((ULONGEST) nchars / 2, lens[j]);
+
+	  if (nbytes > 0)
+	    {
+	      memory_prefetch_cache::region r;
+
+	      r.addr = ranges[first + j].start;
+	      r.data.resize (nbytes);
+	      hex2bin (reply, r.data.data (), nbytes);
+	      cache->regions.push_back (std::move (r));
+	    }
+
+	  if (sep == nullptr)
+	    break;
+	  reply = sep + 1;
+	}
+    }
+}
+
 /* Sends a packet with content determined by the printf format string
    FORMAT and the remaining arguments, then gets the reply.  Returns
    whether the packet was a success, a failure, or unknown.  */
@@ -9548,6 +9760,8 @@ remote_target::flash_erase (ULONGEST address, LONGEST length)
   scoped_restore restore_timeout
     = make_scoped_restore (&remote_timeout, remote_flash_timeout);
 
+  get_remote_state ()->memory_prefetch_cache.invalidate ();
+
   ret = remote_send_printf ("vFlashErase:%s,%s",
 			    phex (address, addr_size),
 			    phex (length, 4));
@@ -10386,6 +10600,8 @@ remote_target::mourn_inferior ()
      that exited or was killed/detached.  */
   discard_pending_stop_replies (current_inferior ());
 
+  rs->memory_prefetch_cache.invalidate ();
+
   /* In 'target remote' mode with one inferior, we close the connection.  */
   if (!rs->extended && number_of_live_inferiors (this) <= 1)
     {
@@ -15409,6 +15625,9 @@ Show the maximum size of the address (in bits) in a memory packet."), NULL,
   add_packet_config_cmd (PACKET_memory_tagging_feature,
 			 "memory-tagging-feature", "memory-tagging-feature", 0);
 
+  add_packet_config_cmd (PACKET_qMemReadv, "qMemReadv", "read-memory-vector",
+			 0);
+
   /* Assert that we've registered "set remote foo-packet" commands
      for all packet configs.  */
   {
@@ -113,6 +113,7 @@ struct dummy_target : public target_ops
   void goto_bookmark (const gdb_byte *arg0, int arg1) override;
   CORE_ADDR get_thread_local_address (ptid_t arg0, CORE_ADDR arg1, CORE_ADDR arg2) override;
   enum target_xfer_status xfer_partial (enum target_object arg0, const char *arg1, gdb_byte *arg2, const gdb_byte *arg3, ULONGEST arg4, ULONGEST arg5, ULONGEST *arg6) override;
+  void prefetch_memory (gdb::array_view<const mem_range> arg0) override;
   ULONGEST get_memory_xfer_limit () override;
   std::vector<mem_region> memory_map () override;
   void flash_erase (ULONGEST arg0, LONGEST arg1) override;
@@ -287,6 +288,7 @@ struct debug_target : public target_ops
   void goto_bookmark (const gdb_byte *arg0, int arg1) override;
   CORE_ADDR get_thread_local_address (ptid_t arg0, CORE_ADDR arg1, CORE_ADDR arg2) override;
   enum target_xfer_status xfer_partial (enum target_object arg0, const char *arg1, gdb_byte *arg2, const gdb_byte *arg3, ULONGEST arg4, ULONGEST arg5, ULONGEST *arg6) override;
+  void prefetch_memory (gdb::array_view<const mem_range> arg0) override;
   ULONGEST get_memory_xfer_limit () override;
   std::vector<mem_region> memory_map () override;
   void flash_erase (ULONGEST arg0, LONGEST arg1) override;
@@ -2474,6 +2476,27 @@ debug_target::xfer_partial (enum target_object arg0, const char *arg1, gdb_byte
   return result;
 }
 
+void
+target_ops::prefetch_memory (gdb::array_view<const mem_range> arg0)
+{
+  this->beneath ()->prefetch_memory (arg0);
+}
+
+void
+dummy_target::prefetch_memory (gdb::array_view<const mem_range> arg0)
+{
+}
+
+void
+debug_target::prefetch_memory (gdb::array_view<const mem_range> arg0)
+{
+  gdb_printf (gdb_stdlog, "-> %s->prefetch_memory (...)\n", this->beneath ()->shortname ());
+  this->beneath ()->prefetch_memory (arg0);
+  gdb_printf (gdb_stdlog, "<- %s->prefetch_memory (", this->beneath ()->shortname ());
+  target_debug_print_gdb_array_view_const_mem_range (arg0);
+  gdb_puts (")\n", gdb_stdlog);
+}
+
 ULONGEST
 target_ops::get_memory_xfer_limit ()
 {
@@ -1837,6 +1837,54 @@ target_read_code (CORE_ADDR memaddr, gdb_byte *myaddr, ssize_t len)
     return -1;
 }
 
+/* See target.h.  */
+
+void
+target_prefetch_memory (gdb::array_view<const mem_range> ranges)
+{
+  if (ranges.empty ())
+    return;
+
+  std::vector<mem_range> wanted;
+
+  /* Stack and code reads may go through the dcache, which asks the
+     target for whole lines.  Prefetch whole lines too, so that those
+     requests can be served from what was prefetched, and skip the
+     lines the dcache already holds.  */
+  if (stack_cache_enabled_p () || code_cache_enabled_p ())
+    {
+      unsigned line_size = dcache_get_line_size ();
+      CORE_ADDR mask = line_size - 1;
+      DCACHE *dcache = target_dcache_get ();
+
+      for (const mem_range &r : ranges)
+	{
+	  CORE_ADDR start = r.start & ~mask;
+	  CORE_ADDR end = (r.start + r.length + mask) & ~mask;
+
+	  for (CORE_ADDR line = start; line < end; line += line_size)
+	    {
+	      if (dcache != nullptr && dcache_contains (dcache, line))
+		continue;
+
+	      if (!wanted.empty ()
+		  && wanted.back ().start + wanted.back ().length == line)
+		wanted.back ().length += line_size;
+	      else
+		wanted.emplace_back (line, line_size);
+	    }
+	}
+
+      if (wanted.empty ())
+	return;
+    }
+  else
+    wanted.assign (ranges.begin (), ranges.end ());
+
+  normalize_mem_ranges (&wanted);
+  current_inferior ()->top_target ()->prefetch_memory (wanted);
+}
+
 /* Write LEN bytes from MYADDR to target memory at address MEMADDR.
    Returns either 0 for success or -1 if any error occurs.  If an
    error occurs, no guarantee is made about how much data got written.
@@ -800,6 +800,14 @@ struct target_ops
 						  ULONGEST *xfered_len)
       TARGET_DEFAULT_RETURN (TARGET_XFER_E_IO);
 
+    /* Hint that the memory in RANGES is about to be read.  A target
+       that can fetch several regions in a single round trip may read
+       them all now and serve the following reads from its own cache.
+       This is purely an optimization: the regions are still read
+       through xfer_partial afterwards, and errors are ignored.  */
+    virtual void prefetch_memory (gdb::array_view<const mem_range> ranges)
+      TARGET_DEFAULT_IGNORE ();
+
     /* Return the limit on the size of any single memory transfer
        for the target.  */
 
@@ -1582,6 +1590,12 @@ extern int target_read_stack (CORE_ADDR memaddr, gdb_byte *myaddr, ssize_t len);
 
 extern int target_read_code (CORE_ADDR memaddr, gdb_byte *myaddr, ssize_t len);
 
+/* Tell the target that the memory in RANGES is about to be read, so
+   that it can fetch it in as few round trips as possible.  See
+   target_ops::prefetch_memory.  */
+
+extern void target_prefetch_memory (gdb::array_view<const mem_range> ranges);
+
 /* For target_write_memory see target/target.h.  */
 
 extern int target_write_raw_memory (CORE_ADDR memaddr, const gdb_byte *myaddr,
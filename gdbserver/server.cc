@@ -2137,6 +2137,96 @@ parse_fetch_memtags_request (char *request, CORE_ADDR *addr, size_t *len,
   *type = (int) tag_type;
 }
 
+/* Parse the qMemReadv packet request into the list of (address,
+   length) pairs REGIONS.  Return false if the request is
+   malformed.  */
+
+static bool
+parse_memreadv_request (const char *request,
+			std::vector<std::pair<CORE_ADDR, ULONGEST>> &regions)
+{
+  gdb_assert (startswith (request, "qMemReadv:"));
+
+  const char *p = request + strlen ("qMemReadv:");
+
+  regions.clear ();
+  while (true)
+    {
+      ULONGEST addr, len;
+      const char *q = unpack_varlen_hex (p, &addr);
+
+      if (q == p || *q != ',')
+	return false;
+      p = q + 1;
+      q = unpack_varlen_hex (p, &len);
+      if (q == p)
+	return false;
+      regions.emplace_back (addr, len);
+
+      p = q;
+      if (*p == '\0')
+	return true;
+      if (*p != ';')
+	return false;
+      p++;
+    }
+}
+
+/* Create the qMemReadv packet reply in OWN_BUF, reading each region
+   of REGIONS in turn.  The contents of each region are hex encoded as
+   for the 'm' packet, and separated by ';'.  A region that cannot be
+   read, or that does not fit in the packet buffer any more, is
+   replied to with fewer bytes than requested, possibly none.  */
+
+static void
+create_memreadv_reply (char *own_buf,
+		       const std::vector<std::pair<CORE_ADDR, ULONGEST>> &regions)
+{
+  gdb::byte_vector data;
+  char *p = own_buf;
+  size_t room = PBUFSIZ - 1;
+  bool read_any = false;
+
+  for (size_t i = 0; i < regions.size (); i++)
+    {
+      if (i > 0)
+	{
+	  if (room == 0)
+	    break;
+	  *p++ = ';';
+	  room--;
+	}
+
+      ULONGEST len = std::min (regions[i].second, (ULONGEST) room / 2);
+      int res = 0;
+
+      if (len > 0)
+	{
+	  data.resize (len);
+	  res = gdb_read_memory (regions[i].first, data.data (), len);
+	}
+
+      if (res > 0)
+	{
+	  bin2hex (data.data (), p, res);
+	  p += 2 * res;
+	  room -= 2 * res;
+	  read_any = true;
+	}
+    }
+
+  /* A reply of a single empty region would look like the packet is
+     not supported; report an error instead when nothing could be
+     read at all.  */
+  if (!read_any)
+    {
+      write_enn (own_buf);
+      return;
+    }
+
+  *p = '\0';
+}
+
 /* Add supported btrace packets to BUF.  */
 
 static void
@@ -2477,6 +2567,8 @@ handle_query (char *own_buf, int packet_len, int *new_packet_len_p)
 
       strcat (own_buf, ";no-resumed+");
 
+      strcat (own_buf, ";qMemReadv+");
+
       if (target_supports_memory_tagging ())
 	strcat (own_buf, ";memory-tagging+");
 
@@ -2672,6 +2764,20 @@ handle_query (char *own_buf, int packet_len, int *new_packet_len_p)
   if (target_supports_tracepoints () && handle_tracepoint_query (own_buf))
     return;
 
+  /* Handle batched memory reads.  */
+  if (startswith (own_buf, "qMemReadv:"))
+    {
+      std::vector<std::pair<CORE_ADDR, ULONGEST>> regions;
+
+      require_running_or_return (own_buf);
+
+      if (parse_memreadv_request (own_buf, regions))
+	create_memreadv_reply (own_buf, regions);
+      else
+	write_enn (own_buf);
+      return;
+    }
+
   /* Handle fetch memory tags packets.  */
   if (startswith (own_buf, "qMemTags:")
       && target_supports_memory_tagging ())
@@ -3652,6 +3758,33 @@ test_memory_tagging_functions (void)
 	      && tags.size () == 5);
 }
 
+static void
+test_memreadv_functions (void)
+{
+  std::vector<std::pair<CORE_ADDR, ULONGEST>> regions;
+
+  /* A single region.  */
+  SELF_CHECK (parse_memreadv_request ("qMemReadv:1000,10", regions));
+  SELF_CHECK (regions.size () == 1
+	      && regions[0].first == 0x1000 && regions[0].second == 0x10);
+
+  /* Several regions.  */
+  SELF_CHECK (parse_memreadv_request ("qMemReadv:deadbeef,8;0,0;ff,4",
+				      regions));
+  SELF_CHECK (regions.size () == 3
+	      && regions[0].first == 0xdeadbeef && regions[0].second == 8
+	      && regions[1].first == 0 && regions[1].second == 0
+	      && regions[2].first == 0xff && regions[2].second == 4);
+
+  /* Malformed requests.  */
+  SELF_CHECK (!parse_memreadv_request ("qMemReadv:", regions));
+  SELF_CHECK (!parse_memreadv_request ("qMemReadv:1000", regions));
+  SELF_CHECK (!parse_memreadv_request ("qMemReadv:1000,", regions));
+  SELF_CHECK (!parse_memreadv_request ("qMemReadv:1000,10;", regions));
+  SELF_CHECK (!parse_memreadv_request ("qMemReadv:1000,10:2000,4",
+				       regions));
+}
+
 } // namespace selftests
 #endif /* GDB_SELF_TEST */
 
@@ -3675,6 +3808,8 @@ captured_main (int argc, char *argv[])
 
   selftests::register_test ("remote_memory_tagging",
 			    selftests::test_memory_tagging_functions);
+  selftests::register_test ("remote_memreadv",
+			    selftests::test_memreadv_functions);
 #endif
 
   current_directory = getcwd (NULL, 0);
@@ -28,6 +28,7 @@
 #include "elfcpp.h"
 #include "symtab.h"
 #include "object.h"
+#include "timer.h"
 
 namespace gold
 {
@@ -81,7 +82,9 @@ class Icf
   : id_section_(), section_id_(), kept_section_id_(),
     fptr_section_id_(),
     icf_ready_(false),
-    reloc_info_list_()
+    reloc_info_list_(),
+    num_iterations_(0), converged_(false), thread_count_(1),
+    sections_hashed_(0), run_time_()
   { }
 
   // Returns the kept folded identical section corresponding to
@@ -161,6 +164,10 @@ class Icf
   section_to_int_map()
   { return this->section_id_; }
 
+  // Print statistics about the last run of find_identical_sections.
+  void
+  print_stats() const;
+
  private:
 
   bool
@@ -186,6 +193,17 @@ class Icf
   // Regions of other sections that should be considered part of
   // each section for ICF purposes.
   Extra_identity_list extra_identity_list_;
+  // The number of iterations run, for --stats.
+  unsigned int num_iterations_;
+  // Whether the iterations converged, for --stats.
+  bool converged_;
+  // The number of threads used to hash sections, for --stats.
+  unsigned int thread_count_;
+  // The number of section digests computed, summed over all the
+  // iterations, for --stats.
+  unsigned long long sections_hashed_;
+  // The time spent in find_identical_sections, for --stats.
+  Timer::TimeStats run_time_;
 };
 
 // This function returns true if this section corresponds to a function that
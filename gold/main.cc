@@ -307,6 +307,8 @@ main(int argc, char** argv)
 	      program_name, static_cast<long long>(layout.output_file_size()));
       symtab.print_stats();
       layout.print_stats();
+      if (parameters->options().icf_enabled())
+	icf.print_stats();
       Gdb_index::print_stats();
       Free_list::print_stats();
     }
@@ -310,6 +310,22 @@ struct flag_info
 struct bfd_elf_dynamic_list;
 struct bfd_elf_version_tree;
 
+/* Counts of what was done when merging SEC_MERGE sections.  */
+struct bfd_link_merge_stats
+{
+  /* Number of input sections merged.  */
+  bfd_size_type sections;
+
+  /* Number of entities (strings or constants) in the input sections,
+     and how many of them were different.  */
+  bfd_size_type input_entities;
+  bfd_size_type unique_entities;
+
+  /* Total size of the input sections, and of the merged sections.  */
+  bfd_size_type input_size;
+  bfd_size_type output_size;
+};
+
 /* Types of output.  */
 
 enum output_type
@@ -733,6 +749,10 @@ struct bfd_link_info
   /* The maximum cache size.  Backend can use cache_size and and
      max_cache_size to decide if keep_memory should be honored.  */
   bfd_size_type max_cache_size;
+
+  /* If non-NULL, counts are added here when SEC_MERGE sections are
+     merged.  */
+  struct bfd_link_merge_stats *merge_stats;
 };
 
 /* Some forward-definitions used by some callbacks.  */
@@ -574,7 +574,8 @@ enum elf_options
   OPTION_BUILD_ID,
   OPTION_PACKAGE_METADATA,
   OPTION_AUDIT,
-  OPTION_COMPRESS_DEBUG
+  OPTION_COMPRESS_DEBUG,
+  OPTION_DEBUG_NAMES
 };
 
 static void
@@ -605,6 +606,7 @@ fragment <<EOF
     {"build-id", optional_argument, NULL, OPTION_BUILD_ID},
     {"package-metadata", optional_argument, NULL, OPTION_PACKAGE_METADATA},
     {"compress-debug-sections", required_argument, NULL, OPTION_COMPRESS_DEBUG},
+    {"debug-names", no_argument, NULL, OPTION_DEBUG_NAMES},
 EOF
 if test x"$GENERATE_SHLIB_SCRIPT" = xyes; then
 fragment <<EOF
@@ -673,6 +675,10 @@ gld${EMULATION_NAME}_handle_option (int optc)
 	einfo (_("%F%P: invalid --compress-debug-sections option: \`%s'\n"),
 	       optarg);
       break;
+
+    case OPTION_DEBUG_NAMES:
+      ldelf_emit_debug_names = true;
+      break;
 EOF
 
 if test x"$GENERATE_SHLIB_SCRIPT" = xyes; then
@@ -55,6 +55,9 @@ const char *ldelf_emit_note_gnu_build_id;
 /* Content of .note.package section.  */
 const char *ldelf_emit_note_fdo_package_metadata;
 
+/* Whether to generate a .debug_names section.  */
+bool ldelf_emit_debug_names;
+
 /* These variables are required to pass information back and forth
    between after_open and check_needed and stat_needed and vercheck.  */
 
@@ -1256,7 +1259,8 @@ ldelf_after_open (int use_libpath, int native, int is_linux, int is_freebsd,
     }
 
   if (ldelf_emit_note_gnu_build_id != NULL
-      || ldelf_emit_note_fdo_package_metadata != NULL)
+      || ldelf_emit_note_fdo_package_metadata != NULL
+      || (ldelf_emit_debug_names && !bfd_link_relocatable (&link_info)))
     {
       /* Find an ELF input.  */
       for (abfd = link_info.input_bfds;
@@ -1283,6 +1287,12 @@ ldelf_after_open (int use_libpath, int native, int is_linux, int is_freebsd,
 	  free ((char *) ldelf_emit_note_fdo_package_metadata);
 	  ldelf_emit_note_fdo_package_metadata = NULL;
 	}
+
+      if (abfd != NULL
+	  && ldelf_emit_debug_names
+	  && !bfd_link_relocatable (&link_info)
+	  && !_bfd_elf_setup_debug_names (abfd, &link_info))
+	einfo (_("%F%P: failed to create .debug_names section: %E\n"));
     }
 
   get_elf_backend_data (link_info.output_bfd)->setup_gnu_properties (&link_info);
@@ -1757,6 +1767,9 @@ ldelf_before_allocation (char *audit, char *depaudit,
     {
       _bfd_elf_tls_setup (link_info.output_bfd, &link_info);
 
+      if (!_bfd_elf_size_debug_names (link_info.output_bfd, &link_info))
+	einfo (_("%F%P: failed to size .debug_names section: %E\n"));
+
       /* Make __ehdr_start hidden if it has been referenced, to
 	 prevent the symbol from being dynamic.  */
       if (!bfd_link_relocatable (&link_info))
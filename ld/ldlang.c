@@ -7926,6 +7926,28 @@ reset_resolved_wilds (void)
   lang_for_each_statement (reset_one_wild);
 }
 
+/* Report what merging SEC_MERGE sections did, and how long it took.  */
+
+static void
+print_merge_stats (const struct bfd_link_merge_stats *stats, long run_time)
+{
+  uint64_t input = stats->input_entities;
+  uint64_t unique = stats->unique_entities;
+
+  fflush (stdout);
+  fprintf (stderr, _("%s: time merging sections: %ld.%06ld\n"),
+	   program_name, run_time / 1000000, run_time % 1000000);
+  fprintf (stderr, _("%s: merged %" PRIu64 " sections: %" PRIu64
+		     " entities, %" PRIu64 " unique (%" PRIu64 "%%)\n"),
+	   program_name, (uint64_t) stats->sections, input, unique,
+	   input != 0 ? unique * 100 / input : (uint64_t) 100);
+  fprintf (stderr, _("%s: merged sections size: %" PRIu64 " bytes in, %"
+		     PRIu64 " bytes out\n"),
+	   program_name, (uint64_t) stats->input_size,
+	   (uint64_t) stats->output_size);
+  fflush (stderr);
+}
+
 void
 lang_process (void)
 {
@@ -8174,6 +8196,15 @@ lang_process (void)
   if (!bfd_link_relocatable (&link_info))
     {
       asection *found;
+      struct bfd_link_merge_stats merge_stats;
+      long merge_time = 0;
+
+      if (config.stats)
+	{
+	  memset (&merge_stats, 0, sizeof (merge_stats));
+	  link_info.merge_stats = &merge_stats;
+	  merge_time = get_run_time ();
+	}
 
       /* Merge SEC_MERGE sections.  This has to be done after GC of
 	 sections, so that GCed sections are not merged, but before
@@ -8181,6 +8212,13 @@ lang_process (void)
 	 is hard then.  */
       bfd_merge_sections (link_info.output_bfd, &link_info);
 
+      if (config.stats)
+	{
+	  link_info.merge_stats = NULL;
+	  merge_time = get_run_time () - merge_time;
+	  print_merge_stats (&merge_stats, merge_time);
+	}
+
       /* Look for a text section and set the readonly attribute in it.  */
       found = bfd_get_section_by_name (link_info.output_bfd, ".text");
 
@@ -143,6 +143,9 @@ enum option_values
   OPTION_WARN_ALTERNATE_EM,
   OPTION_REDUCE_MEMORY_OVERHEADS,
   OPTION_MAX_CACHE_SIZE,
+  OPTION_MAX_OPEN_FILES,
+  OPTION_MMAP_INPUTS,
+  OPTION_NO_MMAP_INPUTS,
 #if BFD_SUPPORTS_PLUGINS
   OPTION_PLUGIN,
   OPTION_PLUGIN_OPT,
@@ -172,6 +175,8 @@ enum option_values
   OPTION_NO_WARN_RWX_SEGMENTS,
   OPTION_ENABLE_LINKER_VERSION,
   OPTION_DISABLE_LINKER_VERSION,
+  OPTION_THREADS,
+  OPTION_NO_THREADS,
 };
 
 /* The initial parser states.  */
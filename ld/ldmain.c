@@ -618,10 +618,21 @@ main (int argc, char **argv)
   if (config.stats)
     {
       long run_time = get_run_time () - start_time;
+      struct bfd_cache_stats cache;
 
+      bfd_cache_get_stats (&cache);
       fflush (stdout);
       fprintf (stderr, _("%s: total time in link: %ld.%06ld\n"),
 	       program_name, run_time / 1000000, run_time % 1000000);
+      fprintf (stderr, _("%s: input file cache: %" PRIu64 " hits, %" PRIu64
+			 " misses, %" PRIu64 " reopens, %" PRIu64
+			 " evictions\n"),
+	       program_name, (uint64_t) cache.hits, (uint64_t) cache.misses,
+	       (uint64_t) cache.reopens, (uint64_t) cache.evictions);
+      fprintf (stderr, _("%s: input files open: %d (limit %d), mapped: %"
+			 PRIu64 " (%" PRIu64 " bytes)\n"),
+	       program_name, cache.open, cache.max_open,
+	       (uint64_t) cache.mapped, (uint64_t) cache.mapped_size);
       fflush (stderr);
     }
 
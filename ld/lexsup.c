@@ -447,6 +447,15 @@ static const struct ld_option ld_options[] =
     OPTION_MAX_CACHE_SIZE},
     '\0', NULL, N_("Set the maximum cache size to SIZE bytes"),
     TWO_DASHES },
+  { {"max-open-files", required_argument, NULL, OPTION_MAX_OPEN_FILES},
+    '\0', N_("COUNT"), N_("Keep at most COUNT input files open at once"),
+    TWO_DASHES },
+  { {"mmap-inputs", no_argument, NULL, OPTION_MMAP_INPUTS},
+    '\0', NULL, N_("Map input files into memory rather than reopen them"),
+    TWO_DASHES },
+  { {"no-mmap-inputs", no_argument, NULL, OPTION_NO_MMAP_INPUTS},
+    '\0', NULL, N_("Reopen input files when needed (default)"),
+    TWO_DASHES },
   { {"relax", no_argument, NULL, OPTION_RELAX},
     '\0', NULL, N_("Reduce code size by using target specific optimizations"), TWO_DASHES },
   { {"no-relax", no_argument, NULL, OPTION_NO_RELAX},
@@ -493,6 +502,12 @@ static const struct ld_option ld_options[] =
     '\0', NULL, N_("Display target specific options"), TWO_DASHES },
   { {"task-link", required_argument, NULL, OPTION_TASK_LINK},
     '\0', N_("SYMBOL"), N_("Do task level linking"), TWO_DASHES },
+  { {"threads", optional_argument, NULL, OPTION_THREADS},
+    '\0', N_("[=COUNT]"), N_("Use up to COUNT threads for the final link"),
+    TWO_DASHES },
+  { {"no-threads", no_argument, NULL, OPTION_NO_THREADS},
+    '\0', NULL, N_("Do not use threads for the final link (default)"),
+    TWO_DASHES },
   { {"traditional-format", no_argument, NULL, OPTION_TRADITIONAL_FORMAT},
     '\0', NULL, N_("Use same format as native linker"), TWO_DASHES },
   { {"section-start", required_argument, NULL, OPTION_SECTION_START},
@@ -1638,6 +1653,25 @@ parse_args (unsigned argc, char **argv)
 	  else
 	    config.split_by_reloc = 32768;
 	  break;
+	case OPTION_THREADS:
+	  {
+	    unsigned long count = 0;
+
+	    if (optarg != NULL)
+	      {
+		char *end;
+
+		count = strtoul (optarg, &end, 0);
+		if (*end != '\0' || count == 0
+		    || (unsigned int) count != count)
+		  einfo (_("%F%P: invalid thread count: %s\n"), optarg);
+	      }
+	    bfd_set_thread_count (count);
+	  }
+	  break;
+	case OPTION_NO_THREADS:
+	  bfd_set_thread_count (1);
+	  break;
 	case OPTION_SPLIT_BY_FILE:
 	  if (optarg != NULL)
 	    config.split_by_file = bfd_scan_vma (optarg, NULL, 0);
@@ -1693,6 +1727,25 @@ parse_args (unsigned argc, char **argv)
 	  }
 	  break;
 
+	case OPTION_MAX_OPEN_FILES:
+	  {
+	    char *end;
+	    long count = strtol (optarg, &end, 0);
+
+	    if (*end != '\0' || count <= 0 || (int) count != count)
+	      einfo (_("%F%P: invalid open file count: %s\n"), optarg);
+	    bfd_cache_set_max_open (count);
+	  }
+	  break;
+
+	case OPTION_MMAP_INPUTS:
+	  bfd_cache_set_mmap (true);
+	  break;
+
+	case OPTION_NO_MMAP_INPUTS:
+	  bfd_cache_set_mmap (false);
+	  break;
+
 	case OPTION_HASH_SIZE:
 	  {
 	    bfd_size_type new_size;
@@ -2172,6 +2225,8 @@ elf_static_list_options (FILE *file)
   fprintf (file, _("\
   --package-metadata[=JSON]   Generate package metadata note\n"));
   fprintf (file, _("\
+  --debug-names               Generate a DWARF 5 .debug_names index\n"));
+  fprintf (file, _("\
   --compress-debug-sections=[none|zlib|zlib-gnu|zlib-gabi|zstd]\n\
 			      Compress DWARF debug sections\n"));
   fprintf (file, _("\
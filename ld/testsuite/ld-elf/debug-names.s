@@ -0,0 +1,10 @@
+	.text
+	.globl	foo
+	.type	foo, %function
+foo:
+	.nop
+	.size	foo, .-foo
+	.type	bar, %function
+bar:
+	.nop
+	.size	bar, .-bar
@@ -0,0 +1,41 @@
+	.altmacro
+	.macro	def name, n
+	.globl	\name\n
+\name\n:
+	.byte	0
+	.endm
+	.macro	defweak name, n
+	.weak	\name\n
+\name\n:
+	.byte	0
+	.endm
+
+	.text
+	.set	i, 0
+	.rept	1600
+	def	hs_a, %i
+	.set	i, i + 1
+	.endr
+
+	# Weak duplicates of strong definitions in hash-syms-b.s.
+	.set	i, 0
+	.rept	800
+	defweak	hs_b, %i
+	.set	i, i + 1
+	.endr
+
+	.globl	hs_strong
+hs_strong:
+	.byte	0
+	.weak	hs_weak
+hs_weak:
+	.byte	0
+
+	.globl	hs_ver_1
+hs_ver_1:
+	.byte	0
+	.symver	hs_ver_1, hs_ver@V1
+	.globl	hs_ver_2
+hs_ver_2:
+	.byte	0
+	.symver	hs_ver_2, hs_ver@@V2
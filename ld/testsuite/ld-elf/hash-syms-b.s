@@ -0,0 +1,32 @@
+	.altmacro
+	.macro	def name, n
+	.globl	\name\n
+\name\n:
+	.byte	0
+	.endm
+	.macro	defweak name, n
+	.weak	\name\n
+\name\n:
+	.byte	0
+	.endm
+
+	.data
+	.set	i, 0
+	.rept	1600
+	def	hs_b, %i
+	.set	i, i + 1
+	.endr
+
+	# Weak duplicates of strong definitions in hash-syms-a.s.
+	.set	i, 0
+	.rept	800
+	defweak	hs_a, %i
+	.set	i, i + 1
+	.endr
+
+	.weak	hs_strong
+hs_strong:
+	.byte	0
+	.globl	hs_weak
+hs_weak:
+	.byte	0
@@ -0,0 +1,18 @@
+	.section .rodata.str1.1,"aMS",%progbits,1
+.LC0:
+	.asciz	"abc"
+.LC1:
+	.asciz	"defg"
+.LC2:
+	.asciz	"xyzabc"
+	# Enough copies for the strings to be merged on several threads.
+	.rept	100000
+	.asciz	"abc"
+	.asciz	"defg"
+	.asciz	"xyzabc"
+	.endr
+
+	.data
+	.long	.LC0
+	.long	.LC1
+	.long	.LC2
@@ -0,0 +1,2 @@
+	.data
+	.byte 1, 2, 3, 4
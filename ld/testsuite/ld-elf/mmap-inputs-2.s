@@ -0,0 +1,2 @@
+	.data
+	.byte 5, 6, 7, 8
@@ -0,0 +1,2 @@
+	.data
+	.byte 9, 10, 11, 12